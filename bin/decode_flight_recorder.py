@@ -0,0 +1,121 @@
+#!/usr/bin/env python
+"""
+Print the GPI events kept by the flight recorder, oldest first.
+
+The file is written when the simulation ends or crashes, see
+COCOTB_FLIGHT_RECORDER.
+"""
+
+import sys
+import struct
+import argparse
+
+
+MAGIC = b"COCOTBFR"
+VERSION = 1
+
+EVENT_TYPES = {
+    1: "CB_FIRED",
+    2: "CB_ARMED",
+    3: "CB_REMOVED",
+    4: "LOOKUP",
+    5: "WRITE_LONG",
+    6: "WRITE_STR",
+    7: "WRITE_REAL",
+    8: "SIM_END",
+    9: "EMBED_END",
+    10: "SIM_TIME",
+}
+
+TIME_UNKNOWN = (1 << 64) - 1
+
+CB_STATES = ["FREE", "PRIMED", "CALL", "REPRIME", "DELETE"]
+CB_KINDS = ["ValueChange", "Timer", "ReadOnly", "NextTimeStep", "ReadWrite"]
+LOOKUPS = ["root", "name", "index"]
+
+
+def text(value):
+    """The characters packed into value by gpi_fr_prefix()"""
+    raw = struct.pack("<Q", value).split(b"\0")[0]
+    return raw.decode("ascii", "replace")
+
+
+def lookup(table, index):
+    if index < len(table):
+        return table[index]
+    return str(index)
+
+
+def describe(kind, arg, value):
+    """Event specific part of the output line"""
+    if kind == "CB_FIRED":
+        if value == TIME_UNKNOWN:
+            return "state %s" % lookup(CB_STATES, arg)
+        return "state %s, sim time %d" % (lookup(CB_STATES, arg), value)
+    if kind == "SIM_TIME":
+        return "%d" % value
+    if kind == "CB_ARMED":
+        name = lookup(CB_KINDS, arg)
+        if name == "Timer":
+            return "%s %d" % (name, value)
+        if name == "ValueChange":
+            return "%s edge %d" % (name, value)
+        return name
+    if kind == "LOOKUP":
+        how = lookup(LOOKUPS, arg)
+        if how == "index":
+            return "index %d" % struct.unpack("<q", struct.pack("<Q", value))[0]
+        return "%s '%s'" % (how, text(value))
+    if kind == "WRITE_LONG":
+        return "%d" % struct.unpack("<q", struct.pack("<Q", value))[0]
+    if kind == "WRITE_STR":
+        return "'%s'" % text(value)
+    if kind == "WRITE_REAL":
+        return "%g" % struct.unpack("<d", struct.pack("<Q", value))[0]
+    return ""
+
+
+def read_events(f):
+    """Return the events in the order they were recorded as tuples of
+    (seq, type, arg, handle, value)"""
+    header = f.read(24)
+    magic, version, num_events, event_size, next_seq = struct.unpack("<8sIIII", header)
+    if magic != MAGIC:
+        raise ValueError("Not a cocotb flight recorder file")
+    if version != VERSION:
+        raise ValueError("Unsupported flight recorder version %d" % version)
+
+    events = []
+    for _ in range(num_events):
+        raw = f.read(event_size)
+        if len(raw) < 24:
+            break
+        event = struct.unpack("<IHHQQ", raw[:24])
+        if event[0]:
+            events.append(event)
+
+    events.sort()
+    return events
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("file", nargs="?", default="cocotb_flight.bin",
+                        help="Flight recorder file to decode")
+    parser.add_argument("--last", type=int, default=0,
+                        help="Only print the last N events")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as f:
+        events = read_events(f)
+
+    if args.last:
+        events = events[-args.last:]
+
+    for seq, etype, arg, hdl, value in events:
+        kind = EVENT_TYPES.get(etype, "UNKNOWN(%d)" % etype)
+        print("%10d  %-10s  0x%016x  %s" % (seq, kind, hdl, describe(kind, arg, value)))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
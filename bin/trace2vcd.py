@@ -0,0 +1,150 @@
+#!/usr/bin/env python
+"""
+Convert a binary trace written by simulator.start_recording() into a VCD file.
+"""
+
+import sys
+import struct
+import argparse
+
+
+MAGIC = b"COCOTBTR"
+VERSION = 1
+
+
+def read_varint(buf, pos):
+    """Decode an LEB128 unsigned integer, returning (value, new position)"""
+    value = 0
+    shift = 0
+    while True:
+        byte = buf[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def read_trace(f):
+    """Return (precision, signals, events) where signals is a list of
+    (name, width) and events yields (time, index, binstr)"""
+    header = f.read(20)
+    magic, version, num_signals, precision = struct.unpack("<8sIIi", header)
+    if magic != MAGIC:
+        raise ValueError("Not a cocotb trace file")
+    if version != VERSION:
+        raise ValueError("Unsupported trace version %d" % version)
+
+    signals = []
+    for _ in range(num_signals):
+        width, name_len = struct.unpack("<IH", f.read(6))
+        signals.append((f.read(name_len).decode(), width))
+
+    def events():
+        while True:
+            hdr = f.read(16)
+            if len(hdr) < 16:
+                return
+            payload, num_events, time = struct.unpack("<IIQ", hdr)
+            buf = bytearray(f.read(payload))
+            pos = 0
+            for _ in range(num_events):
+                delta, pos = read_varint(buf, pos)
+                key, pos = read_varint(buf, pos)
+                time += delta
+                index = key >> 1
+                width = signals[index][1]
+                if key & 1:
+                    value = buf[pos:pos + width].decode()
+                    pos += width
+                else:
+                    nbytes = (width + 7) // 8
+                    raw = buf[pos:pos + nbytes]
+                    pos += nbytes
+                    value = "".join("1" if raw[bit // 8] >> (bit % 8) & 1 else "0"
+                                    for bit in reversed(range(width)))
+                yield time, index, value
+
+    return precision, signals, events()
+
+
+def vcd_id(index):
+    """Short printable identifier for a VCD variable"""
+    chars = []
+    index += 1
+    while index:
+        index, rem = divmod(index - 1, 94)
+        chars.append(chr(33 + rem))
+    return "".join(chars)
+
+
+def timescale(precision):
+    units = {0: "s", -3: "ms", -6: "us", -9: "ns", -12: "ps", -15: "fs"}
+    for exp in sorted(units, reverse=True):
+        if precision >= exp:
+            return "%d %s" % (10 ** (precision - exp), units[exp])
+    return "1 fs"
+
+
+def write_vcd(trace, out):
+    precision, signals, events = trace
+
+    out.write("$timescale %s $end\n" % timescale(precision))
+
+    # Nest the variables in scopes following their hierarchical names
+    scope = []
+    for index, (name, width) in sorted(enumerate(signals), key=lambda s: s[1][0].split(".")):
+        path = name.split(".")
+        common = 0
+        while common < min(len(scope), len(path) - 1) and scope[common] == path[common]:
+            common += 1
+        for _ in range(len(scope) - common):
+            out.write("$upscope $end\n")
+        scope = scope[:common]
+        for part in path[common:-1]:
+            out.write("$scope module %s $end\n" % part)
+            scope.append(part)
+        out.write("$var wire %d %s %s $end\n" % (width, vcd_id(index), path[-1]))
+    for _ in scope:
+        out.write("$upscope $end\n")
+    out.write("$enddefinitions $end\n")
+
+    last_time = None
+    for time, index, value in events:
+        if time != last_time:
+            out.write("#%d\n" % time)
+            last_time = time
+        value = value.lower()
+        if signals[index][1] == 1:
+            out.write("%s%s\n" % (value, vcd_id(index)))
+        else:
+            out.write("b%s %s\n" % (value, vcd_id(index)))
+
+
+def get_parser():
+    """Return the cmdline parser"""
+    parser = argparse.ArgumentParser(description=__doc__,
+                        formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+    parser.add_argument("trace", type=str,
+                        help="Trace file written by the recorder")
+    parser.add_argument("--output_file", dest="output_file", type=str, required=False,
+                        default=None,
+                        help="Name of VCD file, defaults to stdout")
+    return parser
+
+
+def main():
+    args = get_parser().parse_args()
+
+    with open(args.trace, "rb") as f:
+        trace = read_trace(f)
+        if args.output_file is None:
+            write_vcd(trace, sys.stdout)
+        else:
+            with open(args.output_file, "w") as out:
+                write_vcd(trace, out)
+
+
+if __name__ == "__main__":
+    main()
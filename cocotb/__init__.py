@@ -37,6 +37,16 @@ import threading
 import random
 import time
 
+# A testbench run out of process talks to the simulator over a channel, which
+# stands in for the simulator module, see cocotb.remote
+if "COCOTB_SIM" in os.environ and os.getenv("COCOTB_REMOTE"):
+    import cocotb.remote
+    cocotb.remote.connect(os.environ["COCOTB_REMOTE"])
+
+# Time the rest of start-up when asked to, see cocotb.startup
+import cocotb.startup
+cocotb.startup.start()
+
 import cocotb.handle
 from cocotb.scheduler import Scheduler
 from cocotb.log import SimLogFormatter, SimBaseLog, SimLog
@@ -65,8 +75,8 @@ if "COCOTB_SIM" in os.environ:
         _default_log = logging.INFO
     log.setLevel(_default_log)
     loggpi = SimLog('cocotb.gpi')
-    # Notify GPI of log level
-    simulator.log_level(_default_log)
+    # Notify GPI of log level, later changes are pushed by SimBaseLog
+    simulator.log_level(loggpi.logger.getEffectiveLevel())
 
     # If stdout/stderr are not TTYs, Python may not have opened them with line
     # buffering. In that case, try to reopen them with line buffering
@@ -164,7 +174,9 @@ def _initialise_testbench(root_name):
     global regression_manager
 
     regression_manager = RegressionManager(root_name, modules, tests=test_str, seed=seed, hooks=hooks)
-    regression_manager.initialise()
+    with cocotb.startup.phase("RegressionManager.initialise"):
+        regression_manager.initialise()
+    cocotb.startup.finish(log, root_name)
     regression_manager.execute()
 
     _rlock.release()
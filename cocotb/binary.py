@@ -190,6 +190,13 @@ class BinaryValue(object):
         return binstr
 
     def _convert_from_unsigned(self, x):
+        # Only strings with characters other than 0 and 1 need resolving,
+        # a leading - would otherwise be parsed as a sign
+        if '-' not in x:
+            try:
+                return int(x, 2)
+            except ValueError:
+                pass
         return int(resolve(x), 2)
 
     def _convert_from_signed_mag(self, x):
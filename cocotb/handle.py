@@ -53,6 +53,44 @@ from cocotb.utils import get_python_integer_types
 _deprecation_warned = {}
 
 
+class _ReadCache(object):
+    """Values read from the simulator since it last called into Python.
+
+    Enabled by setting ``COCOTB_READ_CACHE``. Signal values can only change
+    while the simulator has control, so the scheduler empties the cache every
+    time it is woken up and repeated reads of a handle within one step are
+    served from here. Immediate writes drop the entry for their handle.
+    """
+
+    def __init__(self):
+        self.values = {}
+        self.hits = 0
+        self.misses = 0
+
+    def read(self, handle):
+        try:
+            value = self.values[handle]
+        except KeyError:
+            self.misses += 1
+            value = self.values[handle] = handle.get_value()
+            return value
+        self.hits += 1
+        return value
+
+    def invalidate(self):
+        if self.values:
+            self.values.clear()
+
+    def discard(self, handle):
+        self.values.pop(handle, None)
+
+
+if "COCOTB_READ_CACHE" in os.environ:
+    _read_cache = _ReadCache()
+else:
+    _read_cache = None
+
+
 class SimHandleBase(object):
     """Base class for all simulation objects.
 
@@ -72,7 +110,7 @@ class SimHandleBase(object):
     def __init__(self, handle, path):
         """
         Args:
-            handle (integer)    : the GPI handle to the simulator object
+            handle (simulator.gpi_sim_hdl) : the GPI handle to the simulator object
             path (string)       : path to this handle, None if root
         """
         self._handle = handle
@@ -80,14 +118,14 @@ class SimHandleBase(object):
         self._sub_handles = {}  # Dictionary of children
         self._invalid_sub_handles = {} # Dictionary of invalid queries
 
-        self._name = simulator.get_name_string(self._handle)
-        self._type = simulator.get_type_string(self._handle)
+        self._name = handle.name
+        self._type = handle.type_string
         self._fullname = self._name + "(%s)" % self._type
         self._path = self._name if path is None else path
         self._log = SimLog("cocotb.%s" % self._name)
         self._log.debug("Created")
-        self._def_name = simulator.get_definition_name(self._handle)
-        self._def_file = simulator.get_definition_file(self._handle)
+        self._def_name = handle.definition_name
+        self._def_file = handle.definition_file
 
     def get_definition_name(self):
         return object.__getattribute__(self, "_def_name")
@@ -96,7 +134,7 @@ class SimHandleBase(object):
         return object.__getattribute__(self, "_def_file")
 
     def __hash__(self):
-        return self._handle
+        return hash(self._handle)
 
     def __len__(self):
         """Returns the 'length' of the underlying object.
@@ -104,7 +142,7 @@ class SimHandleBase(object):
         For vectors this is the number of bits.
         """
         if self._len is None:
-            self._len = simulator.get_num_elems(self._handle)
+            self._len = self._handle.num_elems
         return self._len
 
     def __eq__(self, other):
@@ -190,7 +228,7 @@ class RegionObject(SimHandleBase):
             except StopIteration:
                 # Iterator is cleaned up internally in GPI
                 break
-            name = simulator.get_name_string(thing)
+            name = thing.name
             try:
                 hdl = SimHandle(thing, self._child_path(name))
             except TestError as e:
@@ -443,14 +481,10 @@ class ConstantObject(NonHierarchyObject):
     """
     def __init__(self, handle, path, handle_type):
         NonHierarchyObject.__init__(self, handle, path)
-        if handle_type in [simulator.INTEGER, simulator.ENUM]:
-            self._value = simulator.get_signal_val_long(self._handle)
-        elif handle_type == simulator.REAL:
-            self._value = simulator.get_signal_val_real(self._handle)
-        elif handle_type == simulator.STRING:
-            self._value = simulator.get_signal_val_str(self._handle)
+        if handle_type in [simulator.INTEGER, simulator.ENUM, simulator.REAL, simulator.STRING]:
+            self._value = self._handle.get_value()
         else:
-            val = simulator.get_signal_val_binstr(self._handle)
+            val = self._handle.get_value()
             self._value = BinaryValue(n_bits=len(val))
             try:
                 self._value.binstr = val
@@ -472,10 +506,10 @@ class ConstantObject(NonHierarchyObject):
 class NonHierarchyIndexableObject(NonHierarchyObject):
     def __init__(self, handle, path):
         """Args:
-            handle (int): FLI/VPI/VHPI handle to the simulator object.
+            handle (simulator.gpi_sim_hdl): FLI/VPI/VHPI handle to the simulator object.
         """
         NonHierarchyObject.__init__(self, handle, path)
-        self._range = simulator.get_range(self._handle)
+        self._range = self._handle.range
 
     def __setitem__(self, index, value):
         """Provide transparent assignment to indexed array handles."""
@@ -519,6 +553,38 @@ class NonHierarchyIndexableObject(NonHierarchyObject):
             pass
 
 
+    def read_into(self, buffer):
+        """Read the value of every element into ``buffer`` in one call.
+
+        Args:
+            buffer: A writable object supporting the buffer protocol, such as
+                a :class:`bytearray`, :class:`array.array` or
+                :class:`numpy.ndarray`, with one integer item of 1, 2, 4 or 8
+                bytes per element. Item 0 is the element at the left index.
+                Items are signed if the buffer format is signed.
+
+        Raises:
+            ValueError: If the buffer does not match the array or an element
+                can not be resolved to an integer.
+        """
+        simulator.get_array_val(self._handle, buffer)
+
+    def write_from(self, buffer):
+        """Write every element immediately from the integers in ``buffer``.
+
+        Args:
+            buffer: An object supporting the buffer protocol laid out as for
+                :meth:`read_into`.
+
+        Raises:
+            OverflowError: If any item does not fit in its element, in which
+                case nothing is written.
+        """
+        if _read_cache is not None:
+            # Element handles are not known here, start afresh
+            _read_cache.invalidate()
+        simulator.set_array_val(self._handle, buffer)
+
     def _range_iter(self, left, right):
         try:
             if left > right:
@@ -537,7 +603,7 @@ class NonConstantObject(NonHierarchyIndexableObject):
     
     def __init__(self, handle, path):
         """Args:
-            handle (int): FLI/VPI/VHPI handle to the simulator object.
+            handle (simulator.gpi_sim_hdl): FLI/VPI/VHPI handle to the simulator object.
         """
         NonHierarchyIndexableObject.__init__(self, handle, path)
 
@@ -582,9 +648,19 @@ class ModifiableObject(NonConstantObject):
             TypeError: If target is not wide enough or has an unsupported type 
                  for value assignment.
         """
-        if isinstance(value, get_python_integer_types()) and value < 0x7fffffff and len(self) <= 32:
-            simulator.set_signal_val_long(self._handle, value)
-            return
+        if _read_cache is not None:
+            _read_cache.discard(self._handle)
+
+        if isinstance(value, get_python_integer_types()):
+            if value < 0x7fffffff and len(self) <= 32:
+                self._handle.set_value(value)
+                return
+            try:
+                simulator.set_signal_val_int(self._handle, value)
+                return
+            except OverflowError:
+                # Negative or too wide, let BinaryValue report or truncate
+                pass
 
         if isinstance(value, ctypes.Structure):
             value = BinaryValue(value=cocotb.utils.pack(value), n_bits=len(self))
@@ -609,10 +685,16 @@ class ModifiableObject(NonConstantObject):
             self._log.critical("Unsupported type for value assignment: %s (%s)" % (type(value), repr(value)))
             raise TypeError("Unable to set simulator value with type %s" % (type(value)))
 
-        simulator.set_signal_val_str(self._handle, value.binstr)
+        self._handle.set_value(value.binstr)
+
+    def _readvalue(self):
+        """Read the raw value, through the read cache when it is enabled."""
+        if _read_cache is not None:
+            return _read_cache.read(self._handle)
+        return self._handle.get_value()
 
     def _getvalue(self):
-        binstr = simulator.get_signal_val_binstr(self._handle)
+        binstr = self._readvalue()
         result = BinaryValue(binstr, len(binstr))
         return result
 
@@ -626,7 +708,13 @@ class ModifiableObject(NonConstantObject):
         cocotb.scheduler.save_write(self, value)
 
     def __int__(self):
-        return int(self.value)
+        if _read_cache is not None:
+            return int(self.value)
+        # X, Z and friends are resolved by the simulator module itself
+        value = simulator.get_signal_val_int(self._handle)
+        if value is None:
+            return int(self.value)
+        return value
 
     def __str__(self):
         return str(self.value)
@@ -647,14 +735,17 @@ class RealObject(ModifiableObject):
             TypeError: If target has an unsupported type for 
                 real value assignment.
         """
+        if _read_cache is not None:
+            _read_cache.discard(self._handle)
+
         if not isinstance(value, float):
             self._log.critical("Unsupported type for real value assignment: %s (%s)" % (type(value), repr(value)))
             raise TypeError("Unable to set simulator value with type %s" % (type(value)))
 
-        simulator.set_signal_val_real(self._handle, value)
+        self._handle.set_value(value)
 
     def _getvalue(self):
-        return simulator.get_signal_val_real(self._handle)
+        return self._readvalue()
 
     def __float__(self):
         return float(self.value)
@@ -675,16 +766,19 @@ class EnumObject(ModifiableObject):
             TypeError: If target has an unsupported type for 
                  integer value assignment.
         """
+        if _read_cache is not None:
+            _read_cache.discard(self._handle)
+
         if isinstance(value, BinaryValue):
             value = int(value)
         elif not isinstance(value, get_python_integer_types()):
             self._log.critical("Unsupported type for integer value assignment: %s (%s)" % (type(value), repr(value)))
             raise TypeError("Unable to set simulator value with type %s" % (type(value)))
 
-        simulator.set_signal_val_long(self._handle, value)
+        self._handle.set_value(value)
 
     def _getvalue(self):
-        return simulator.get_signal_val_long(self._handle)
+        return self._readvalue()
 
 
 class IntegerObject(ModifiableObject):
@@ -703,16 +797,19 @@ class IntegerObject(ModifiableObject):
             TypeError: If target has an unsupported type for 
                  integer value assignment.
         """
+        if _read_cache is not None:
+            _read_cache.discard(self._handle)
+
         if isinstance(value, BinaryValue):
             value = int(value)
         elif not isinstance(value, get_python_integer_types()):
             self._log.critical("Unsupported type for integer value assignment: %s (%s)" % (type(value), repr(value)))
             raise TypeError("Unable to set simulator value with type %s" % (type(value)))
 
-        simulator.set_signal_val_long(self._handle, value)
+        self._handle.set_value(value)
 
     def _getvalue(self):
-        return simulator.get_signal_val_long(self._handle)
+        return self._readvalue()
 
 class StringObject(ModifiableObject):
     """Specific object handle for String variables."""
@@ -730,14 +827,17 @@ class StringObject(ModifiableObject):
             TypeError: If target has an unsupported type for 
                  string value assignment.
         """
+        if _read_cache is not None:
+            _read_cache.discard(self._handle)
+
         if not isinstance(value, str):
             self._log.critical("Unsupported type for string value assignment: %s (%s)" % (type(value), repr(value)))
             raise TypeError("Unable to set simulator value with type %s" % (type(value)))
 
-        simulator.set_signal_val_str(self._handle, value)
+        self._handle.set_value(value)
 
     def _getvalue(self):
-        return simulator.get_signal_val_str(self._handle)
+        return self._readvalue()
 
 _handle2obj = {}
 
@@ -763,10 +863,10 @@ def SimHandle(handle, path=None):
     except KeyError:
         pass
 
-    t = simulator.get_type(handle)
+    t = handle.type
 
     # Special case for constants
-    if simulator.get_const(handle) and not t in [simulator.MODULE,
+    if handle.const and not t in [simulator.MODULE,
                                                  simulator.STRUCTURE,
                                                  simulator.NETARRAY,
                                                  simulator.GENARRAY]:
@@ -39,6 +39,11 @@ from cocotb.utils import get_sim_time
 import cocotb.ANSI as ANSI
 from pdb import set_trace
 
+if "COCOTB_SIM" in os.environ:
+    import simulator
+else:
+    simulator = None
+
 if "COCOTB_REDUCED_LOG_FMT" in os.environ:
     _suppress = True
 else:
@@ -75,6 +80,22 @@ class SimBaseLog(logging.getLoggerClass()):
         self.addHandler(hdlr)
         self.setLevel(logging.NOTSET)
 
+    def setLevel(self, level):
+        super(SimBaseLog, self).setLevel(level)
+        _update_gpi_level()
+
+
+def _update_gpi_level():
+    """ The GPI caches the effective level of cocotb.gpi so that it can
+        drop messages without calling into Python. Any level change may
+        alter it so push the current value down.
+    """
+    if simulator is None:
+        return
+    gpi_logger = logging.Logger.manager.loggerDict.get('cocotb.gpi')
+    if isinstance(gpi_logger, logging.Logger):
+        simulator.log_level(gpi_logger.getEffectiveLevel())
+
 """ Need to play with this to get the path of the called back,
     construct our own makeRecord for this """
 
@@ -34,6 +34,9 @@ from itertools import product
 import sys
 import os
 import traceback
+import json
+import shutil
+import tempfile
 
 if "COCOTB_SIM" in os.environ:
     import simulator
@@ -88,10 +91,14 @@ class RegressionManager(object):
         self._modules = modules
         self._functions = tests
         self._running_test = None
+        self._callback_times_start = {}
         self._cov = None
         self.log = SimLog("cocotb.regression")
         self._seed = seed
         self._hooks = hooks
+        self._fork_jobs = _fork_jobs()
+        self._fork_result = None
+        self._forked = False
 
     def initialise(self):
 
@@ -117,9 +124,10 @@ class RegressionManager(object):
             self._cov = coverage.coverage(branch=True, omit=["*cocotb*"])
             self._cov.start()
 
-        handle = simulator.get_root_handle(self._root_name)
+        with cocotb.startup.phase("get_root_handle"):
+            handle = simulator.get_root_handle(self._root_name)
 
-        self._dut = cocotb.handle.SimHandle(handle) if handle else None
+            self._dut = cocotb.handle.SimHandle(handle) if handle else None
 
         if self._dut is None:
             raise AttributeError("Can not find Root Handle (%s)" %
@@ -201,6 +209,12 @@ class RegressionManager(object):
 
     def tear_down(self):
         """It's the end of the world as we know it"""
+        if self._fork_result is not None:
+            # Only the process that forked the tests reports on them
+            self._write_fork_result()
+            simulator.stop_simulator()
+            return
+
         if self.failures:
             self.log.error("Failed %d out of %d tests (%d skipped)" %
                            (self.failures, self.count - 1, self.skipped))
@@ -214,6 +228,7 @@ class RegressionManager(object):
             self._cov.html_report()
         if len(self.test_results) > 0:
             self._log_test_summary()
+            self._log_callback_summary()
         self._log_sim_summary()
         self.log.info("Shutting down...")
         self.xunit.write()
@@ -242,6 +257,7 @@ class RegressionManager(object):
         real_time   = time.time() - self._running_test.start_time
         sim_time_ns = get_sim_time('ns') - self._running_test.start_sim_time
         ratio_time  = sim_time_ns / real_time
+        callback_times = self._callback_times_since(self._callback_times_start)
         self.xunit.add_testcase(name=self._running_test.funcname,
                                 classname=self._running_test.module,
                                 time=repr(real_time),
@@ -290,7 +306,7 @@ class RegressionManager(object):
                 self.log.error("Test error has lead to simulator shutting us "
                                "down")
                 self._add_failure(result)
-                self._store_test_result(self._running_test.module, self._running_test.funcname, False, sim_time_ns, real_time, ratio_time)
+                self._store_test_result(self._running_test.module, self._running_test.funcname, False, sim_time_ns, real_time, ratio_time, callback_times)
                 self.tear_down()
                 return
 
@@ -299,11 +315,15 @@ class RegressionManager(object):
             self._add_failure(result)
             result_pass = False
 
-        self._store_test_result(self._running_test.module, self._running_test.funcname, result_pass, sim_time_ns, real_time, ratio_time)
+        self._store_test_result(self._running_test.module, self._running_test.funcname, result_pass, sim_time_ns, real_time, ratio_time, callback_times)
 
         self.execute()
 
     def execute(self):
+        if self._fork_jobs and self._queue:
+            self._fork_tests()
+            return
+
         self._running_test = cocotb.regression_manager.next_test()
         if self._running_test:
             start = ''
@@ -317,6 +337,7 @@ class RegressionManager(object):
                            self.count, self.ntests,
                            end,
                            self._running_test.funcname))
+            self._callback_times_start = self._callback_times()
             if self.count is 1:
                 test = cocotb.scheduler.add(self._running_test)
             else:
@@ -325,6 +346,122 @@ class RegressionManager(object):
         else:
             self.tear_down()
 
+    def _fork_tests(self):
+        """Run each test in a process forked from this one.
+
+        This is called at time 0 with the design elaborated, so every child
+        starts from the same simulator and testbench state, shared
+        copy-on-write, runs a single test and ends its own copy of the
+        simulation. Up to ``COCOTB_FORK_TESTS`` children run at once. Their
+        results and output are collected here once they have all exited.
+        """
+        tests = self._queue
+        self._queue = []
+        self._forked = True
+        results_dir = tempfile.mkdtemp(prefix="cocotb_tests_")
+
+        self.log.info("Running %d tests in up to %d forked processes" %
+                      (len(tests), self._fork_jobs))
+
+        running = {}
+        statuses = {}
+        for index, test in enumerate(tests):
+            while len(running) >= self._fork_jobs:
+                self._wait_for_child(running, statuses)
+
+            sys.stdout.flush()
+            sys.stderr.flush()
+            pid = os.fork()
+            if pid == 0:
+                self._run_in_child(test, os.path.join(results_dir, str(index)))
+                return
+            running[pid] = index
+
+        while running:
+            self._wait_for_child(running, statuses)
+
+        for index, test in enumerate(tests):
+            self._collect_child(test, os.path.join(results_dir, str(index)),
+                                statuses[index])
+        shutil.rmtree(results_dir, ignore_errors=True)
+
+        self.tear_down()
+
+    def _wait_for_child(self, running, statuses):
+        pid, status = os.waitpid(-1, 0)
+        if pid in running:
+            statuses[running.pop(pid)] = status
+
+    def _run_in_child(self, test, result_path):
+        """Set up a forked child to run a single test, with its output
+        captured for the parent to pick up."""
+        self._fork_jobs = 0
+        self._fork_result = result_path
+        self.start_time = time.time()
+        self.test_results = []
+        self.failures = 0
+        self.xunit = XUnitReporter()
+        self.xunit.add_testsuite(name="forked")
+
+        fd = os.open(result_path + ".log", os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o644)
+        os.dup2(fd, 1)
+        os.dup2(fd, 2)
+        os.close(fd)
+
+        self._queue = [test]
+        self.execute()
+
+    def _write_fork_result(self):
+        result = {
+            'results'   : self.test_results,
+            'failures'  : self.failures,
+            'testcases' : self.xunit.testcases_xml()}
+        sys.stdout.flush()
+        sys.stderr.flush()
+        with open(self._fork_result + ".tmp", "w") as f:
+            json.dump(result, f)
+        os.rename(self._fork_result + ".tmp", self._fork_result + ".json")
+
+    def _collect_child(self, test, result_path, status):
+        """Merge the result and output of a test run in a forked child."""
+        try:
+            with open(result_path + ".json") as f:
+                result = json.load(f)
+        except (IOError, OSError, ValueError):
+            result = None
+
+        if result is None:
+            if os.WIFSIGNALED(status):
+                reason = "was killed by signal %d" % os.WTERMSIG(status)
+            else:
+                reason = "exited with status %d" % os.WEXITSTATUS(status)
+            self.log.error("Test %s ended without a result, its process %s" %
+                           (test.funcname, reason))
+            self.xunit.add_testcase(name=test.funcname,
+                                    classname=test.module,
+                                    time="0.0",
+                                    sim_time_ns="0.0",
+                                    ratio_time="0.0")
+            self.xunit.add_failure(message="Test process %s" % reason)
+            self.failures += 1
+            self._store_test_result(test.module, test.funcname, False, 0.0, 0.0, 0.0)
+        else:
+            for testcase in result['testcases']:
+                self.xunit.add_testcase_xml(testcase)
+            self.failures += result['failures']
+            for test_result in result['results']:
+                self.test_results.append(test_result)
+                self.log.info("Test %s: %s" % (test_result['test'],
+                              "PASS" if test_result['pass'] else "FAIL"))
+
+        try:
+            with open(result_path + ".log") as f:
+                self.xunit.add_output(f.read())
+        except (IOError, OSError):
+            pass
+
+        self.count += 1
+
     def _log_test_summary(self):
         TEST_FIELD   = 'TEST'
         RESULT_FIELD = 'PASS/FAIL'
@@ -375,6 +512,9 @@ class RegressionManager(object):
     def _log_sim_summary(self):
         real_time   = time.time() - self.start_time
         sim_time_ns = get_sim_time('ns')
+        if self._forked:
+            # The tests ran in their own copies of the simulation
+            sim_time_ns = sum(x['sim'] for x in self.test_results)
         ratio_time  = sim_time_ns / real_time
 
         summary = ""
@@ -389,16 +529,105 @@ class RegressionManager(object):
 
         self.log.info(summary)
 
-    def _store_test_result(self, module_name, test_name, result_pass, sim_time, real_time, ratio):
+    def _log_callback_summary(self):
+        """Log how the time of each test was split between Python and the simulator."""
+        TEST_FIELD   = 'TEST'
+        KIND_FIELD   = 'CALLBACK'
+        CALLS_FIELD  = 'CALLS'
+        PYTHON_FIELD = 'PYTHON(S)'
+        SIM_FIELD    = 'SIMULATOR(S)'
+
+        results = [x for x in self.test_results if x['callbacks']]
+        if not results:
+            return
+
+        TEST_FIELD_LEN   = max(len(TEST_FIELD),len(max([x['test'] for x in results],key=len)))
+        KIND_FIELD_LEN   = len('NextTimeStep')
+        CALLS_FIELD_LEN  = 10
+        PYTHON_FIELD_LEN = len(PYTHON_FIELD) + 2
+        SIM_FIELD_LEN    = len(SIM_FIELD)
+
+        LINE_LEN = 3 + TEST_FIELD_LEN + 2 + KIND_FIELD_LEN + 2 + CALLS_FIELD_LEN + 2 + PYTHON_FIELD_LEN + 2 + SIM_FIELD_LEN + 3
+
+        LINE_SEP = "*"*LINE_LEN+"\n"
+        ROW = "** {a:<{a_len}}  {b:<{b_len}}  {c:>{c_len}}  {d:>{d_len}}  {e:>{e_len}} **\n"
+
+        summary = ""
+        summary += LINE_SEP
+        summary += ROW.format(a=TEST_FIELD,   a_len=TEST_FIELD_LEN,
+                              b=KIND_FIELD,   b_len=KIND_FIELD_LEN,
+                              c=CALLS_FIELD,  c_len=CALLS_FIELD_LEN,
+                              d=PYTHON_FIELD, d_len=PYTHON_FIELD_LEN,
+                              e=SIM_FIELD,    e_len=SIM_FIELD_LEN)
+        summary += LINE_SEP
+        for result in results:
+            test_name = result['test']
+            total = [0, 0.0, 0.0]
+            for kind, (calls, python_time, sim_time) in sorted(result['callbacks'].items()):
+                if not calls:
+                    continue
+                summary += ROW.format(a=test_name,                         a_len=TEST_FIELD_LEN,
+                                      b=kind,                              b_len=KIND_FIELD_LEN,
+                                      c=calls,                             c_len=CALLS_FIELD_LEN,
+                                      d="{0:.3f}".format(python_time),     d_len=PYTHON_FIELD_LEN,
+                                      e="{0:.3f}".format(sim_time),        e_len=SIM_FIELD_LEN)
+                test_name = ''
+                total[0] += calls
+                total[1] += python_time
+                total[2] += sim_time
+            summary += ROW.format(a=test_name,                     a_len=TEST_FIELD_LEN,
+                                  b='TOTAL',                       b_len=KIND_FIELD_LEN,
+                                  c=total[0],                      c_len=CALLS_FIELD_LEN,
+                                  d="{0:.3f}".format(total[1]),    d_len=PYTHON_FIELD_LEN,
+                                  e="{0:.3f}".format(total[2]),    e_len=SIM_FIELD_LEN)
+        summary += LINE_SEP
+
+        self.log.info(summary)
+
+    def _callback_times(self):
+        """Current totals of (calls, Python ns, simulator ns) per kind of callback."""
+        if simulator is None:
+            return {}
+        return dict((kind, (calls, python_ns, sim_ns))
+                    for kind, calls, python_ns, sim_ns in simulator.get_callback_times())
+
+    def _callback_times_since(self, start):
+        """(calls, Python seconds, simulator seconds) per kind of callback since start."""
+        times = {}
+        for kind, (calls, python_ns, sim_ns) in self._callback_times().items():
+            start_calls, start_python_ns, start_sim_ns = start.get(kind, (0, 0, 0))
+            times[kind] = (calls - start_calls,
+                           (python_ns - start_python_ns) / 1e9,
+                           (sim_ns - start_sim_ns) / 1e9)
+        return times
+
+    def _store_test_result(self, module_name, test_name, result_pass, sim_time, real_time, ratio, callbacks=None):
         result = {
-            'test'  : '.'.join([module_name, test_name]),
-            'pass'  : result_pass,
-            'sim'   : sim_time,
-            'real'  : real_time,
-            'ratio' : ratio}
+            'test'      : '.'.join([module_name, test_name]),
+            'pass'      : result_pass,
+            'sim'       : sim_time,
+            'real'      : real_time,
+            'ratio'     : ratio,
+            'callbacks' : callbacks or {}}
         self.test_results.append(result)
 
 
+def _fork_jobs():
+    """The number of tests to run at once in forked processes, 0 to run
+    them all in this process."""
+    jobs = os.getenv("COCOTB_FORK_TESTS")
+    if jobs is None or not hasattr(os, "fork"):
+        return 0
+    jobs = int(jobs) if jobs else 0
+    if jobs <= 0:
+        try:
+            import multiprocessing
+            jobs = multiprocessing.cpu_count()
+        except NotImplementedError:
+            jobs = 1
+    return jobs
+
+
 def _create_test(function, name, documentation, mod, *args, **kwargs):
     """Factory function to create tests, avoids late binding.
 
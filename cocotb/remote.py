@@ -0,0 +1,731 @@
+# Copyright cocotb contributors
+# Licensed under the Revised BSD License, see LICENSE for details.
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""Testbench running in its own process, out of the simulator.
+
+With ``COCOTB_REMOTE`` set the simulator does not embed Python. The GPI
+starts a separate Python process instead and forwards callbacks and signal
+accesses to it over a pair of rings in a shared file, laid out as described
+in ``GpiRemote.cpp``. In that process :func:`connect` installs a
+:class:`Simulator` as the ``simulator`` module, so the rest of cocotb runs
+unchanged.
+
+Writes and callback registrations are batched and only cross the channel
+when the testbench waits for a value or hands control back to the
+simulator. A :class:`Sampler` lets monitors and scoreboards receive the
+values of signals at every clock edge while the simulation carries on.
+"""
+
+import os
+import sys
+import mmap
+import struct
+import time
+import types
+import traceback
+
+try:
+    _integer_types = (int, long)
+except NameError:
+    _integer_types = (int,)
+
+try:
+    _clock = time.perf_counter
+except AttributeError:
+    _clock = time.time
+
+
+def _now_ns():
+    return int(_clock() * 1e9)
+
+
+_MAGIC = b"COCOTBCH"
+_VERSION = 1
+_HEADER_SIZE = 64
+_CONTROL_SIZE = 128
+
+# Record types and flags, as in GpiRemote.cpp
+_PAD = 0
+
+_RESUME = 1
+_STOP = 2
+_LOG_LEVEL = 3
+_GET_ROOT = 4
+_GET_BY_NAME = 5
+_GET_BY_INDEX = 6
+_ITERATE = 7
+_GET_VALUE = 8
+_SET_LONG = 9
+_SET_REAL = 10
+_SET_STR = 11
+_REGISTER = 12
+_DEREGISTER = 13
+
+_INIT = 64
+_REPLY = 65
+_CALLBACK = 66
+_SAMPLE = 67
+_FAILED = 68
+_SIM_EVENT = 69
+_END = 70
+
+_MORE = 1
+_BINSTR = 1
+
+_record = struct.Struct("=IHH")
+_counter = struct.Struct("=Q")
+_init = struct.Struct("=Qii")
+_handle_info = struct.Struct("=IiiiiiiI")
+_register = struct.Struct("=IHHIIQ")
+_callback = struct.Struct("=IIQ")
+_id = struct.Struct("=I")
+_id_int = struct.Struct("=Ii")
+_id_long = struct.Struct("=IIq")
+_id_real = struct.Struct("=IId")
+_int = struct.Struct("=i")
+_long = struct.Struct("=q")
+_real = struct.Struct("=d")
+
+# Busy wait for this many polls before yielding, then sleeping. There is no
+# busy waiting on a single CPU, where it only delays the simulator.
+_SPINS = 2000
+_YIELDS = 1000
+_SLEEP = 50e-6
+
+_yield = getattr(os, "sched_yield", lambda: time.sleep(0))
+
+
+class _Ring(object):
+    """One direction of the channel, see ``GpiRing`` in ``GpiRemote.cpp``.
+
+    As the producer, ``pos`` is the end of the records written but not yet
+    published; as the consumer, the end of the records read but not yet
+    released.
+    """
+
+    def __init__(self, buf, offset, size):
+        self._buf = buf
+        self._head = offset
+        self._tail = offset + 64
+        self._data = offset + _CONTROL_SIZE
+        self._size = size
+        self._mask = size - 1
+        self._seen = 0
+        self.pos = 0
+
+    # The counters are aligned 8 byte words, stored with a single write
+
+    def has_space(self, length):
+        need = _record.size + ((length + 7) & ~7)
+        offset = self.pos & self._mask
+        if offset + need > self._size:
+            need += self._size - offset
+        return self.pos + need - _counter.unpack_from(self._buf, self._tail)[0] <= self._size
+
+    def put(self, rtype, flags, payload):
+        length = len(payload)
+        offset = self.pos & self._mask
+        if offset + _record.size + ((length + 7) & ~7) > self._size:
+            _record.pack_into(self._buf, self._data + offset,
+                              self._size - offset - _record.size, _PAD, 0)
+            self.pos += self._size - offset
+            offset = 0
+        start = self._data + offset
+        _record.pack_into(self._buf, start, length, rtype, flags)
+        self._buf[start + _record.size:start + _record.size + length] = payload
+        self.pos += _record.size + ((length + 7) & ~7)
+
+    def publish(self):
+        _counter.pack_into(self._buf, self._head, self.pos)
+
+    def get(self):
+        """The next record as (type, flags, payload), None if there is none."""
+        while True:
+            if self.pos == self._seen:
+                self._seen = _counter.unpack_from(self._buf, self._head)[0]
+                if self.pos == self._seen:
+                    return None
+            start = self._data + (self.pos & self._mask)
+            length, rtype, flags = _record.unpack_from(self._buf, start)
+            self.pos += _record.size + ((length + 7) & ~7)
+            if rtype != _PAD:
+                start += _record.size
+                return rtype, flags, self._buf[start:start + length]
+
+    def release(self):
+        _counter.pack_into(self._buf, self._tail, self.pos)
+
+
+class RemoteHandle(object):
+    """A simulator object, the out-of-process counterpart of
+    ``simulator.gpi_sim_hdl``."""
+
+    __slots__ = ("_sim", "_id", "_elems", "type", "const", "num_elems", "range",
+                 "name", "fullname", "type_string", "definition_name",
+                 "definition_file")
+
+    def __init__(self, sim, hid, htype, const, num_elems, rng, strings):
+        self._sim = sim
+        self._id = hid
+        self._elems = None
+        self.type = htype
+        self.const = const
+        self.num_elems = num_elems
+        self.range = rng
+        (self.name, self.fullname, self.type_string,
+         self.definition_name, self.definition_file) = strings
+
+    def get_value(self):
+        """Get the value of a signal, as a binary string unless an integer,
+        real or string object."""
+        return self._sim._get_value(self)
+
+    def set_value(self, value):
+        """Set the value of a signal from an int, float or string."""
+        self._sim._set_value(self, value)
+
+    def register_edge(self, function, edge, *args):
+        """Register a signal change callback."""
+        return self._sim._register(Simulator.CB_VALUE_CHANGE, self, edge, 0, function, args)
+
+    def __hash__(self):
+        return self._id
+
+    def __eq__(self, other):
+        return isinstance(other, RemoteHandle) and self._id == other._id
+
+    def __ne__(self, other):
+        return not self == other
+
+    def __repr__(self):
+        return "<gpi_sim_hdl %s at %d>" % (self.fullname, self._id)
+
+
+class Simulator(types.ModuleType):
+    """Stands in for the ``simulator`` module in the testbench process,
+    forwarding each call to the GPI in the simulator over the channel."""
+
+    UNKNOWN = 0
+    MEMORY = 1
+    MODULE = 2
+    NET = 3
+    PARAMETER = 4
+    REG = 5
+    NETARRAY = 6
+    ENUM = 7
+    STRUCTURE = 8
+    REAL = 9
+    INTEGER = 10
+    STRING = 11
+    GENARRAY = 12
+
+    OBJECTS = 1
+    DRIVERS = 2
+    LOADS = 3
+
+    CB_TIMER = 0
+    CB_VALUE_CHANGE = 1
+    CB_READWRITE = 2
+    CB_READONLY = 3
+    CB_NEXTTIME = 4
+
+    gpi_sim_hdl = RemoteHandle
+
+    def __init__(self, path):
+        types.ModuleType.__init__(self, "simulator")
+        with open(path, "r+b") as f:
+            self._buf = mmap.mmap(f.fileno(), 0)
+
+        if self._buf[:8] != _MAGIC:
+            raise ValueError("%s is not a cocotb channel" % path)
+        version, ring_size = struct.unpack_from("=II", self._buf, 8)
+        if version != _VERSION:
+            raise ValueError("Channel %s is version %d, expected %d" % (path, version, _VERSION))
+
+        self._requests = _Ring(self._buf, _HEADER_SIZE, ring_size)
+        self._events = _Ring(self._buf, _HEADER_SIZE + _CONTROL_SIZE + ring_size, ring_size)
+        self._max_record = ring_size // 2
+        self._parent = os.getppid()
+        try:
+            self._spins = _SPINS if os.cpu_count() > 1 else 0
+        except AttributeError:
+            import multiprocessing
+            self._spins = _SPINS if multiprocessing.cpu_count() > 1 else 0
+
+        self._replies = []
+        self._pending = []
+        self._handles = {}
+        self._callbacks = {}
+        self._samplers = {}
+        self._failed = []
+        self._next_id = 1
+        self._time = 0
+        self._running = False
+        self._ended = False
+        self._startup = []
+        self._startup_open = []
+
+        rtype, flags, payload = self._next_event()
+        if rtype != _INIT:
+            raise ValueError("Channel %s did not start with an initialisation" % path)
+        self._time, self._precision, argc = _init.unpack_from(payload)
+        strings = [s.decode() for s in payload[_init.size:].split(b"\0")]
+        self.product = strings[0]
+        self.version = strings[1]
+        self.argv = strings[2:2 + argc]
+
+    # Channel
+
+    def _poll(self, polls):
+        if polls < self._spins:
+            return
+        if polls < self._spins + _YIELDS:
+            _yield()
+            return
+        if os.getppid() != self._parent:
+            sys.stderr.write("Simulator exited, stopping the testbench\n")
+            os._exit(1)
+        time.sleep(_SLEEP)
+
+    def _drain(self):
+        """Read all the records published by the simulator."""
+        got = False
+        while True:
+            record = self._events.get()
+            if record is None:
+                break
+            got = True
+            if record[0] == _REPLY:
+                self._replies.append(record)
+            else:
+                self._pending.append(record)
+        if got:
+            self._events.release()
+        return got
+
+    def _request(self, rtype, payload=b"", flags=0):
+        if len(payload) > self._max_record:
+            raise ValueError("Request of %d bytes is too large for the channel" % len(payload))
+        ring = self._requests
+        if not ring.has_space(len(payload)):
+            ring.publish()
+            polls = 0
+            while not ring.has_space(len(payload)):
+                if not self._drain():
+                    polls += 1
+                    self._poll(polls)
+        ring.put(rtype, flags, payload)
+
+    def _reply(self):
+        """The payload of the next reply, sending any requests written."""
+        if self._running:
+            raise RuntimeError("The simulator can not be read from a sample callback")
+        self._requests.publish()
+        polls = 0
+        while not self._replies:
+            if not self._drain():
+                polls += 1
+                self._poll(polls)
+        rtype, flags, payload = self._replies.pop(0)
+        return flags, payload
+
+    def _next_event(self):
+        self._requests.publish()
+        polls = 0
+        while not self._pending:
+            if not self._drain():
+                polls += 1
+                self._poll(polls)
+        return self._pending.pop(0)
+
+    def _resume(self):
+        self._request(_RESUME)
+        self._requests.publish()
+        self._running = True
+
+    def _read_handle(self, payload):
+        hid = _id.unpack_from(payload)[0]
+        if hid == 0:
+            return None
+        hdl = self._handles.get(hid)
+        if hdl is not None:
+            return hdl
+        (hid, htype, const, num_elems, indexable, left, right,
+         null_mask) = _handle_info.unpack_from(payload)
+        strings = payload[_handle_info.size:].split(b"\0")[:5]
+        strings = [None if null_mask & (1 << i) else s.decode()
+                   for i, s in enumerate(strings)]
+        hdl = RemoteHandle(self, hid, htype, const, num_elems,
+                           (left, right) if indexable else None, strings)
+        self._handles[hid] = hdl
+        return hdl
+
+    def _get_handle(self, rtype, payload):
+        self._request(rtype, payload)
+        flags, payload = self._reply()
+        return self._read_handle(payload)
+
+    def _decode_value(self, hdl, flags, payload):
+        if not flags & _BINSTR:
+            if hdl.type in (Simulator.INTEGER, Simulator.ENUM):
+                return _long.unpack_from(payload)[0]
+            if hdl.type == Simulator.REAL:
+                return _real.unpack_from(payload)[0]
+        return payload[:-1].decode()
+
+    def _get_value(self, hdl, flags=0):
+        self._request(_GET_VALUE, _id.pack(hdl._id), flags)
+        return self._decode_value(hdl, flags, self._reply()[1])
+
+    def _set_value(self, hdl, value):
+        if isinstance(value, float):
+            self._request(_SET_REAL, _id_real.pack(hdl._id, 0, value))
+        elif isinstance(value, _integer_types):
+            # As gpi_sim_hdl.set_value, wider than 32 bits needs a vector
+            if -0x80000000 <= value <= 0x7fffffff:
+                self._request(_SET_LONG, _id_long.pack(hdl._id, 0, value))
+            elif hdl.type in (Simulator.INTEGER, Simulator.ENUM,
+                              Simulator.REAL, Simulator.STRING):
+                raise OverflowError("int too big to write to %s" % hdl.fullname)
+            else:
+                self.set_signal_val_int(hdl, value)
+        else:
+            if not isinstance(value, bytes):
+                value = value.encode()
+            self._request(_SET_STR, _id.pack(hdl._id) + value + b"\0")
+
+    def _register(self, kind, hdl, edge, steps, function, args, samples=None):
+        cb_id = self._next_id
+        self._next_id += 1
+        if samples is None:
+            self._callbacks[cb_id] = (function, args)
+            samples = ()
+        else:
+            self._samplers[cb_id] = function
+        payload = _register.pack(cb_id, kind, edge, hdl._id if hdl is not None else 0,
+                                 len(samples), steps)
+        if samples:
+            payload += struct.pack("=%dI" % len(samples), *[s._id for s in samples])
+        self._request(_REGISTER, payload)
+        return cb_id
+
+    # Main loop
+
+    def _call(self, function, args):
+        try:
+            function(*args)
+        except Exception:
+            traceback.print_exc()
+            self.stop_simulator()
+
+    def _run(self):
+        """Handle callbacks from the simulator until it exits."""
+        import cocotb
+
+        while True:
+            rtype, flags, payload = self._next_event()
+            if rtype in (_CALLBACK, _SIM_EVENT):
+                self._running = False
+                # Fail the test now that the simulator is waiting again
+                for cb_id in self._failed:
+                    self._call(cocotb._sim_event,
+                               (1, "Unable to register callback %d with the simulator" % cb_id))
+                self._failed = []
+
+            if rtype == _CALLBACK:
+                cb_id, _, self._time = _callback.unpack_from(payload)
+                entry = self._callbacks.pop(cb_id, None)
+                if entry is not None:
+                    self._call(*entry)
+                self._resume()
+            elif rtype == _SAMPLE:
+                cb_id, _, sample_time = _callback.unpack_from(payload)
+                function = self._samplers.get(cb_id)
+                if function is not None:
+                    values = [v.decode() for v in payload[_callback.size:].split(b"\0")[:-1]]
+                    self._call(function, (sample_time, values))
+            elif rtype == _FAILED:
+                cb_id = _id.unpack_from(payload)[0]
+                self._callbacks.pop(cb_id, None)
+                self._samplers.pop(cb_id, None)
+                self._failed.append(cb_id)
+            elif rtype == _SIM_EVENT:
+                level = _int.unpack_from(payload)[0]
+                self._call(cocotb._sim_event, (level, payload[4:-1].decode()))
+                self._resume()
+            elif rtype == _END:
+                self._ended = True
+                return
+
+    # The simulator module
+
+    def log_level(self, level):
+        """Set the log level for GPI."""
+        self._request(_LOG_LEVEL, _int.pack(level))
+
+    def hold_gil(self, flag):
+        """The simulator thread holds no GIL out of process."""
+
+    def stop_simulator(self):
+        """Instruct the attached simulator to stop."""
+        self._request(_STOP)
+
+    def get_sim_time(self):
+        """Get the current simulation time as an int tuple."""
+        return (self._time >> 32, self._time & 0xFFFFFFFF)
+
+    def get_precision(self):
+        """Get the precision of the simulator."""
+        return self._precision
+
+    def get_root_handle(self, name):
+        """Get the root handle."""
+        return self._get_handle(_GET_ROOT, (name or "").encode() + b"\0")
+
+    def get_handle_by_name(self, hdl, name):
+        """Get handle of a named object."""
+        return self._get_handle(_GET_BY_NAME, _id.pack(hdl._id) + name.encode() + b"\0")
+
+    def get_handle_by_index(self, hdl, index):
+        """Get handle of a object at an index in a parent."""
+        return self._get_handle(_GET_BY_INDEX, _id_int.pack(hdl._id, index))
+
+    def iterate(self, hdl, selection):
+        """Get an iterator over all members of an object, found in one
+        request."""
+        self._request(_ITERATE, _id_int.pack(hdl._id, selection))
+        handles = []
+        while True:
+            flags, payload = self._reply()
+            if not flags & _MORE:
+                return iter(handles)
+            handles.append(self._read_handle(payload))
+
+    def next(self, iterator):
+        """Get the next object from the iterator."""
+        return next(iterator)
+
+    def get_signal_val_binstr(self, hdl):
+        """Get the value of a signal as a binary string."""
+        return self._get_value(hdl, _BINSTR)
+
+    def get_signal_val_int(self, hdl):
+        """Get the value of a signal as an int, resolving X, Z and friends
+        following ``COCOTB_RESOLVE_X``, or None if it is a real or string."""
+        if hdl.type in (Simulator.INTEGER, Simulator.ENUM):
+            return self._get_value(hdl)
+        if hdl.type in (Simulator.REAL, Simulator.STRING):
+            return None
+        binstr = self._get_value(hdl, _BINSTR)
+        try:
+            return int(binstr, 2) if binstr else 0
+        except ValueError:
+            from cocotb.binary import resolve
+            return int(resolve(binstr), 2)
+
+    def set_signal_val_int(self, hdl, value):
+        """Set the value of a signal using a non-negative int of any width."""
+        if not isinstance(value, _integer_types):
+            raise TypeError("set_signal_val_int() requires an int")
+        width = hdl.num_elems
+        if value < 0:
+            raise OverflowError("can't convert negative int to unsigned")
+        if value >> width:
+            raise OverflowError("int too big to fit in signal")
+        self._set_value(hdl, format(value, "0%db" % width) if width else "")
+
+    def _elements(self, hdl):
+        if hdl._elems is None:
+            left, right = hdl.range
+            step = 1 if right >= left else -1
+            hdl._elems = [self.get_handle_by_index(hdl, i)
+                          for i in range(left, right + step, step)]
+        return hdl._elems
+
+    def get_array_val(self, hdl, buffer):
+        """Read every element of an array into a writable buffer of integers,
+        with one request per element sent together."""
+        elems = self._elements(hdl)
+        view = memoryview(buffer)
+        if len(view) != len(elems):
+            raise ValueError("buffer has %d items, array has %d elements" % (len(view), len(elems)))
+        for elem in elems:
+            self._request(_GET_VALUE, _id.pack(elem._id))
+        for i, elem in enumerate(elems):
+            value = self._decode_value(elem, *self._reply())
+            if not isinstance(value, _integer_types):
+                try:
+                    value = int(value, 2)
+                except ValueError:
+                    raise ValueError("Element %d of %s is %s" % (i, hdl.name, value))
+            view[i] = value
+
+    def set_array_val(self, hdl, buffer):
+        """Write every element of an array from a buffer of integers."""
+        elems = self._elements(hdl)
+        view = memoryview(buffer)
+        if len(view) != len(elems):
+            raise ValueError("buffer has %d items, array has %d elements" % (len(view), len(elems)))
+        for elem, value in zip(elems, view.tolist()):
+            if elem.type in (Simulator.INTEGER, Simulator.ENUM):
+                self._set_value(elem, value)
+            else:
+                self.set_signal_val_int(elem, value & ((1 << elem.num_elems) - 1))
+
+    def register_timed_callback(self, steps, function, *args):
+        """Register a timed callback."""
+        return self._register(Simulator.CB_TIMER, None, 0, steps, function, args)
+
+    def register_value_change_callback(self, hdl, function, edge, *args):
+        """Register a signal change callback."""
+        return self._register(Simulator.CB_VALUE_CHANGE, hdl, edge, 0, function, args)
+
+    def register_readonly_callback(self, function, *args):
+        """Register a callback for readonly section."""
+        return self._register(Simulator.CB_READONLY, None, 0, 0, function, args)
+
+    def register_nextstep_callback(self, function, *args):
+        """Register a callback for the nextsimtime callback."""
+        return self._register(Simulator.CB_NEXTTIME, None, 0, 0, function, args)
+
+    def register_rwsynch_callback(self, function, *args):
+        """Register a callback for the readwrite section."""
+        return self._register(Simulator.CB_READWRITE, None, 0, 0, function, args)
+
+    def register_callbacks(self, specs, function):
+        """Register a callback calling the same function for each
+        (kind, handle, edge or time, *args) spec in a list."""
+        hdls = []
+        for spec in specs:
+            kind, hdl, arg = spec[:3]
+            if kind == Simulator.CB_TIMER:
+                hdls.append(self._register(kind, None, 0, arg, function, spec[3:]))
+            else:
+                hdls.append(self._register(kind, hdl, arg or 0, 0, function, spec[3:]))
+        return hdls
+
+    def register_sample_callback(self, hdl, edge, samples, function):
+        """Register a callback receiving (time, values) at every edge of a
+        signal, without stopping the simulator."""
+        return self._register(Simulator.CB_VALUE_CHANGE, hdl, edge, 0, function, (), list(samples))
+
+    def deregister_callback(self, hdl):
+        """Deregister a callback."""
+        self.deregister_callbacks([hdl])
+
+    def deregister_callbacks(self, hdls):
+        """Deregister a list of callbacks, those which have fired are already
+        gone."""
+        ids = [h for h in hdls
+               if self._callbacks.pop(h, None) is not None or
+               self._samplers.pop(h, None) is not None]
+        if ids:
+            self._request(_DEREGISTER, struct.pack("=%dI" % len(ids), *ids))
+
+    def get_callback_times(self):
+        """Not measured out of process."""
+        return []
+
+    def startup_begin(self, phase):
+        """Begin a phase of the testbench's own start-up timeline."""
+        self._startup_open.append(len(self._startup))
+        self._startup.append([phase, len(self._startup_open) - 1, _now_ns(), None])
+
+    def startup_end(self):
+        """End the start-up phase begun most recently."""
+        if self._startup_open:
+            self._startup[self._startup_open.pop()][3] = _now_ns()
+
+    def get_startup_profile(self):
+        """The start-up timeline of the testbench process only, timed from
+        its first phase."""
+        if not self._startup:
+            return []
+        now = _now_ns()
+        origin = self._startup[0][2]
+        return [(name, depth, start - origin,
+                 (now if end is None else end) - origin, end is None)
+                for name, depth, start, end in self._startup]
+
+
+class Sampler(object):
+    """Calls ``callback(time, values)`` at every edge of ``clock`` with the
+    values of ``signals`` as binary strings and the time in simulator steps.
+
+    Out of process the simulator does not wait for the callback, which runs
+    while the simulation carries on, so it must only consume the values it
+    is given. In an embedded testbench it is an ordinary value change
+    callback.
+
+    Args:
+        clock: Signal whose edges trigger a sample.
+        signals: Signals to sample.
+        callback: Called with the time and list of values.
+        edge (int): 1 for rising edges, 2 for falling edges, 3 for both.
+    """
+
+    def __init__(self, clock, signals, callback, edge=1):
+        import simulator
+        self._clock = clock._handle
+        self._handles = [s._handle for s in signals]
+        self._callback = callback
+        self._edge = edge
+        if isinstance(simulator, Simulator):
+            self._cbhdl = simulator.register_sample_callback(
+                self._clock, edge, self._handles, callback)
+        else:
+            self._cbhdl = self._clock.register_edge(self._sample, edge)
+
+    def _sample(self):
+        import simulator
+        high, low = simulator.get_sim_time()
+        self._callback((high << 32) | low,
+                       [simulator.get_signal_val_binstr(h) for h in self._handles])
+        self._cbhdl = self._clock.register_edge(self._sample, self._edge)
+
+    def stop(self):
+        """Stop sampling."""
+        import simulator
+        if self._cbhdl:
+            simulator.deregister_callback(self._cbhdl)
+            self._cbhdl = 0
+
+
+def connect(path):
+    """Open the channel at ``path`` and install the :class:`Simulator` using
+    it as the ``simulator`` module."""
+    sim = Simulator(path)
+    sys.modules["simulator"] = sim
+    return sim
+
+
+def main():
+    """Run the testbench, the entry point of the process started by the
+    simulator."""
+    import cocotb
+    import simulator
+
+    # As embed_sim_init() does for an embedded testbench
+    dut = os.getenv("TOPLEVEL")
+    if dut is not None:
+        dut = dut.split(".", 1)[-1] if dut else None
+
+    cocotb.argv = simulator.argv
+    cocotb.argc = len(simulator.argv)
+    cocotb.SIM_NAME = simulator.product
+    cocotb.SIM_VERSION = simulator.version
+    cocotb.LANGUAGE = os.getenv("TOPLEVEL_LANG")
+
+    cocotb.loggpi.info("Running on %s version %s" % (simulator.product, simulator.version))
+    cocotb.loggpi.info("Python interpreter started and cocotb loaded out of process")
+
+    try:
+        cocotb._initialise_testbench(dut)
+    except Exception:
+        traceback.print_exc()
+        simulator.stop_simulator()
+
+    simulator._resume()
+    simulator._run()
+    sys.stdout.flush()
@@ -61,6 +61,16 @@ if "COCOTB_SCHEDULER_DEBUG" in os.environ:
 else:
     _debug = False
 
+# Let the simulator thread keep the GIL between callbacks while there are no
+# external threads that would need it
+_hold_gil = "COCOTB_HOLD_GIL" in os.environ
+
+# Hand fired triggers to the waiting coroutines with the native core in the
+# simulator module when there is one, unless COCOTB_PY_SCHEDULER is set. The
+# core does not log, so scheduler debug uses the Python loop too
+_use_core = (simulator is not None and hasattr(simulator, "SchedulerCore") and
+             "COCOTB_PY_SCHEDULER" not in os.environ and not _debug)
+
 
 import cocotb
 import cocotb.decorators
@@ -72,6 +82,26 @@ from cocotb.result import (TestComplete, TestError, ReturnValue, raise_error,
 from cocotb.utils import nullcontext
 
 
+# For each type of trigger seen, whether it is a GPITrigger with its own
+# _callback_spec, so it can be registered in a batch while reacting. Others,
+# such as StreamEvent or a GPITrigger that only overrides prime, are primed
+# one at a time
+_batched_types = {}
+
+
+def _batched(trigger):
+    cls = type(trigger)
+    try:
+        return _batched_types[cls]
+    except KeyError:
+        spec = getattr(cls, "_callback_spec", None)
+        batched = (issubclass(cls, GPITrigger) and
+                   getattr(spec, "__func__", spec) is not
+                   GPITrigger.__dict__["_callback_spec"])
+        _batched_types[cls] = batched
+        return batched
+
+
 class profiling_context(object):
     """ Context manager that profiles its contents """
     def __enter__(self):
@@ -243,15 +273,25 @@ class Scheduler(object):
         self._pending_threads = []
         self._pending_events = []   # Events we need to call set on once we've unwound
 
+        # GPI triggers primed and callback handles dropped while reacting,
+        # registered and deregistered together before returning to the simulator
+        self._gpi_to_prime = []
+        self._gpi_to_unprime = []
+
         self._terminate = False
         self._test_result = None
         self._entrypoint = None
         self._main_thread = threading.current_thread()
+        self._gil_held = False
 
         # Select the appropriate scheduling algorithm for this simulator
         self.advance = self.default_scheduling_algorithm
         self._is_reacting = False
 
+        # The core keeps references to the containers above, which is why
+        # they are only ever emptied in place
+        self._core = simulator.SchedulerCore(self) if _use_core else None
+
     def default_scheduling_algorithm(self):
         """
         Decide whether we need to schedule our own triggers (if at all) in
@@ -281,8 +321,8 @@ class Scheduler(object):
                     t.unprime()
 
             self._timer1.prime(self.begin_test)
-            self._trigger2coros = collections.defaultdict(list)
-            self._coro2trigger = {}
+            self._trigger2coros.clear()
+            self._coro2trigger.clear()
             self._terminate = False
             self._mode = Scheduler._MODE_TERM
 
@@ -294,9 +334,15 @@ class Scheduler(object):
         if _debug:
             self.log.debug("begin_test called with trigger: %s" %
                            (str(trigger)))
+        read_cache = cocotb.handle._read_cache
+        if read_cache is not None:
+            read_cache.invalidate()
         if _profiling:
             ps = pstats.Stats(_profile).sort_stats('cumulative')
             ps.dump_stats("test_profile.pstat")
+            if read_cache is not None:
+                self.log.info("Read cache: %d hits, %d misses" %
+                              (read_cache.hits, read_cache.misses))
             ctx = profiling_context()
         else:
             ctx = nullcontext()
@@ -318,6 +364,9 @@ class Scheduler(object):
                 self.schedule(test)
                 self.advance()
 
+        if _hold_gil:
+            self._update_gil_hold()
+
     def react(self, trigger):
         """
         Called when a trigger fires.
@@ -330,13 +379,34 @@ class Scheduler(object):
             self._pending_triggers.append(trigger)
             return
 
+        # The simulator has had control, so values read earlier may be stale
+        read_cache = cocotb.handle._read_cache
+        if read_cache is not None:
+            read_cache.invalidate()
+
         # start the event loop
         self._is_reacting = True
         try:
             self._event_loop(trigger)
         finally:
+            if self._gpi_to_prime or self._gpi_to_unprime:
+                self._flush_gpi_callbacks()
             self._is_reacting = False
 
+        if _hold_gil:
+            self._update_gil_hold()
+
+    def _update_gil_hold(self):
+        """Tell the simulator whether to keep the GIL between callbacks.
+
+        External threads can only run while the simulator thread has released
+        the GIL, so it is only held while none of them are pending.
+        """
+        hold = not self._pending_threads
+        if hold != self._gil_held:
+            simulator.hold_gil(hold)
+            self._gil_held = hold
+
 
     def _event_loop(self, trigger):
         """
@@ -400,77 +470,97 @@ class Scheduler(object):
                 return
 
             # work through triggers one by one
-            is_first = True
-            self._pending_triggers.append(trigger)
-            while self._pending_triggers:
-                trigger = self._pending_triggers.pop(0)
-
-                if not is_first and isinstance(trigger, GPITrigger):
-                    self.log.warning(
-                        "A GPI trigger occurred after entering react - this "
-                        "should not happen."
-                    )
-                    assert False
-
-                # this only exists to enable the warning above
-                is_first = False
-
-                if trigger not in self._trigger2coros:
-
-                    # GPI triggers should only be ever pending if there is an
-                    # associated coroutine waiting on that trigger, otherwise it would
-                    # have been unprimed already
-                    if isinstance(trigger, GPITrigger):
-                        self.log.critical(
-                            "No coroutines waiting on trigger that fired: %s" %
-                            str(trigger))
-
-                        trigger.log.info("I'm the culprit")
-                    # For Python triggers this isn't actually an error - we might do
-                    # event.set() without knowing whether any coroutines are actually
-                    # waiting on this event, for example
-                    elif _debug:
-                        self.log.debug(
-                            "No coroutines waiting on trigger that fired: %s" %
-                            str(trigger))
-
-                    continue
-
-                # Scheduled coroutines may append to our waiting list so the first
-                # thing to do is pop all entries waiting on this trigger.
-                scheduling = self._trigger2coros.pop(trigger)
-
-                if _debug:
-                    debugstr = "\n\t".join([coro.__name__ for coro in scheduling])
-                    if len(scheduling):
-                        debugstr = "\n\t" + debugstr
-                    self.log.debug("%d pending coroutines for event %s%s" %
-                                   (len(scheduling), str(trigger), debugstr))
-
-                # This trigger isn't needed any more
-                trigger.unprime()
-
-                for coro in scheduling:
-                    if _debug:
-                        self.log.debug("Scheduling coroutine %s" % (coro.__name__))
-                    self.schedule(coro, trigger=trigger)
-                    if _debug:
-                        self.log.debug("Scheduled coroutine %s" % (coro.__name__))
-
-                # Schedule may have queued up some events so we'll burn through those
-                while self._pending_events:
-                    if _debug:
-                        self.log.debug("Scheduling pending event %s" %
-                                       (str(self._pending_events[0])))
-                    self._pending_events.pop(0).set()
+            if self._core is not None:
+                self._core.dispatch(trigger)
+            else:
+                self._dispatch(trigger)
 
             # no more pending triggers
+            self._flush_gpi_callbacks()
             self.advance()
             if _debug:
                 self.log.debug("All coroutines scheduled, handing control back"
                                " to simulator")
 
 
+    def _dispatch(self, trigger):
+        """Schedule the coroutines waiting on a trigger that fired, then those
+        waiting on any triggers that fire as a result, until none are left.
+
+        ``SchedulerCore.dispatch`` in the simulator module does the same
+        natively and calls back into the helpers below for anything but a
+        coroutine waking up and yielding another trigger.
+        """
+        is_first = True
+        self._pending_triggers.append(trigger)
+        while self._pending_triggers:
+            trigger = self._pending_triggers.pop(0)
+
+            if not is_first and isinstance(trigger, GPITrigger):
+                self._late_gpi_trigger(trigger)
+
+            # this only exists to enable the warning above
+            is_first = False
+
+            if trigger not in self._trigger2coros:
+                self._no_waiters(trigger)
+                continue
+
+            # Scheduled coroutines may append to our waiting list so the first
+            # thing to do is pop all entries waiting on this trigger.
+            scheduling = self._trigger2coros.pop(trigger)
+
+            if _debug:
+                debugstr = "\n\t".join([coro.__name__ for coro in scheduling])
+                if len(scheduling):
+                    debugstr = "\n\t" + debugstr
+                self.log.debug("%d pending coroutines for event %s%s" %
+                               (len(scheduling), str(trigger), debugstr))
+
+            # This trigger isn't needed any more
+            trigger.unprime()
+
+            for coro in scheduling:
+                if _debug:
+                    self.log.debug("Scheduling coroutine %s" % (coro.__name__))
+                self.schedule(coro, trigger=trigger)
+                if _debug:
+                    self.log.debug("Scheduled coroutine %s" % (coro.__name__))
+
+            # Schedule may have queued up some events so we'll burn through those
+            while self._pending_events:
+                if _debug:
+                    self.log.debug("Scheduling pending event %s" %
+                                   (str(self._pending_events[0])))
+                self._pending_events.pop(0).set()
+
+    def _no_waiters(self, trigger):
+        """A trigger fired with no coroutines waiting on it."""
+        # GPI triggers should only be ever pending if there is an
+        # associated coroutine waiting on that trigger, otherwise it would
+        # have been unprimed already
+        if isinstance(trigger, GPITrigger):
+            self.log.critical(
+                "No coroutines waiting on trigger that fired: %s" %
+                str(trigger))
+
+            trigger.log.info("I'm the culprit")
+        # For Python triggers this isn't actually an error - we might do
+        # event.set() without knowing whether any coroutines are actually
+        # waiting on this event, for example
+        elif _debug:
+            self.log.debug(
+                "No coroutines waiting on trigger that fired: %s" %
+                str(trigger))
+
+    def _late_gpi_trigger(self, trigger):
+        """A GPI trigger fired while the event loop was already running."""
+        self.log.warning(
+            "A GPI trigger occurred after entering react - this "
+            "should not happen."
+        )
+        assert False
+
     def unschedule(self, coro):
         """Unschedule a coroutine.  Unprime any pending triggers"""
 
@@ -484,6 +574,10 @@ class Scheduler(object):
             if coro in self._trigger2coros[trigger]:
                 self._trigger2coros[trigger].remove(coro)
             if not self._trigger2coros[trigger]:
+                if self._is_reacting and _batched(trigger) and trigger.cbhdl != 0:
+                    # Deregistered along with the others dropped while reacting
+                    self._gpi_to_unprime.append(trigger.cbhdl)
+                    trigger.cbhdl = 0
                 trigger.unprime()
                 del self._trigger2coros[trigger]
 
@@ -501,6 +595,50 @@ class Scheduler(object):
                 )
                 self._terminate = True
 
+    def _flush_gpi_callbacks(self):
+        """Register the GPI triggers primed and deregister the callbacks
+        dropped while reacting, with one call into the simulator each.
+        """
+        while self._gpi_to_unprime or self._gpi_to_prime:
+            if self._gpi_to_unprime:
+                hdls = self._gpi_to_unprime[:]
+                del self._gpi_to_unprime[:]
+                simulator.deregister_callbacks(hdls)
+
+            # Skip triggers yielded more than once or no longer waited on
+            triggers = []
+            for trigger in self._gpi_to_prime:
+                if not trigger.primed and trigger in self._trigger2coros:
+                    trigger.primed = True
+                    triggers.append(trigger)
+            del self._gpi_to_prime[:]
+            if not triggers:
+                continue
+
+            try:
+                hdls = simulator.register_callbacks(
+                    [trigger._callback_spec() for trigger in triggers], self.react)
+            except Exception as e:
+                # A bad spec leaves none of the batch registered
+                for trigger in triggers:
+                    trigger.primed = False
+                self._prime_failed(", ".join(str(t) for t in triggers), e)
+                continue
+
+            failed = []
+            for trigger, hdl in zip(triggers, hdls):
+                trigger.cbhdl = hdl
+                if hdl == 0:
+                    trigger.primed = False
+                    failed.append(trigger)
+
+            # Ending the test drops the callbacks just registered, which goes
+            # round the loop again
+            for trigger in failed:
+                self.finish_test(
+                    create_error(self, "Unable to prime trigger %s: Unable set up %s Trigger" %
+                                 (str(trigger), str(trigger))))
+
     def save_write(self, handle, value):
         if self._mode == Scheduler._MODE_READONLY:
             raise Exception("Write to object {0} was scheduled during a read-only sync phase.".format(handle._name))
@@ -512,13 +650,20 @@ class Scheduler(object):
 
         self._trigger2coros[trigger].append(coro)
         if not trigger.primed:
+            if self._is_reacting and _batched(trigger):
+                # Registered along with the others primed while reacting
+                self._gpi_to_prime.append(trigger)
+                return
             try:
                 trigger.prime(self.react)
             except Exception as e:
-                # Convert any exceptions into a test result
-                self.finish_test(
-                    create_error(self, "Unable to prime trigger %s: %s" %
-                                 (str(trigger), str(e))))
+                self._prime_failed(trigger, e)
+
+    def _prime_failed(self, trigger, e):
+        """Convert an exception priming a trigger into a test result."""
+        self.finish_test(
+            create_error(self, "Unable to prime trigger %s: %s" %
+                         (str(trigger), str(e))))
 
     def queue(self, coroutine):
         """Queue a coroutine for execution"""
@@ -643,6 +788,11 @@ class Scheduler(object):
         if self._terminate:
             return
 
+        self._schedule_result(coroutine, result)
+        self._after_schedule()
+
+    def _schedule_result(self, coroutine, result):
+        """Make a coroutine wait on what it yielded."""
         # convert lists into `First` Waitables.
         if isinstance(result, list):
             result = cocotb.triggers.First(*result)
@@ -681,6 +831,9 @@ class Scheduler(object):
             except Exception as e:
                 self.finish_test(e)
 
+    def _after_schedule(self):
+        """Run any external threads and the coroutines and callbacks queued
+        while a coroutine was scheduled."""
         # We do not return from here until pending threads have completed, but only
         # from the main thread, this seems like it could be problematic in cases
         # where a sim might change what this thread is.
@@ -176,7 +176,13 @@ const char *gpi_get_signal_value_binstr(gpi_sim_hdl gpi_hdl);
 const char *gpi_get_signal_value_str(gpi_sim_hdl gpi_hdl);
 double gpi_get_signal_value_real(gpi_sim_hdl gpi_hdl);
 long gpi_get_signal_value_long(gpi_sim_hdl gpi_hdl);
+// Packs the value into 32 bit words from the least significant bit, as VPI
+// does: 0 and 1 are held in aval with bval clear, Z is aval 0 and bval 1 and
+// X or any other value is aval 1 and bval 1. Returns the number of bits
+// packed, at most 32 * num_words, or -1 if the object has no vector value.
+int gpi_get_signal_value_words(gpi_sim_hdl gpi_hdl, uint32_t *aval, uint32_t *bval, int num_words);
 const char *gpi_get_signal_name_str(gpi_sim_hdl gpi_hdl);
+const char *gpi_get_signal_fullname_str(gpi_sim_hdl gpi_hdl);
 const char *gpi_get_signal_type_str(gpi_sim_hdl gpi_hdl);
 
 // Returns one of the types defined above e.g. gpiMemory etc.
@@ -217,6 +223,113 @@ void gpi_deregister_callback(gpi_sim_hdl gpi_hdl);
 // of GPI we provide a convenience function to extract the callback data
 void *gpi_get_callback_data(gpi_sim_hdl gpi_hdl);
 
+// Stream fixed-record stimulus files into the design from within the GPI.
+// One record is driven onto drive_hdls on each edge of clk_hdl and, if
+// expect_path is given, check_hdls are compared against the expected records.
+// Returns NULL if the files could not be opened or do not match the handles.
+gpi_sim_hdl gpi_stream_open(const char *stim_path,
+                            const char *expect_path,
+                            gpi_sim_hdl clk_hdl,
+                            unsigned int edge,
+                            gpi_sim_hdl *drive_hdls,
+                            int num_drive,
+                            gpi_sim_hdl *check_hdls,
+                            int num_check);
+
+typedef struct gpi_stream_status_s {
+    uint64_t records_driven;
+    uint64_t records_total;
+    uint64_t mismatches;        // Total number of mismatches seen
+    uint64_t dropped;           // Mismatches not kept as too many were pending
+    int32_t  done;
+} gpi_stream_status_t;
+
+typedef struct gpi_stream_mismatch_s {
+    uint64_t    record;
+    uint64_t    sim_time;
+    const char *name;
+    const char *expected;       // Valid until the next call for this stream
+    const char *actual;
+} gpi_stream_mismatch_t;
+
+// Call gpi_function once batch mismatches are pending (0 for never) or when
+// the stream has finished, the registration is removed once it has fired.
+// Registering again, deregistering and closing return the gpi_cb_data of a
+// registration they removed before it fired, NULL if there was none, for the
+// caller to free
+void *gpi_stream_register_callback(gpi_sim_hdl stream_hdl, int (*gpi_function)(const void *), void *gpi_cb_data, int batch);
+void *gpi_stream_deregister_callback(gpi_sim_hdl stream_hdl);
+void gpi_stream_get_status(gpi_sim_hdl stream_hdl, gpi_stream_status_t *status);
+
+// Returns 1 and fills in mismatch while there are pending mismatches, else 0
+int gpi_stream_next_mismatch(gpi_sim_hdl stream_hdl, gpi_stream_mismatch_t *mismatch);
+void *gpi_stream_close(gpi_sim_hdl stream_hdl);
+
+// Record every change of the given signals to a binary trace file at path.
+// Returns NULL on failure, the trace is completed by gpi_stop_recording or
+// when the simulator exits.
+gpi_sim_hdl gpi_start_recording(const char *path, gpi_sim_hdl *sig_hdls, int num_sigs);
+void gpi_stop_recording(gpi_sim_hdl recorder_hdl);
+
+// Number of C++ heap allocations made so far, or -1 if the GPI was not built
+// with COCOTB_ALLOC_COUNT=1
+long long gpi_get_alloc_count(void);
+
+typedef struct gpi_cb_counters_s {
+    uint64_t registered;        // Callbacks registered with the simulator
+    uint64_t removed;           // Callbacks removed from the simulator
+    uint64_t rearmed;           // Arms that kept a registration already in place
+} gpi_cb_counters_t;
+
+void gpi_get_cb_counters(gpi_cb_counters_t *counters);
+
+typedef struct gpi_cb_pool_stats_s {
+    uint32_t size;              // Object size served by the slab, 0 for larger objects
+    uint32_t chunks;            // Chunks of blocks the slab has grown to
+    uint64_t allocs;            // Callback handles allocated
+    uint64_t reused;            // Allocations served by a block freed earlier
+    uint64_t in_use;
+    uint64_t peak;
+    uint64_t overflow;          // Allocations that had to go to the heap
+} gpi_cb_pool_stats_t;
+
+// Fill in stats for up to max callback handle slabs that have been used,
+// returns how many there are
+int gpi_get_cb_pool_stats(gpi_cb_pool_stats_t *stats, int max);
+
+#define GPI_STATS_BUCKETS 16
+
+typedef struct gpi_call_stats_s {
+    const char *impl;           // Implementation the calls went to
+    const char *call;           // GPI entry point
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t hist[GPI_STATS_BUCKETS];   // Bucket 0 is under 64ns, each after covers twice the time
+} gpi_call_stats_t;
+
+// Fill in stats for the index'th entry point and implementation pair that
+// has been called. Returns 0 once index is past the last one, or always if
+// COCOTB_GPI_STATS was not set
+int gpi_get_call_stats(int index, gpi_call_stats_t *stats);
+
+// Start-up timeline, only recorded when COCOTB_STARTUP_PROFILE is set.
+// Phases nest, gpi_startup_end closes the one most recently begun
+void gpi_startup_begin(const char *phase);
+void gpi_startup_end(void);
+
+typedef struct gpi_startup_phase_s {
+    const char *name;
+    int depth;                  // Number of phases enclosing this one
+    int open;                   // Still running, end_ns is the time now
+    uint64_t start_ns;          // From the start of the process if known,
+    uint64_t end_ns;            // otherwise from the first phase
+} gpi_startup_phase_t;
+
+// Fill in the index'th phase in the order they began. Returns 0 once index
+// is past the last one, or always if COCOTB_STARTUP_PROFILE was not set
+int gpi_get_startup_phase(int index, gpi_startup_phase_t *phase);
+
 // Print out what implementations are registered. Python needs to be loaded for this,
 // Returns the number of libs
 int gpi_print_registered_impl(void);
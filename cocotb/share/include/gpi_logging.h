@@ -71,6 +71,9 @@ void set_make_record(void *makerecord);
 void set_log_filter(void *filter);
 void set_log_level(enum gpi_log_levels new_level);
 
+/* Emit any messages held back by COCOTB_GPI_LOG_BUFFER */
+void gpi_log_flush(void);
+
 void gpi_log(const char *name, long level, const char *pathname, const char *funcname, long lineno, const char *msg, ...);
 
 EXTERN_C_END
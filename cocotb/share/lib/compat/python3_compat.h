@@ -7,7 +7,9 @@ struct module_state {
 
 #if PY_MAJOR_VERSION >= 3
 #define PyInt_FromLong PyLong_FromLong
+#define PyInt_Check PyLong_Check
 #define PyString_FromString PyUnicode_FromString
+#define PyString_FromFormat PyUnicode_FromFormat
 
 #define GETSTATE(m) ((struct module_state*)PyModule_GetState(m))
 #define MODULE_ENTRY_POINT PyInit_simulator
@@ -17,6 +19,7 @@ struct module_state {
 #define GETSTATE(m) (&_state)
 #define MODULE_ENTRY_POINT initsimulator
 #define INITERROR return
+typedef long Py_hash_t;
 #endif
 
 #endif
@@ -38,6 +38,8 @@
 #if defined(_WIN32)
 #include <windows.h>
 #define sleep(n) Sleep(1000 * n)
+#else
+#include <pthread.h>
 #endif
 static PyThreadState *gtstate = NULL;
 
@@ -51,6 +53,18 @@ static char *argv[] = { progname };
 
 static PyObject *pEventFn = NULL;
 
+#if !defined(_WIN32)
+/* Tests may be run in processes forked from the simulator (see
+ * COCOTB_FORK_TESTS), so anything buffered so far is written out before
+ * a fork rather than being written again by every child.
+ */
+static void embed_before_fork(void)
+{
+    gpi_log_flush();
+    fflush(NULL);
+}
+#endif
+
 /**
  * @name    Initialise the python interpreter
  * @brief   Create and initialise the python interpreter
@@ -115,6 +129,10 @@ void embed_init_python(void)
     PySys_SetArgvEx(1, argv, 0);
     PyEval_InitThreads();               /* Create (and acquire) the interpreter lock */
 
+#if !defined(_WIN32)
+    pthread_atfork(embed_before_fork, NULL, NULL);
+#endif
+
     /* Swap out and return current thread state and release the GIL */
     gtstate = PyEval_SaveThread();
     to_simulator();
@@ -362,6 +380,8 @@ void embed_sim_event(gpi_event_t level, const char *msg)
     FENTER
     /* Indicate to the upper layer a sim event occoured */
 
+    gpi_log_flush();
+
     if (pEventFn) {
         PyGILState_STATE gstate;
         to_python();
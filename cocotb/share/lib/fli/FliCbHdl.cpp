@@ -40,6 +40,7 @@ int FliProcessCbHdl::cleanup_callback(void)
 {
     if (m_sensitised) {
         mti_Desensitize(m_proc_hdl);
+        GpiCbHdl::counters.removed++;
     }
     m_sensitised = false;
     return 0;
@@ -62,6 +63,7 @@ int FliTimedCbHdl::arm_callback(void)
         MTI_TIME64_ASGN(m_time_union_ps, (mtiInt32T)((m_time_ps) >> 32), (mtiUInt32T)(m_time_ps));
         mti_ScheduleWakeup64(m_proc_hdl, m_time_union_ps);
     #endif
+    GpiCbHdl::counters.registered++;
     m_sensitised = true;
     set_call_state(GPI_PRIMED);
     return 0;
@@ -102,7 +104,10 @@ int FliSignalCbHdl::arm_callback(void)
 
     if (!m_sensitised) {
         mti_Sensitize(m_proc_hdl, m_sig_hdl, MTI_EVENT);
+        GpiCbHdl::counters.registered++;
         m_sensitised = true;
+    } else {
+        GpiCbHdl::counters.rearmed++;
     }
     set_call_state(GPI_PRIMED);
     return 0;
@@ -117,7 +122,10 @@ int FliSimPhaseCbHdl::arm_callback(void)
 
     if (!m_sensitised) {
         mti_ScheduleWakeup(m_proc_hdl, 0);
+        GpiCbHdl::counters.registered++;
         m_sensitised = true;
+    } else {
+        GpiCbHdl::counters.rearmed++;
     }
     set_call_state(GPI_PRIMED);
     return 0;
@@ -135,6 +143,7 @@ FliSignalCbHdl::FliSignalCbHdl(GpiImplInterface *impl,
 int FliStartupCbHdl::arm_callback(void)
 {
     mti_AddLoadDoneCB(handle_fli_callback,(void *)this);
+    GpiCbHdl::counters.registered++;
     set_call_state(GPI_PRIMED);
 
     return 0;
@@ -181,6 +190,7 @@ int FliStartupCbHdl::run_callback(void)
 int FliShutdownCbHdl::arm_callback(void)
 {
     mti_AddQuitCB(handle_fli_callback,(void *)this);
+    GpiCbHdl::counters.registered++;
     set_call_state(GPI_PRIMED);
 
     return 0;
@@ -608,11 +608,16 @@ void fli_mappings(GpiIteratorMapping<int, FliIterator::OneToMany> &map)
 
 GpiIteratorMapping<int, FliIterator::OneToMany> FliIterator::iterate_over(fli_mappings);
 
+FliIterator *FliIterator::s_signal_cursor = NULL;
+FliIterator *FliIterator::s_var_cursor = NULL;
+
 FliIterator::FliIterator(GpiImplInterface *impl, GpiObjHdl *hdl) : GpiIterator(impl, hdl),
-                                                                   m_vars(),
-                                                                   m_sigs(),
-                                                                   m_regs(),
-                                                                   m_currentHandles(NULL)
+                                                                   m_position(0),
+                                                                   m_last(NULL),
+                                                                   m_sub_hdls(NULL),
+                                                                   m_num_sub(0),
+                                                                   m_cached(NULL),
+                                                                   m_seen()
 {
     FliObj *fli_obj = dynamic_cast<FliObj *>(m_parent);
     int     type    = fli_obj->get_acc_full_type();
@@ -625,50 +630,182 @@ FliIterator::FliIterator(GpiImplInterface *impl, GpiObjHdl *hdl) : GpiIterator(i
         return;
     }
 
-    /* Find the first mapping type that yields a valid iterator */
-    for (one2many = selected->begin(); one2many != selected->end(); one2many++) {
+    /* Children are fetched as they are asked for, nothing is read here */
+    if (!start_children(selected->begin())) {
+        LOG_DEBUG("fli_iterator has no relationships to follow on %s (%d) kind:%s",
+                  m_parent->get_name_str(), type, acc_fetch_type_str(type));
+        selected = NULL;
+        return;
+    }
+
+    LOG_DEBUG("Created iterator working from scope %d",
+              *one2many);
+}
+
+FliIterator::~FliIterator()
+{
+    end_children();
+
+    if (s_signal_cursor == this)
+        s_signal_cursor = NULL;
+    if (s_var_cursor == this)
+        s_var_cursor = NULL;
+}
+
+/* Moves on to the first kind of child, at or after from, that applies to the
+ * parent and gets ready to fetch them
+ */
+bool FliIterator::start_children(std::vector<OneToMany>::iterator from)
+{
+    for (one2many = from; one2many != selected->end(); one2many++) {
         /* GPI_GENARRAY are pseudo-regions and all that should be searched for are the sub-regions */
         if (m_parent->get_type() == GPI_GENARRAY && *one2many != FliIterator::OTM_REGIONS) {
             LOG_DEBUG("fli_iterator OneToMany=%d skipped for GPI_GENARRAY type", *one2many);
             continue;
         }
 
-        populate_handle_list(*one2many);
+        end_children();
 
         switch (*one2many) {
             case FliIterator::OTM_CONSTANTS:
-            case FliIterator::OTM_VARIABLE_SUB_ELEMENTS:
-                m_currentHandles = &m_vars;
-                m_iterator = m_vars.begin();
-                break;
             case FliIterator::OTM_SIGNALS:
+            case FliIterator::OTM_REGIONS: {
+                    FliObjHdl *region = dynamic_cast<FliObjHdl *>(m_parent);
+
+                    if (region)
+                        m_cached = region->get_cached_children(*one2many);
+                }
+                break;
             case FliIterator::OTM_SIGNAL_SUB_ELEMENTS:
-                m_currentHandles = &m_sigs;
-                m_iterator = m_sigs.begin();
+                if (m_parent->get_type() == GPI_STRUCTURE) {
+                    mtiSignalIdT parent = m_parent->get_handle<mtiSignalIdT>();
+
+                    m_num_sub  = mti_TickLength(mti_GetSignalType(parent));
+                    m_sub_hdls = (void **)mti_GetSignalSubelements(parent, NULL);
+                    LOG_DEBUG("GPI_STRUCTURE: %d fields", m_num_sub);
+                }
                 break;
-            case FliIterator::OTM_REGIONS:
-                m_currentHandles = &m_regs;
-                m_iterator = m_regs.begin();
+            case FliIterator::OTM_VARIABLE_SUB_ELEMENTS:
+                if (m_parent->get_type() == GPI_STRUCTURE) {
+                    mtiVariableIdT parent = m_parent->get_handle<mtiVariableIdT>();
+
+                    m_num_sub  = mti_TickLength(mti_GetVarType(parent));
+                    m_sub_hdls = (void **)mti_GetVarSubelements(parent, NULL);
+                    LOG_DEBUG("GPI_STRUCTURE: %d fields", m_num_sub);
+                }
                 break;
             default:
                 LOG_WARN("Unhandled OneToMany Type (%d)", *one2many);
         }
 
-        if (m_iterator != m_currentHandles->end())
+        return true;
+    }
+
+    return false;
+}
+
+void FliIterator::end_children(void)
+{
+    if (m_sub_hdls)
+        mti_VsimFree(m_sub_hdls);
+
+    m_position = 0;
+    m_last     = NULL;
+    m_sub_hdls = NULL;
+    m_num_sub  = 0;
+    m_cached   = NULL;
+    m_seen.clear();
+}
+
+/* Fetches the next child of the current kind, or NULL once there are no more */
+void *FliIterator::next_child(void)
+{
+    void *obj = NULL;
+
+    if (m_cached) {
+        if (m_position < m_cached->size())
+            obj = (*m_cached)[m_position++];
+        return obj;
+    }
+
+    switch (*one2many) {
+        case FliIterator::OTM_CONSTANTS: {
+                mtiRegionIdT parent = m_parent->get_handle<mtiRegionIdT>();
+
+                /* Wind the cursor forward again if another iterator used it */
+                if (m_position == 0 || s_var_cursor != this) {
+                    obj = mti_FirstVarByRegion(parent);
+                    for (size_t i = 0; obj && i < m_position; i++)
+                        obj = mti_NextVar();
+                } else {
+                    obj = mti_NextVar();
+                }
+                s_var_cursor = this;
+            }
+            break;
+        case FliIterator::OTM_SIGNALS: {
+                mtiRegionIdT parent = m_parent->get_handle<mtiRegionIdT>();
+
+                if (m_position == 0 || s_signal_cursor != this) {
+                    obj = mti_FirstSignal(parent);
+                    for (size_t i = 0; obj && i < m_position; i++)
+                        obj = mti_NextSignal();
+                } else {
+                    obj = mti_NextSignal();
+                }
+                s_signal_cursor = this;
+            }
             break;
+        case FliIterator::OTM_REGIONS:
+            if (m_position == 0) {
+                obj = mti_FirstLowerRegion(m_parent->get_handle<mtiRegionIdT>());
+            } else if (m_last) {
+                obj = mti_NextRegion(static_cast<mtiRegionIdT>(m_last));
+            }
+            m_last = obj;
+            break;
+        case FliIterator::OTM_SIGNAL_SUB_ELEMENTS:
+        case FliIterator::OTM_VARIABLE_SUB_ELEMENTS:
+            if (m_sub_hdls) {
+                if ((int)m_position < m_num_sub)
+                    obj = m_sub_hdls[m_position];
+            } else if (m_parent->get_indexable()) {
+                FliValueObjHdl *fli_obj = reinterpret_cast<FliValueObjHdl *>(m_parent);
+
+                int left  = m_parent->get_range_left();
+                int right = m_parent->get_range_right();
+                int index = (left > right) ? left - (int)m_position : left + (int)m_position;
 
-        LOG_DEBUG("fli_iterator OneToMany=%d returned NULL", *one2many);
+                if ((left > right) ? index >= right : index <= right)
+                    obj = fli_obj->get_sub_hdl(index);
+            }
+            break;
+        default:
+            LOG_WARN("Unhandled OneToMany Type (%d)", *one2many);
     }
 
-    if (m_iterator == m_currentHandles->end()) {
-        LOG_DEBUG("fli_iterator return NULL for all relationships on %s (%d) kind:%s", 
-                  m_parent->get_name_str(), type, acc_fetch_type_str(type));
-        selected = NULL;
-        return;
+    if (obj) {
+        m_position++;
+
+        if (*one2many == FliIterator::OTM_CONSTANTS ||
+            *one2many == FliIterator::OTM_SIGNALS ||
+            *one2many == FliIterator::OTM_REGIONS) {
+            m_seen.push_back(obj);
+        }
+    } else {
+        FliObjHdl *region = dynamic_cast<FliObjHdl *>(m_parent);
+
+        /* All seen, so later iterators can use the list instead */
+        if (region && (*one2many == FliIterator::OTM_CONSTANTS ||
+                       *one2many == FliIterator::OTM_SIGNALS ||
+                       *one2many == FliIterator::OTM_REGIONS)) {
+            region->cache_children(*one2many, m_seen);
+            m_cached   = region->get_cached_children(*one2many);
+            m_position = m_cached->size();
+        }
     }
 
-    LOG_DEBUG("Created iterator working from scope %d", 
-              *one2many);
+    return obj;
 }
 
 GpiIterator::Status FliIterator::next_handle(std::string &name, GpiObjHdl **hdl, void **raw_hdl)
@@ -686,65 +823,33 @@ GpiIterator::Status FliIterator::next_handle(std::string &name, GpiObjHdl **hdl,
      * If the end of mapping is reached then we want to
      * try next one until a new object is found
      */
-    do {
-        obj = NULL;
-
-        if (m_iterator != m_currentHandles->end()) {
-            obj = *m_iterator++;
-
-            /* For GPI_GENARRAY, only allow the generate statements through that match the name
-             * of the generate block.
-             */
-            if (obj_type == GPI_GENARRAY) {
-                if (acc_fetch_fulltype(obj) == accForGenerate) {
-                    std::string rgn_name = mti_GetRegionName(static_cast<mtiRegionIdT>(obj));
-                    if (rgn_name.compare(0,parent_name.length(),parent_name) != 0) {
-                        obj = NULL;
-                        continue;
-                    }
-                } else {
-                    obj = NULL;
-                    continue;
-                }
-            }
+    for (;;) {
+        obj = static_cast<HANDLE>(next_child());
 
-            break;
-        } else {
+        if (NULL == obj) {
             LOG_DEBUG("No more valid handles in the current OneToMany=%d iterator", *one2many);
-        }
 
-        if (++one2many >= selected->end()) {
-            obj = NULL;
-            break;
-        }
-
-        /* GPI_GENARRAY are pseudo-regions and all that should be searched for are the sub-regions */
-        if (obj_type == GPI_GENARRAY && *one2many != FliIterator::OTM_REGIONS) {
-            LOG_DEBUG("fli_iterator OneToMany=%d skipped for GPI_GENARRAY type", *one2many);
+            if (!start_children(one2many + 1)) {
+                selected = NULL;
+                break;
+            }
             continue;
         }
 
-        populate_handle_list(*one2many);
+        /* For GPI_GENARRAY, only allow the generate statements through that match the name
+         * of the generate block.
+         */
+        if (obj_type == GPI_GENARRAY) {
+            if (acc_fetch_fulltype(obj) != accForGenerate)
+                continue;
 
-        switch (*one2many) {
-            case FliIterator::OTM_CONSTANTS:
-            case FliIterator::OTM_VARIABLE_SUB_ELEMENTS:
-                m_currentHandles = &m_vars;
-                m_iterator = m_vars.begin();
-                break;
-            case FliIterator::OTM_SIGNALS:
-            case FliIterator::OTM_SIGNAL_SUB_ELEMENTS:
-                m_currentHandles = &m_sigs;
-                m_iterator = m_sigs.begin();
-                break;
-            case FliIterator::OTM_REGIONS:
-                m_currentHandles = &m_regs;
-                m_iterator = m_regs.begin();
-                break;
-            default:
-                LOG_WARN("Unhandled OneToMany Type (%d)", *one2many);
+            std::string rgn_name = mti_GetRegionName(static_cast<mtiRegionIdT>(obj));
+            if (rgn_name.compare(0,parent_name.length(),parent_name) != 0)
+                continue;
         }
-    } while (!obj);
+
+        break;
+    }
 
     if (NULL == obj) {
         LOG_DEBUG("No more children, all relationships tested");
@@ -855,107 +960,6 @@ GpiIterator::Status FliIterator::next_handle(std::string &name, GpiObjHdl **hdl,
     }
 }
 
-void FliIterator::populate_handle_list(FliIterator::OneToMany childType)
-{
-    switch (childType) {
-        case FliIterator::OTM_CONSTANTS: {
-                mtiRegionIdT parent = m_parent->get_handle<mtiRegionIdT>();
-                mtiVariableIdT id;
-
-                for (id = mti_FirstVarByRegion(parent); id; id = mti_NextVar()) {
-                    if (id) {
-                        m_vars.push_back(id);
-                    }
-                }
-            }
-            break;
-        case FliIterator::OTM_SIGNALS: {
-                mtiRegionIdT parent = m_parent->get_handle<mtiRegionIdT>();
-                mtiSignalIdT id;
-
-                for (id = mti_FirstSignal(parent); id; id = mti_NextSignal()) {
-                    if (id) {
-                        m_sigs.push_back(id);
-                    }
-                }
-            }
-            break;
-        case FliIterator::OTM_REGIONS: {
-                mtiRegionIdT parent = m_parent->get_handle<mtiRegionIdT>();
-                mtiRegionIdT id;
-
-                for (id = mti_FirstLowerRegion(parent); id; id = mti_NextRegion(id)) {
-                    if (id) {
-                        m_regs.push_back(id);
-                    }
-                }
-            }
-            break;
-        case FliIterator::OTM_SIGNAL_SUB_ELEMENTS:
-            if (m_parent->get_type() == GPI_STRUCTURE) {
-                mtiSignalIdT parent = m_parent->get_handle<mtiSignalIdT>();
-
-                mtiTypeIdT type = mti_GetSignalType(parent);
-                mtiSignalIdT *ids = mti_GetSignalSubelements(parent,NULL);
-
-                LOG_DEBUG("GPI_STRUCTURE: %d fields", mti_TickLength(type));
-                for (int i = 0; i < mti_TickLength(type); i++) {
-                    m_sigs.push_back(ids[i]);
-                }
-                mti_VsimFree(ids);
-            } else if (m_parent->get_indexable()) {
-                FliValueObjHdl *fli_obj = reinterpret_cast<FliValueObjHdl *>(m_parent);
-
-                int left  = m_parent->get_range_left();
-                int right = m_parent->get_range_right();
-
-                if (left > right) {
-                    for (int i = left; i >= right; i--) {
-                        m_sigs.push_back(static_cast<mtiSignalIdT>(fli_obj->get_sub_hdl(i)));
-                    }
-                } else {
-                    for (int i = left; i <= right; i++) {
-                        m_sigs.push_back(static_cast<mtiSignalIdT>(fli_obj->get_sub_hdl(i)));
-                    }
-                }
-            }
-            break;
-        case FliIterator::OTM_VARIABLE_SUB_ELEMENTS:
-            if (m_parent->get_type() == GPI_STRUCTURE) {
-                mtiVariableIdT parent = m_parent->get_handle<mtiVariableIdT>();
-
-                mtiTypeIdT type = mti_GetVarType(parent);
-                mtiVariableIdT *ids = mti_GetVarSubelements(parent,NULL);
-
-                LOG_DEBUG("GPI_STRUCTURE: %d fields", mti_TickLength(type));
-                for (int i = 0; i < mti_TickLength(type); i++) {
-                    m_vars.push_back(ids[i]);
-                }
-
-                mti_VsimFree(ids);
-            } else if (m_parent->get_indexable()) {
-                FliValueObjHdl *fli_obj = reinterpret_cast<FliValueObjHdl *>(m_parent);
-
-                int left  = m_parent->get_range_left();
-                int right = m_parent->get_range_right();
-
-                if (left > right) {
-                    for (int i = left; i >= right; i--) {
-                        m_vars.push_back(static_cast<mtiVariableIdT>(fli_obj->get_sub_hdl(i)));
-                    }
-                } else {
-                    for (int i = left; i <= right; i++) {
-                        m_vars.push_back(static_cast<mtiVariableIdT>(fli_obj->get_sub_hdl(i)));
-                    }
-                }
-            }
-            break;
-        default:
-            LOG_WARN("Unhandled OneToMany Type (%d)", childType);
-    }
-}
-
-
 FliTimedCbHdl* FliTimerCache::get_timer(uint64_t time_ps)
 {
     FliTimedCbHdl *hdl;
@@ -987,6 +991,8 @@ void handle_fli_callback(void *data)
 
     if (!cb_hdl) {
         LOG_CRITICAL("FLI: Callback data corrupted: ABORTING");
+    } else {
+        gpi_fr_record_fired(cb_hdl, GPI_FR_TIME_UNKNOWN);
     }
 
     gpi_cb_state_e old_state = cb_hdl->get_call_state();
@@ -1026,9 +1032,11 @@ static void register_final_callback(void)
 
 static void register_embed(void)
 {
+    gpi_startup_begin("register_embed FLI");
     fli_table = new FliImpl("FLI");
     gpi_register_impl(fli_table);
     gpi_load_extra_libs();
+    gpi_startup_end();
 }
 
 
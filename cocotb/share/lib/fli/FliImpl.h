@@ -33,6 +33,7 @@
 
 #include <queue>
 #include <map>
+#include <string.h>
 
 extern "C" {
 void cocotb_init(void);
@@ -192,6 +193,15 @@ public:
     virtual ~FliObjHdl() { }
 
     virtual int initialise(std::string &name, std::string &fq_name);
+
+    /* Children of one kind, kept once an iterator has been through all of
+     * them so that later iterations do not go back to the simulator
+     */
+    std::vector<void *> *get_cached_children(int one2many);
+    void cache_children(int one2many, std::vector<void *> &children);
+
+private:
+    std::map<int, std::vector<void *> > m_children;
 };
 
 class FliSignalObjHdl : public GpiSignalObjHdl, public FliObj {
@@ -213,6 +223,7 @@ public:
     virtual ~FliSignalObjHdl() { }
 
     virtual GpiCbHdl *value_change_cb(unsigned int edge);
+    virtual GpiCbHdl *new_value_change_cb(unsigned int edge);
     virtual int initialise(std::string &name, std::string &fq_name);
 
     bool is_var(void) { return m_is_var; }
@@ -300,6 +311,27 @@ private:
     mtiInt32T          m_num_enum;
 };
 
+/* Translates bytes through a flat table, such as enum values of std_logic
+ * to and from their characters. Where SSE2 is available runs of 16 bytes
+ * made up of only the two common keys, '0' and '1' say, are translated at
+ * once.
+ */
+class FliByteMap {
+public:
+    FliByteMap() { set_default(0); set_common(0, 0); }
+
+    void set_default(char value) { memset(m_table, value, sizeof(m_table)); }
+    void set_common(char key_a, char key_b) { m_common[0] = key_a; m_common[1] = key_b; }
+    void add(char key, char value) { m_table[(unsigned char)key] = value; }
+
+    char operator[](char key) const { return m_table[(unsigned char)key]; }
+    void translate(char *dst, const char *src, int len) const;
+
+private:
+    char m_table[256];
+    char m_common[2];
+};
+
 class FliLogicObjHdl : public FliValueObjHdl {
 public:
     FliLogicObjHdl(GpiImplInterface *impl,
@@ -322,8 +354,7 @@ public:
                                       typeKind),
                        m_mti_buff(NULL),
                        m_value_enum(NULL),
-                       m_num_enum(0),
-                       m_enum_map() { }
+                       m_num_enum(0) { }
 
     virtual ~FliLogicObjHdl() {
         if (m_mti_buff != NULL)
@@ -331,6 +362,8 @@ public:
     }
 
     const char* get_signal_value_binstr(void);
+    long get_signal_value_long(void);
+    int get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words);
 
     int set_signal_value(const long value);
     int set_signal_value(std::string &value);
@@ -342,7 +375,10 @@ private:
     char                      *m_mti_buff;
     char                     **m_value_enum;    // Do Not Free
     mtiInt32T                  m_num_enum;
-    std::map<char,mtiInt32T>   m_enum_map;
+    FliByteMap                 m_char_to_enum;
+    FliByteMap                 m_enum_to_char;
+    FliByteMap                 m_enum_to_bits;  // aval | bval << 1 as in gpi_get_signal_value_words
+    char                       m_bit_to_enum[2];
 };
 
 class FliIntObjHdl : public FliValueObjHdl {
@@ -452,23 +488,32 @@ public:
 
     FliIterator(GpiImplInterface *impl, GpiObjHdl *hdl);
 
-    virtual ~FliIterator() { };
+    virtual ~FliIterator();
 
     Status next_handle(std::string &name, GpiObjHdl **hdl, void **raw_hdl);
 
 private:
-    void populate_handle_list(OneToMany childType);
+    bool start_children(std::vector<OneToMany>::iterator from);
+    void end_children(void);
+    void *next_child(void);
 
 private:
     static GpiIteratorMapping<int, OneToMany> iterate_over;      /* Possible mappings */
     std::vector<OneToMany> *selected;                            /* Mapping currently in use */
     std::vector<OneToMany>::iterator one2many;
 
-    std::vector<void *> m_vars;
-    std::vector<void *> m_sigs;
-    std::vector<void *> m_regs;
-    std::vector<void *> *m_currentHandles;
-    std::vector<void *>::iterator m_iterator;
+    /* The simulator has a single cursor each for signals and variables,
+     * these record which iterator last moved them
+     */
+    static FliIterator *s_signal_cursor;
+    static FliIterator *s_var_cursor;
+
+    size_t               m_position;    /* Children of the current kind so far */
+    void                *m_last;        /* Last region, to find the next one */
+    void               **m_sub_hdls;    /* Fields of a record */
+    int                  m_num_sub;
+    std::vector<void *> *m_cached;      /* Children kept by the parent region */
+    std::vector<void *>  m_seen;        /* Children to keep once all are seen */
 };
 
 class FliImpl : public GpiImplInterface {
@@ -31,6 +31,10 @@
 #include "FliImpl.h"
 #include "acc_vhdl.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 GpiCbHdl *FliSignalObjHdl::value_change_cb(unsigned int edge)
 {
     FliSignalCbHdl *cb = NULL;
@@ -60,6 +64,22 @@ GpiCbHdl *FliSignalObjHdl::value_change_cb(unsigned int edge)
     return (GpiCbHdl *)cb;
 }
 
+GpiCbHdl *FliSignalObjHdl::new_value_change_cb(unsigned int edge)
+{
+    if (m_is_var || edge < 1 || edge > 3) {
+        return NULL;
+    }
+
+    FliSignalCbHdl *cb = new FliSignalCbHdl(m_impl, this, edge);
+
+    if (cb->arm_callback()) {
+        delete cb;
+        return NULL;
+    }
+
+    return (GpiCbHdl *)cb;
+}
+
 int FliObjHdl::initialise(std::string &name, std::string &fq_name)
 {
     bool is_signal = (get_acc_type() == accSignal || get_acc_full_type() == accAliasSignal);
@@ -97,6 +117,21 @@ int FliObjHdl::initialise(std::string &name, std::string &fq_name)
     return GpiObjHdl::initialise(name, fq_name);
 }
 
+std::vector<void *> *FliObjHdl::get_cached_children(int one2many)
+{
+    std::map<int, std::vector<void *> >::iterator it = m_children.find(one2many);
+
+    if (it == m_children.end())
+        return NULL;
+
+    return &it->second;
+}
+
+void FliObjHdl::cache_children(int one2many, std::vector<void *> &children)
+{
+    m_children[one2many].swap(children);
+}
+
 
 int FliSignalObjHdl::initialise(std::string &name, std::string &fq_name)
 {
@@ -226,6 +261,37 @@ int FliEnumObjHdl::set_signal_value(const long value)
     return 0;
 }
 
+void FliByteMap::translate(char *dst, const char *src, int len) const
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i key_a   = _mm_set1_epi8(m_common[0]);
+    const __m128i key_b   = _mm_set1_epi8(m_common[1]);
+    const __m128i value_a = _mm_set1_epi8((*this)[m_common[0]]);
+    const __m128i value_b = _mm_set1_epi8((*this)[m_common[1]]);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i is_a = _mm_cmpeq_epi8(in, key_a);
+        __m128i is_b = _mm_cmpeq_epi8(in, key_b);
+
+        if (_mm_movemask_epi8(_mm_or_si128(is_a, is_b)) != 0xffff) {
+            for (int j = i; j < i + 16; j++)
+                dst[j] = m_table[(unsigned char)src[j]];
+            continue;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_or_si128(_mm_and_si128(is_a, value_a),
+                                      _mm_and_si128(is_b, value_b)));
+    }
+#endif
+
+    for (; i < len; i++)
+        dst[i] = m_table[(unsigned char)src[i]];
+}
+
 int FliLogicObjHdl::initialise(std::string &name, std::string &fq_name)
 {
     switch (m_fli_type) {
@@ -257,8 +323,29 @@ int FliLogicObjHdl::initialise(std::string &name, std::string &fq_name)
             return -1;
     }
 
+    /* Unknown characters are written as the first enum value, as before */
+    m_char_to_enum.set_default(0);
+    m_enum_to_char.set_default('X');
+
     for (mtiInt32T i = 0; i < m_num_enum; i++) {
-        m_enum_map[m_value_enum[i][1]] = i;  // enum is of the format 'U' or '0', etc.
+        m_char_to_enum.add(m_value_enum[i][1], (char)i);  // enum is of the format 'U' or '0', etc.
+        m_enum_to_char.add((char)i, m_value_enum[i][1]);
+    }
+
+    m_bit_to_enum[0] = m_char_to_enum['0'];
+    m_bit_to_enum[1] = m_char_to_enum['1'];
+
+    m_char_to_enum.set_common('0', '1');
+    m_enum_to_char.set_common(m_bit_to_enum[0], m_bit_to_enum[1]);
+
+    m_enum_to_bits.set_default(3);
+    for (mtiInt32T i = 0; i < m_num_enum; i++) {
+        switch (m_value_enum[i][1]) {
+            case '0': case 'L': m_enum_to_bits.add((char)i, 0); break;
+            case '1': case 'H': m_enum_to_bits.add((char)i, 1); break;
+            case 'Z':           m_enum_to_bits.add((char)i, 2); break;
+            default:            break;
+        }
     }
 
     m_val_buff = (char*)malloc(m_num_elems+1);
@@ -287,9 +374,7 @@ const char* FliLogicObjHdl::get_signal_value_binstr(void)
                     mti_GetArraySignalValue(get_handle<mtiSignalIdT>(), m_mti_buff);
                 }
 
-                for (int i = 0; i < m_num_elems; i++ ) {
-                    m_val_buff[i] = m_value_enum[(int)m_mti_buff[i]][1];
-                }
+                m_enum_to_char.translate(m_val_buff, m_mti_buff, m_num_elems);
             }
             break;
         default:
@@ -302,10 +387,79 @@ const char* FliLogicObjHdl::get_signal_value_binstr(void)
     return m_val_buff;
 }
 
+long FliLogicObjHdl::get_signal_value_long(void)
+{
+    unsigned long value = 0;
+
+    if (m_fli_type == MTI_TYPE_ENUM) {
+        mtiInt32T enumVal;
+
+        if (m_is_var) {
+            enumVal = mti_GetVarValue(get_handle<mtiVariableIdT>());
+        } else {
+            enumVal = mti_GetSignalValue(get_handle<mtiSignalIdT>());
+        }
+
+        return enumVal == m_bit_to_enum[1];
+    }
+
+    if (m_is_var) {
+        mti_GetArrayVarValue(get_handle<mtiVariableIdT>(), m_mti_buff);
+    } else {
+        mti_GetArraySignalValue(get_handle<mtiSignalIdT>(), m_mti_buff);
+    }
+
+    /* Pack the least significant bits, anything but '1' reads as 0 */
+    int bits = m_num_elems < (int)(sizeof(value) * 8) ? m_num_elems : (int)(sizeof(value) * 8);
+
+    for (int i = 0, idx = m_num_elems-1; i < bits; i++, idx--) {
+        value |= (unsigned long)(m_mti_buff[idx] == m_bit_to_enum[1]) << i;
+    }
+
+    return (long)value;
+}
+
+/* Packed straight from the enum values, without the binary string */
+int FliLogicObjHdl::get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words)
+{
+    const char *values;
+    char scalar;
+
+    if (m_fli_type == MTI_TYPE_ENUM) {
+        if (m_is_var) {
+            scalar = (char)mti_GetVarValue(get_handle<mtiVariableIdT>());
+        } else {
+            scalar = (char)mti_GetSignalValue(get_handle<mtiSignalIdT>());
+        }
+        values = &scalar;
+    } else {
+        if (m_is_var) {
+            mti_GetArrayVarValue(get_handle<mtiVariableIdT>(), m_mti_buff);
+        } else {
+            mti_GetArraySignalValue(get_handle<mtiSignalIdT>(), m_mti_buff);
+        }
+        values = m_mti_buff;
+    }
+
+    int bits = m_num_elems < num_words * 32 ? m_num_elems : num_words * 32;
+
+    memset(aval, 0, sizeof(*aval) * num_words);
+    memset(bval, 0, sizeof(*bval) * num_words);
+
+    for (int bit = 0; bit < bits; bit++) {
+        uint32_t plane = (uint32_t)m_enum_to_bits[values[m_num_elems - bit - 1]];
+
+        aval[bit / 32] |= (plane & 1) << (bit % 32);
+        bval[bit / 32] |= (plane >> 1) << (bit % 32);
+    }
+
+    return bits;
+}
+
 int FliLogicObjHdl::set_signal_value(const long value)
 {
     if (m_fli_type == MTI_TYPE_ENUM) {
-        mtiInt32T enumVal = value ? m_enum_map['1'] : m_enum_map['0'];
+        mtiInt32T enumVal = m_bit_to_enum[value ? 1 : 0];
 
         if (m_is_var) {
             mti_SetVarValue(get_handle<mtiVariableIdT>(), enumVal);
@@ -314,12 +468,16 @@ int FliLogicObjHdl::set_signal_value(const long value)
         }
     } else {
         LOG_DEBUG("set_signal_value(long)::0x%016x", value);
-        for (int i = 0, idx = m_num_elems-1; i < m_num_elems; i++, idx--) {
-            mtiInt32T enumVal = value&(1L<<i) ? m_enum_map['1'] : m_enum_map['0'];
+        /* Bits beyond the width of a long are driven as 0 */
+        int bits = m_num_elems < (int)(sizeof(value) * 8) ? m_num_elems : (int)(sizeof(value) * 8);
+        int i, idx;
 
-            m_mti_buff[idx] = (char)enumVal; 
+        for (i = 0, idx = m_num_elems-1; i < bits; i++, idx--) {
+            m_mti_buff[idx] = m_bit_to_enum[((unsigned long)value >> i) & 1];
         }
 
+        memset(m_mti_buff, m_bit_to_enum[0], m_num_elems - bits);
+
         if (m_is_var) {
             mti_SetVarValue(get_handle<mtiVariableIdT>(), (mtiLongT)m_mti_buff);
         } else {
@@ -333,7 +491,7 @@ int FliLogicObjHdl::set_signal_value(const long value)
 int FliLogicObjHdl::set_signal_value(std::string &value)
 {
     if (m_fli_type == MTI_TYPE_ENUM) {
-        mtiInt32T enumVal = m_enum_map[value.c_str()[0]];
+        mtiInt32T enumVal = m_char_to_enum[value.c_str()[0]];
 
         if (m_is_var) {
             mti_SetVarValue(get_handle<mtiVariableIdT>(), enumVal);
@@ -349,14 +507,7 @@ int FliLogicObjHdl::set_signal_value(std::string &value)
 
         LOG_DEBUG("set_signal_value(string)::%s", value.c_str());
 
-        mtiInt32T enumVal;
-        std::string::iterator valIter;
-        int i = 0;
-
-        for (valIter = value.begin(); (valIter != value.end()) && (i < m_num_elems); valIter++, i++) {
-            enumVal = m_enum_map[*valIter];
-            m_mti_buff[i] = (char)enumVal; 
-        }
+        m_char_to_enum.translate(m_mti_buff, value.c_str(), m_num_elems);
 
         if (m_is_var) {
             mti_SetVarValue(get_handle<mtiVariableIdT>(), (mtiLongT)m_mti_buff);
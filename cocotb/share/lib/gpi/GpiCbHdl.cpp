@@ -121,6 +121,41 @@ int GpiObjHdl::initialise(std::string &name, std::string &fq_name)
     return 0;
 }
 
+int GpiSignalObjHdl::set_signal_value_str(const char *value)
+{
+    std::string str = value;
+    return set_signal_value(str);
+}
+
+int GpiSignalObjHdl::get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words)
+{
+    const char *binstr = get_signal_value_binstr();
+    if (!binstr)
+        return -1;
+
+    int len = (int)strlen(binstr);
+    int bits = len < num_words * 32 ? len : num_words * 32;
+
+    memset(aval, 0, sizeof(*aval) * num_words);
+    memset(bval, 0, sizeof(*bval) * num_words);
+
+    for (int bit = 0; bit < bits; bit++) {
+        uint32_t a, b;
+
+        switch (binstr[len - bit - 1]) {
+            case '0': case 'L': case 'l': a = 0; b = 0; break;
+            case '1': case 'H': case 'h': a = 1; b = 0; break;
+            case 'Z': case 'z':           a = 0; b = 1; break;
+            default:                      a = 1; b = 1; break;
+        }
+
+        aval[bit / 32] |= a << (bit % 32);
+        bval[bit / 32] |= b << (bit % 32);
+    }
+
+    return bits;
+}
+
 int GpiCbHdl::run_callback(void)
 {
     LOG_DEBUG("Generic run_callback");
@@ -156,6 +191,13 @@ const void * GpiCbHdl::get_user_data(void)
     return m_cb_data;
 }
 
+gpi_cb_counters_t GpiCbHdl::counters = { 0, 0, 0 };
+
+void gpi_get_cb_counters(gpi_cb_counters_t *counters)
+{
+    *counters = GpiCbHdl::counters;
+}
+
 void GpiCbHdl::set_call_state(gpi_cb_state_e new_state)
 {
     m_state = new_state;
@@ -200,7 +242,8 @@ int GpiValueCbHdl::run_callback(void)
     if (pass) {
         this->gpi_function(m_cb_data);
     } else {
-        cleanup_callback();
+        /* Wait for the next change, the implementation decides whether
+           that needs anything from the simulator */
         arm_callback();
     }
 
@@ -0,0 +1,148 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "gpi_priv.h"
+#include <stdlib.h>
+#include <new>
+
+/* Callback handles are created and destroyed for almost every trigger, so
+   their storage is recycled through per-size slabs rather than the heap.
+   Each slab serves one object size, which in practice means one handle
+   class, and grows a chunk of blocks at a time up to GPI_CB_POOL_CHUNKS
+   chunks. After that blocks come straight from the heap and go back to it
+   when the handle is deleted. Chunks are never returned, they are reused
+   for the life of the simulation. */
+
+#define GPI_CB_POOL_ALIGN   16
+#define GPI_CB_POOL_SLABS   32      // Sizes up to 512 bytes are pooled
+#define GPI_CB_POOL_BLOCKS  32      // Blocks carved from each chunk
+#define GPI_CB_POOL_CHUNKS  64      // Chunks a slab may grow to
+
+struct GpiCbSlab;
+
+/* Sits in front of every block, keeps the data behind it aligned */
+union GpiCbBlock {
+    struct {
+        GpiCbSlab  *slab;           // Owning slab, NULL if too large to pool
+        GpiCbBlock *next;           // Next free block, NULL if from the heap
+        bool        heap;
+        bool        used;           // Has held a handle before
+    } hdr;
+    char pad[GPI_CB_POOL_ALIGN * 2];
+};
+
+struct GpiCbSlab {
+    GpiCbBlock *free_list;
+    uint64_t    allocs;
+    uint64_t    reused;
+    uint64_t    in_use;
+    uint64_t    peak;
+    uint64_t    overflow;
+    uint32_t    chunks;
+};
+
+/* Plain data so it is usable before any constructors have run */
+static GpiCbSlab cb_slabs[GPI_CB_POOL_SLABS];
+static GpiCbSlab cb_large;
+
+static inline size_t slab_block_size(int index)
+{
+    return sizeof(GpiCbBlock) + (size_t)(index + 1) * GPI_CB_POOL_ALIGN;
+}
+
+static bool slab_grow(GpiCbSlab *slab, int index)
+{
+    if (slab->chunks >= GPI_CB_POOL_CHUNKS)
+        return false;
+
+    size_t block_size = slab_block_size(index);
+    char *chunk = (char *)malloc(block_size * GPI_CB_POOL_BLOCKS);
+    if (!chunk)
+        return false;
+
+    for (int i = GPI_CB_POOL_BLOCKS - 1; i >= 0; i--) {
+        GpiCbBlock *block = (GpiCbBlock *)(void *)(chunk + i * block_size);
+        block->hdr.slab = slab;
+        block->hdr.heap = false;
+        block->hdr.used = false;
+        block->hdr.next = slab->free_list;
+        slab->free_list = block;
+    }
+
+    slab->chunks++;
+    return true;
+}
+
+void *GpiCbHdl::operator new(size_t size)
+{
+    size_t index = size ? (size - 1) / GPI_CB_POOL_ALIGN : 0;
+    GpiCbSlab *slab = index < GPI_CB_POOL_SLABS ? &cb_slabs[index] : &cb_large;
+    GpiCbBlock *block;
+
+    if (slab != &cb_large && (slab->free_list || slab_grow(slab, (int)index))) {
+        block = slab->free_list;
+        slab->free_list = block->hdr.next;
+        if (block->hdr.used)
+            slab->reused++;
+    } else {
+        block = (GpiCbBlock *)malloc(sizeof(GpiCbBlock) + size);
+        if (!block)
+            throw std::bad_alloc();
+        block->hdr.slab = slab;
+        block->hdr.heap = true;
+        slab->overflow++;
+    }
+
+    block->hdr.used = true;
+    block->hdr.next = NULL;
+    slab->allocs++;
+    if (++slab->in_use > slab->peak)
+        slab->peak = slab->in_use;
+
+    return block + 1;
+}
+
+void GpiCbHdl::operator delete(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    GpiCbBlock *block = (GpiCbBlock *)ptr - 1;
+    GpiCbSlab *slab = block->hdr.slab;
+
+    slab->in_use--;
+
+    if (block->hdr.heap) {
+        free(block);
+    } else {
+        block->hdr.next = slab->free_list;
+        slab->free_list = block;
+    }
+}
+
+int gpi_get_cb_pool_stats(gpi_cb_pool_stats_t *stats, int max)
+{
+    int count = 0;
+
+    for (int i = 0; i <= GPI_CB_POOL_SLABS; i++) {
+        GpiCbSlab *slab = i < GPI_CB_POOL_SLABS ? &cb_slabs[i] : &cb_large;
+
+        if (!slab->allocs)
+            continue;
+
+        if (count < max) {
+            gpi_cb_pool_stats_t *s = &stats[count];
+            s->size     = i < GPI_CB_POOL_SLABS ? (uint32_t)((i + 1) * GPI_CB_POOL_ALIGN) : 0;
+            s->allocs   = slab->allocs;
+            s->reused   = slab->reused;
+            s->in_use   = slab->in_use;
+            s->peak     = slab->peak;
+            s->overflow = slab->overflow;
+            s->chunks   = slab->chunks;
+        }
+        count++;
+    }
+
+    return count;
+}
@@ -31,6 +31,10 @@
 #include <cocotb_utils.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <vector>
 #include <map>
 
@@ -80,6 +84,357 @@ static GpiHandleStore unique_handles;
 
 #endif
 
+#ifdef GPI_ALLOC_COUNT
+
+/* Test builds count every C++ heap allocation in the process so that tests
+   can check the read and write paths do not allocate once warmed up */
+
+#include <new>
+
+#if __cplusplus >= 201103L
+#define GPI_NOEXCEPT noexcept
+#else
+#define GPI_NOEXCEPT throw()
+#endif
+
+static unsigned long long alloc_count = 0;
+
+void *operator new(size_t size)
+{
+    alloc_count++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) GPI_NOEXCEPT
+{
+    free(p);
+}
+
+void operator delete[](void *p) GPI_NOEXCEPT
+{
+    free(p);
+}
+
+long long gpi_get_alloc_count(void)
+{
+    return (long long)alloc_count;
+}
+
+#else
+
+long long gpi_get_alloc_count(void)
+{
+    return -1;
+}
+
+#endif
+
+/* Per entry point call counts and latencies, enabled by setting
+   COCOTB_GPI_STATS in the environment. When it is not set each entry point
+   only pays for testing a flag. */
+
+#define GPI_STATS_IMPLS 4
+
+typedef enum gpi_call_e {
+    GPI_CALL_GET_SIM_TIME,
+    GPI_CALL_GET_SIM_PRECISION,
+    GPI_CALL_GET_ROOT_HANDLE,
+    GPI_CALL_GET_HANDLE_BY_NAME,
+    GPI_CALL_GET_HANDLE_BY_INDEX,
+    GPI_CALL_ITERATE,
+    GPI_CALL_NEXT,
+    GPI_CALL_GET_DEFINITION_NAME,
+    GPI_CALL_GET_DEFINITION_FILE,
+    GPI_CALL_GET_SIGNAL_VALUE_BINSTR,
+    GPI_CALL_GET_SIGNAL_VALUE_STR,
+    GPI_CALL_GET_SIGNAL_VALUE_REAL,
+    GPI_CALL_GET_SIGNAL_VALUE_LONG,
+    GPI_CALL_GET_SIGNAL_VALUE_WORDS,
+    GPI_CALL_GET_SIGNAL_NAME_STR,
+    GPI_CALL_GET_SIGNAL_FULLNAME_STR,
+    GPI_CALL_GET_SIGNAL_TYPE_STR,
+    GPI_CALL_GET_OBJECT_TYPE,
+    GPI_CALL_IS_CONSTANT,
+    GPI_CALL_IS_INDEXABLE,
+    GPI_CALL_SET_SIGNAL_VALUE_LONG,
+    GPI_CALL_SET_SIGNAL_VALUE_STR,
+    GPI_CALL_SET_SIGNAL_VALUE_REAL,
+    GPI_CALL_GET_NUM_ELEMS,
+    GPI_CALL_GET_RANGE_LEFT,
+    GPI_CALL_GET_RANGE_RIGHT,
+    GPI_CALL_REGISTER_VALUE_CHANGE_CALLBACK,
+    GPI_CALL_REGISTER_TIMED_CALLBACK,
+    GPI_CALL_REGISTER_READONLY_CALLBACK,
+    GPI_CALL_REGISTER_NEXTTIME_CALLBACK,
+    GPI_CALL_REGISTER_READWRITE_CALLBACK,
+    GPI_CALL_DEREGISTER_CALLBACK,
+    GPI_CALL_MAX
+} gpi_call_t;
+
+static const char *gpi_call_names[GPI_CALL_MAX] = {
+    "gpi_get_sim_time",
+    "gpi_get_sim_precision",
+    "gpi_get_root_handle",
+    "gpi_get_handle_by_name",
+    "gpi_get_handle_by_index",
+    "gpi_iterate",
+    "gpi_next",
+    "gpi_get_definition_name",
+    "gpi_get_definition_file",
+    "gpi_get_signal_value_binstr",
+    "gpi_get_signal_value_str",
+    "gpi_get_signal_value_real",
+    "gpi_get_signal_value_long",
+    "gpi_get_signal_value_words",
+    "gpi_get_signal_name_str",
+    "gpi_get_signal_fullname_str",
+    "gpi_get_signal_type_str",
+    "gpi_get_object_type",
+    "gpi_is_constant",
+    "gpi_is_indexable",
+    "gpi_set_signal_value_long",
+    "gpi_set_signal_value_str",
+    "gpi_set_signal_value_real",
+    "gpi_get_num_elems",
+    "gpi_get_range_left",
+    "gpi_get_range_right",
+    "gpi_register_value_change_callback",
+    "gpi_register_timed_callback",
+    "gpi_register_readonly_callback",
+    "gpi_register_nexttime_callback",
+    "gpi_register_readwrite_callback",
+    "gpi_deregister_callback",
+};
+
+struct GpiCallStats {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t hist[GPI_STATS_BUCKETS];
+};
+
+static bool call_stats_enabled = getenv("COCOTB_GPI_STATS") != NULL;
+static GpiCallStats call_stats[GPI_STATS_IMPLS][GPI_CALL_MAX];
+
+static inline uint64_t gpi_stats_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Times the rest of the enclosing entry point */
+class GpiCallTimer {
+public:
+    GpiCallTimer(gpi_call_t call, const GpiImplInterface *impl) : m_stats(NULL) {
+        if (call_stats_enabled)
+            start(call, impl);
+    }
+
+    ~GpiCallTimer() {
+        if (m_stats)
+            stop();
+    }
+
+private:
+    void start(gpi_call_t call, const GpiImplInterface *impl) {
+        size_t index = 0;
+
+        while (index < registered_impls.size() && index < GPI_STATS_IMPLS - 1 &&
+               registered_impls[index] != impl)
+            index++;
+
+        m_stats = &call_stats[index][call];
+        m_start = gpi_stats_now();
+    }
+
+    void stop(void) {
+        uint64_t ns = gpi_stats_now() - m_start;
+        int bucket = 0;
+
+        /* Bucket 0 is under 64ns, each one after doubles */
+        while (bucket < GPI_STATS_BUCKETS - 1 && (ns >> (bucket + 6)))
+            bucket++;
+
+        m_stats->calls++;
+        m_stats->total_ns += ns;
+        if (ns > m_stats->max_ns)
+            m_stats->max_ns = ns;
+        m_stats->hist[bucket]++;
+    }
+
+    GpiCallStats *m_stats;
+    uint64_t m_start;
+};
+
+#define GPI_CALL_STATS(_call, _impl) GpiCallTimer _call_timer(_call, _impl)
+
+int gpi_get_call_stats(int index, gpi_call_stats_t *stats)
+{
+    if (!call_stats_enabled)
+        return 0;
+
+    for (int impl = 0; impl < GPI_STATS_IMPLS; impl++) {
+        for (int call = 0; call < GPI_CALL_MAX; call++) {
+            GpiCallStats *entry = &call_stats[impl][call];
+
+            if (!entry->calls || index--)
+                continue;
+
+            if ((size_t)impl < registered_impls.size())
+                stats->impl = registered_impls[impl]->get_name_c();
+            else
+                stats->impl = "other";
+            stats->call     = gpi_call_names[call];
+            stats->calls    = entry->calls;
+            stats->total_ns = entry->total_ns;
+            stats->max_ns   = entry->max_ns;
+            for (int i = 0; i < GPI_STATS_BUCKETS; i++)
+                stats->hist[i] = entry->hist[i];
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Log the table once, from whichever of gpi_sim_end() and gpi_embed_end()
+   comes first */
+static void gpi_dump_call_stats(void)
+{
+    static bool dumped = false;
+    gpi_call_stats_t stats;
+
+    if (!call_stats_enabled || dumped)
+        return;
+    dumped = true;
+
+    LOG_INFO("GPI call statistics:");
+    LOG_INFO("%-6s %-36s %10s %12s %10s %10s", "Impl", "Call", "Calls", "Total us", "Mean ns", "Max ns");
+
+    for (int i = 0; gpi_get_call_stats(i, &stats); i++) {
+        LOG_INFO("%-6s %-36s %10llu %12.1f %10llu %10llu",
+                 stats.impl, stats.call,
+                 (unsigned long long)stats.calls,
+                 (double)stats.total_ns / 1000.0,
+                 (unsigned long long)(stats.total_ns / stats.calls),
+                 (unsigned long long)stats.max_ns);
+    }
+}
+
+/* Start-up timeline, enabled by setting COCOTB_STARTUP_PROFILE. Phases
+   from the GPI and from Python go into the same list so they share one
+   clock and nest within each other. */
+
+struct GpiStartupPhase {
+    std::string name;
+    int depth;
+    bool open;
+    uint64_t start_ns;
+    uint64_t end_ns;
+};
+
+static bool startup_enabled = getenv("COCOTB_STARTUP_PROFILE") != NULL &&
+                              *getenv("COCOTB_STARTUP_PROFILE") != '\0';
+static vector<GpiStartupPhase> startup_phases;
+static vector<size_t> startup_open;
+static uint64_t startup_origin;
+
+/* When the process started on the CLOCK_MONOTONIC scale, or 0 if not
+   known. Linux gives the start in clock ticks since boot, which is where
+   CLOCK_BOOTTIME counts from. */
+static uint64_t gpi_process_start_ns(void)
+{
+#if defined(__linux__)
+    char stat[1024];
+    unsigned long long ticks;
+    struct timespec boot;
+    FILE *f = fopen("/proc/self/stat", "r");
+
+    if (!f)
+        return 0;
+
+    size_t len = fread(stat, 1, sizeof(stat) - 1, f);
+    fclose(f);
+    stat[len] = '\0';
+
+    /* The command name may contain spaces, the fields after it do not.
+       The start time is the 20th field after the name */
+    char *field = strrchr(stat, ')');
+    for (int i = 0; field && i < 20; i++)
+        field = strchr(field + 1, ' ');
+
+    if (!field || sscanf(field, " %llu", &ticks) != 1 ||
+        clock_gettime(CLOCK_BOOTTIME, &boot))
+        return 0;
+
+    uint64_t now = gpi_stats_now();
+    uint64_t age = (uint64_t)boot.tv_sec * 1000000000ULL + (uint64_t)boot.tv_nsec -
+                   (uint64_t)ticks * (1000000000ULL / sysconf(_SC_CLK_TCK));
+
+    if (age < now)
+        return now - age;
+#endif
+    return 0;
+}
+
+void gpi_startup_begin(const char *phase)
+{
+    if (!startup_enabled)
+        return;
+
+    uint64_t now = gpi_stats_now();
+
+    if (startup_phases.empty()) {
+        startup_origin = gpi_process_start_ns();
+        if (startup_origin) {
+            /* Everything the simulator did before loading the GPI */
+            GpiStartupPhase load = { "simulator load", 0, false, 0, now - startup_origin };
+            startup_phases.push_back(load);
+        } else {
+            startup_origin = now;
+        }
+    }
+
+    GpiStartupPhase entry = { phase, (int)startup_open.size(), true, now - startup_origin, 0 };
+    startup_open.push_back(startup_phases.size());
+    startup_phases.push_back(entry);
+}
+
+void gpi_startup_end(void)
+{
+    if (!startup_enabled || startup_open.empty())
+        return;
+
+    GpiStartupPhase &entry = startup_phases[startup_open.back()];
+
+    entry.open = false;
+    entry.end_ns = gpi_stats_now() - startup_origin;
+    startup_open.pop_back();
+}
+
+int gpi_get_startup_phase(int index, gpi_startup_phase_t *phase)
+{
+    if (index < 0 || (size_t)index >= startup_phases.size())
+        return 0;
+
+    GpiStartupPhase &entry = startup_phases[index];
+
+    phase->name     = entry.name.c_str();
+    phase->depth    = entry.depth;
+    phase->start_ns = entry.start_ns;
+    phase->open     = entry.open;
+    phase->end_ns   = entry.open ? gpi_stats_now() - startup_origin : entry.end_ns;
+    return 1;
+}
 
 int gpi_print_registered_impl(void)
 {
@@ -111,24 +466,51 @@ int gpi_register_impl(GpiImplInterface *func_tbl)
 
 void gpi_embed_init(gpi_sim_info_t *info)
 {
-    if (embed_sim_init(info))
+    gpi_fr_init();
+
+    if (gpi_remote_enabled()) {
+        gpi_remote_sim_init(info);
+        return;
+    }
+
+    gpi_startup_begin("embed_sim_init");
+    int failed = embed_sim_init(info);
+    gpi_startup_end();
+
+    if (failed)
         gpi_embed_end();
 }
 
 void gpi_embed_end(void)
 
 {
+    gpi_fr_record(GPI_FR_EMBED_END, 0, NULL, 0);
+    gpi_fr_end();
+    gpi_dump_call_stats();
+
+    if (gpi_remote_enabled()) {
+        gpi_remote_sim_end();
+        return;
+    }
+
     embed_sim_event(SIM_FAIL, "Simulator shutdown prematurely");
 }
 
 void gpi_sim_end(void)
 {
+    gpi_fr_record(GPI_FR_SIM_END, 0, NULL, 0);
+    gpi_fr_end();
+    gpi_dump_call_stats();
+    gpi_log_flush();
     registered_impls[0]->sim_end();
 }
 
 void gpi_embed_event(gpi_event_t level, const char *msg)
 {
-    embed_sim_event(level, msg);
+    if (gpi_remote_enabled())
+        gpi_remote_sim_event(level, msg);
+    else
+        embed_sim_event(level, msg);
 }
 
 static void gpi_load_libs(std::vector<std::string> to_load)
@@ -144,6 +526,8 @@ static void gpi_load_libs(std::vector<std::string> to_load)
         std::string full_name = "lib" + *iter + DOT_LIB_EXT;
         const char *now_loading = (full_name).c_str();
 
+        gpi_startup_begin(("load " + full_name).c_str());
+
         lib_handle = utils_dyn_open(now_loading);
         if (!lib_handle) {
             printf("Error loading lib %s\n", now_loading);
@@ -158,6 +542,8 @@ static void gpi_load_libs(std::vector<std::string> to_load)
 
         layer_entry_func new_lib_entry = (layer_entry_func)entry_point;
         new_lib_entry();
+
+        gpi_startup_end();
     }
 }
 
@@ -191,18 +577,35 @@ void gpi_load_extra_libs(void)
         gpi_load_libs(to_load);
     }
 
-    /* Finally embed python */
-    embed_init_python();
+    /* Finally embed python, or start the testbench in its own process */
+    if (gpi_remote_enabled()) {
+        gpi_startup_begin("gpi_remote_start");
+        gpi_remote_start();
+    } else {
+        gpi_startup_begin("embed_init_python");
+        embed_init_python();
+    }
+    gpi_startup_end();
     gpi_print_registered_impl();
 }
 
 void gpi_get_sim_time(uint32_t *high, uint32_t *low)
 {
+    static uint64_t last_time = GPI_FR_TIME_UNKNOWN;
+
+    GPI_CALL_STATS(GPI_CALL_GET_SIM_TIME, registered_impls[0]);
     registered_impls[0]->get_sim_time(high, low);
+
+    uint64_t time = ((uint64_t)*high << 32) | *low;
+    if (time != last_time) {
+        last_time = time;
+        gpi_fr_record(GPI_FR_SIM_TIME, 0, NULL, time);
+    }
 }
 
 void gpi_get_sim_precision(int32_t *precision)
 {
+    GPI_CALL_STATS(GPI_CALL_GET_SIM_PRECISION, registered_impls[0]);
     /* We clamp to sensible values here, 1e-15 min and 1e3 max */
     int32_t val;
     registered_impls[0]->get_sim_precision(&val);
@@ -218,6 +621,7 @@ void gpi_get_sim_precision(int32_t *precision)
 
 gpi_sim_hdl gpi_get_root_handle(const char *name)
 {
+    GPI_CALL_STATS(GPI_CALL_GET_ROOT_HANDLE, registered_impls[0]);
     /* May need to look over all the implementations that are registered
        to find this handle */
     vector<GpiImplInterface*>::iterator iter;
@@ -237,6 +641,8 @@ gpi_sim_hdl gpi_get_root_handle(const char *name)
         }
     }
 
+    gpi_fr_record(GPI_FR_LOOKUP, GPI_FR_LOOKUP_ROOT, hdl, gpi_fr_prefix(name));
+
     if (hdl)
         return CHECK_AND_STORE(hdl);
     else {
@@ -322,7 +728,9 @@ gpi_sim_hdl gpi_get_handle_by_name(gpi_sim_hdl parent, const char *name)
 {
     std::string s_name = name;
     GpiObjHdl *base = sim_to_hdl<GpiObjHdl*>(parent);
+    GPI_CALL_STATS(GPI_CALL_GET_HANDLE_BY_NAME, base->m_impl);
     GpiObjHdl *hdl = __gpi_get_handle_by_name(base, s_name, NULL);
+    gpi_fr_record(GPI_FR_LOOKUP, GPI_FR_LOOKUP_NAME, hdl, gpi_fr_prefix(name));
     if (!hdl) {
         LOG_DEBUG("Failed to find a hdl named %s via any registered implementation",
                  name);
@@ -337,6 +745,7 @@ gpi_sim_hdl gpi_get_handle_by_index(gpi_sim_hdl parent, int32_t index)
     GpiObjHdl *hdl         = NULL;
     GpiObjHdl *base        = sim_to_hdl<GpiObjHdl*>(parent);
     GpiImplInterface *intf = base->m_impl;
+    GPI_CALL_STATS(GPI_CALL_GET_HANDLE_BY_INDEX, intf);
 
     /* Shouldn't need to iterate over interfaces because indexing into a handle shouldn't
      * cross the interface boundaries.
@@ -346,6 +755,7 @@ gpi_sim_hdl gpi_get_handle_by_index(gpi_sim_hdl parent, int32_t index)
      */
     LOG_DEBUG("Checking if index %d native though impl %s ", index, intf->get_name_c());
     hdl = intf->native_check_create(index, base);
+    gpi_fr_record(GPI_FR_LOOKUP, GPI_FR_LOOKUP_INDEX, hdl, (uint64_t)(int64_t)index);
 
     if (hdl)
         return CHECK_AND_STORE(hdl);
@@ -358,6 +768,7 @@ gpi_sim_hdl gpi_get_handle_by_index(gpi_sim_hdl parent, int32_t index)
 gpi_iterator_hdl gpi_iterate(gpi_sim_hdl base, gpi_iterator_sel_t type)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(base);
+    GPI_CALL_STATS(GPI_CALL_ITERATE, obj_hdl->m_impl);
     GpiIterator *iter = obj_hdl->m_impl->iterate_handle(obj_hdl, type);
     if (!iter) {
         return NULL;
@@ -369,6 +780,7 @@ gpi_sim_hdl gpi_next(gpi_iterator_hdl iterator)
 {
     std::string name;
     GpiIterator *iter = sim_to_hdl<GpiIterator*>(iterator);
+    GPI_CALL_STATS(GPI_CALL_NEXT, iter->m_impl);
     GpiObjHdl *parent = iter->get_parent();
 
     while (true) {
@@ -409,60 +821,84 @@ gpi_sim_hdl gpi_next(gpi_iterator_hdl iterator)
 const char* gpi_get_definition_name(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_DEFINITION_NAME, obj_hdl->m_impl);
     return obj_hdl->get_definition_name();
 }
 
 const char* gpi_get_definition_file(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_DEFINITION_FILE, obj_hdl->m_impl);
     return obj_hdl->get_definition_file();
 }
 
 const char *gpi_get_signal_value_binstr(gpi_sim_hdl sig_hdl)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_VALUE_BINSTR, obj_hdl->m_impl);
     return obj_hdl->get_signal_value_binstr();
 }
 
 const char *gpi_get_signal_value_str(gpi_sim_hdl sig_hdl)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_VALUE_STR, obj_hdl->m_impl);
     return obj_hdl->get_signal_value_str();
 }
 
 double gpi_get_signal_value_real(gpi_sim_hdl sig_hdl)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_VALUE_REAL, obj_hdl->m_impl);
     return obj_hdl->get_signal_value_real();
 }
 
 long gpi_get_signal_value_long(gpi_sim_hdl sig_hdl)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_VALUE_LONG, obj_hdl->m_impl);
     return obj_hdl->get_signal_value_long();
 }
 
+int gpi_get_signal_value_words(gpi_sim_hdl sig_hdl, uint32_t *aval, uint32_t *bval, int num_words)
+{
+    GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_VALUE_WORDS, obj_hdl->m_impl);
+    return obj_hdl->get_signal_value_words(aval, bval, num_words);
+}
+
 const char *gpi_get_signal_name_str(gpi_sim_hdl sig_hdl)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_NAME_STR, obj_hdl->m_impl);
     return obj_hdl->get_name_str();
 }
 
+const char *gpi_get_signal_fullname_str(gpi_sim_hdl sig_hdl)
+{
+    GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_FULLNAME_STR, obj_hdl->m_impl);
+    return obj_hdl->get_fullname_str();
+}
+
 const char *gpi_get_signal_type_str(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_SIGNAL_TYPE_STR, obj_hdl->m_impl);
     return obj_hdl->get_type_str();
 }
 
 gpi_objtype_t gpi_get_object_type(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_OBJECT_TYPE, obj_hdl->m_impl);
     return obj_hdl->get_type();
 }
 
 int gpi_is_constant(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_IS_CONSTANT, obj_hdl->m_impl);
     if (obj_hdl->get_const())
         return 1;
     return 0;
@@ -471,6 +907,7 @@ int gpi_is_constant(gpi_sim_hdl sig_hdl)
 int gpi_is_indexable(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_IS_INDEXABLE, obj_hdl->m_impl);
     if (obj_hdl->get_indexable())
         return 1;
     return 0;
@@ -479,37 +916,47 @@ int gpi_is_indexable(gpi_sim_hdl sig_hdl)
 void gpi_set_signal_value_long(gpi_sim_hdl sig_hdl, long value)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_SET_SIGNAL_VALUE_LONG, obj_hdl->m_impl);
+    gpi_fr_record(GPI_FR_WRITE_LONG, 0, obj_hdl, (uint64_t)value);
     obj_hdl->set_signal_value(value);
 }
 
 void gpi_set_signal_value_str(gpi_sim_hdl sig_hdl, const char *str)
 {
-    std::string value = str;
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
-    obj_hdl->set_signal_value(value);
+    GPI_CALL_STATS(GPI_CALL_SET_SIGNAL_VALUE_STR, obj_hdl->m_impl);
+    gpi_fr_record(GPI_FR_WRITE_STR, 0, obj_hdl, gpi_fr_prefix(str));
+    obj_hdl->set_signal_value_str(str);
 }
 
 void gpi_set_signal_value_real(gpi_sim_hdl sig_hdl, double value)
 {
     GpiSignalObjHdl *obj_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_SET_SIGNAL_VALUE_REAL, obj_hdl->m_impl);
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    gpi_fr_record(GPI_FR_WRITE_REAL, 0, obj_hdl, bits);
     obj_hdl->set_signal_value(value);
 }
 
 int gpi_get_num_elems(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_NUM_ELEMS, obj_hdl->m_impl);
     return obj_hdl->get_num_elems();
 }
 
 int gpi_get_range_left(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_RANGE_LEFT, obj_hdl->m_impl);
     return obj_hdl->get_range_left();
 }
 
 int gpi_get_range_right(gpi_sim_hdl sig_hdl)
 {
     GpiObjHdl *obj_hdl = sim_to_hdl<GpiObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_GET_RANGE_RIGHT, obj_hdl->m_impl);
     return obj_hdl->get_range_right();
 }
 
@@ -520,6 +967,7 @@ gpi_sim_hdl gpi_register_value_change_callback(int (*gpi_function)(const void *)
 {
 
     GpiSignalObjHdl *signal_hdl = sim_to_hdl<GpiSignalObjHdl*>(sig_hdl);
+    GPI_CALL_STATS(GPI_CALL_REGISTER_VALUE_CHANGE_CALLBACK, signal_hdl->m_impl);
 
     /* Do something based on int & GPI_RISING | GPI_FALLING */
     GpiCbHdl *gpi_hdl = signal_hdl->value_change_cb(edge);
@@ -528,6 +976,7 @@ gpi_sim_hdl gpi_register_value_change_callback(int (*gpi_function)(const void *)
         return NULL;
     }
 
+    gpi_fr_record(GPI_FR_CB_ARMED, GPI_FR_CB_VALUE_CHANGE, gpi_hdl, edge);
     gpi_hdl->set_user_data(gpi_function, gpi_cb_data);
     return (gpi_sim_hdl)gpi_hdl;
 }
@@ -537,12 +986,14 @@ gpi_sim_hdl gpi_register_value_change_callback(int (*gpi_function)(const void *)
 gpi_sim_hdl gpi_register_timed_callback(int (*gpi_function)(const void *),
                                         void *gpi_cb_data, uint64_t time_ps)
 {
+    GPI_CALL_STATS(GPI_CALL_REGISTER_TIMED_CALLBACK, registered_impls[0]);
     GpiCbHdl *gpi_hdl = registered_impls[0]->register_timed_callback(time_ps);
     if (!gpi_hdl) {
         LOG_ERROR("Failed to register a timed callback");
         return NULL;
     }
 
+    gpi_fr_record(GPI_FR_CB_ARMED, GPI_FR_CB_TIMED, gpi_hdl, time_ps);
     gpi_hdl->set_user_data(gpi_function, gpi_cb_data);
     return (gpi_sim_hdl)gpi_hdl;
 }
@@ -553,12 +1004,14 @@ gpi_sim_hdl gpi_register_timed_callback(int (*gpi_function)(const void *),
 gpi_sim_hdl gpi_register_readonly_callback(int (*gpi_function)(const void *),
                                            void *gpi_cb_data)
 {
+    GPI_CALL_STATS(GPI_CALL_REGISTER_READONLY_CALLBACK, registered_impls[0]);
     GpiCbHdl *gpi_hdl = registered_impls[0]->register_readonly_callback();
     if (!gpi_hdl) {
         LOG_ERROR("Failed to register a readonly callback");
         return NULL;
     }
 
+    gpi_fr_record(GPI_FR_CB_ARMED, GPI_FR_CB_READONLY, gpi_hdl, 0);
     gpi_hdl->set_user_data(gpi_function, gpi_cb_data);
     return (gpi_sim_hdl)gpi_hdl;
 }
@@ -566,12 +1019,14 @@ gpi_sim_hdl gpi_register_readonly_callback(int (*gpi_function)(const void *),
 gpi_sim_hdl gpi_register_nexttime_callback(int (*gpi_function)(const void *),
                                            void *gpi_cb_data)
 {
+    GPI_CALL_STATS(GPI_CALL_REGISTER_NEXTTIME_CALLBACK, registered_impls[0]);
     GpiCbHdl *gpi_hdl = registered_impls[0]->register_nexttime_callback();
     if (!gpi_hdl) {
         LOG_ERROR("Failed to register a nexttime callback");
         return NULL;
     }
 
+    gpi_fr_record(GPI_FR_CB_ARMED, GPI_FR_CB_NEXTTIME, gpi_hdl, 0);
     gpi_hdl->set_user_data(gpi_function, gpi_cb_data);
     return (gpi_sim_hdl)gpi_hdl;
 }
@@ -582,12 +1037,14 @@ gpi_sim_hdl gpi_register_nexttime_callback(int (*gpi_function)(const void *),
 gpi_sim_hdl gpi_register_readwrite_callback(int (*gpi_function)(const void *),
                                             void *gpi_cb_data)
 {
+    GPI_CALL_STATS(GPI_CALL_REGISTER_READWRITE_CALLBACK, registered_impls[0]);
     GpiCbHdl *gpi_hdl = registered_impls[0] ->register_readwrite_callback();
     if (!gpi_hdl) {
         LOG_ERROR("Failed to register a readwrite callback");
         return NULL;
     }
 
+    gpi_fr_record(GPI_FR_CB_ARMED, GPI_FR_CB_READWRITE, gpi_hdl, 0);
     gpi_hdl->set_user_data(gpi_function, gpi_cb_data);
     return (gpi_sim_hdl)gpi_hdl;
 }
@@ -610,6 +1067,8 @@ void gpi_stop_clock(gpi_sim_hdl clk_object)
 void gpi_deregister_callback(gpi_sim_hdl hdl)
 {
     GpiCbHdl *cb_hdl = sim_to_hdl<GpiCbHdl*>(hdl);
+    GPI_CALL_STATS(GPI_CALL_DEREGISTER_CALLBACK, cb_hdl->m_impl);
+    gpi_fr_record(GPI_FR_CB_REMOVED, 0, cb_hdl, 0);
     cb_hdl->m_impl->deregister_callback(cb_hdl);
 }
 
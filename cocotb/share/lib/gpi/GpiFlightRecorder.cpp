@@ -0,0 +1,203 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* Flight recorder
+ *
+ * Keeps the last GPI_FR_EVENTS callbacks, lookups and writes in a ring so
+ * there is something to go on when a simulation hangs or dies inside a
+ * callback. Recording an event is a plain increment and a few stores, so it
+ * is always on. Fired callbacks carry the time only where the simulator
+ * passes it with the callback; otherwise the times read through
+ * gpi_get_sim_time() are recorded as they change. The ring is written out on SIGSEGV or SIGABRT, and also when
+ * the simulation ends if COCOTB_FLIGHT_RECORDER is set, to the file that
+ * names (cocotb_flight.bin by default). A forked process adds its pid to the
+ * name. bin/decode_flight_recorder.py prints it.
+ *
+ * File layout, in host byte order:
+ *
+ *     char     magic[8]        "COCOTBFR"
+ *     uint32_t version         1
+ *     uint32_t num_events      slots in the ring
+ *     uint32_t event_size      sizeof(gpi_fr_event_t)
+ *     uint32_t next_seq        seq the next event would have been given
+ *     gpi_fr_event_t events[num_events]
+ */
+
+#include "gpi_priv.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define GPI_FR_MAGIC    "COCOTBFR"
+#define GPI_FR_VERSION  1
+
+gpi_fr_event_t gpi_fr_ring[GPI_FR_EVENTS];
+uint32_t gpi_fr_seq = 0;
+
+static char fr_path[1024] = "cocotb_flight.bin";
+static bool fr_dump_at_end = false;
+static pid_t fr_pid;
+
+#if defined(__MINGW32__) || defined (__CYGWIN32__)
+typedef void (*fr_handler_t)(int);
+static fr_handler_t fr_old_segv = SIG_DFL;
+static fr_handler_t fr_old_abrt = SIG_DFL;
+#else
+static struct sigaction fr_old_segv;
+static struct sigaction fr_old_abrt;
+#endif
+
+/* Enough of a name or string value to recognise it when decoding */
+uint64_t gpi_fr_prefix(const char *name)
+{
+    uint64_t prefix = 0;
+
+    if (name)
+        strncpy((char *)&prefix, name, sizeof(prefix));
+
+    return prefix;
+}
+
+/* fr_path, with ".<pid>" added in a process forked after start up so
+ * forked tests do not overwrite each other. Safe from a signal handler. */
+static const char *gpi_fr_path(char *buf, size_t size)
+{
+    pid_t pid = getpid();
+    char digits[24];
+    size_t len = strlen(fr_path);
+    int n = 0;
+
+    if (pid == fr_pid)
+        return fr_path;
+
+    do {
+        digits[n++] = (char)('0' + pid % 10);
+        pid /= 10;
+    } while (pid > 0);
+
+    if (len + 1 + (size_t)n >= size)
+        return fr_path;
+
+    memcpy(buf, fr_path, len);
+    buf[len++] = '.';
+    while (n > 0)
+        buf[len++] = digits[--n];
+    buf[len] = '\0';
+    return buf;
+}
+
+/* Only uses calls that are safe from a signal handler */
+void gpi_fr_dump(void)
+{
+    char header[24];
+    char path[sizeof(fr_path) + 24];
+    uint32_t fields[4] = { GPI_FR_VERSION, GPI_FR_EVENTS, sizeof(gpi_fr_event_t), gpi_fr_seq };
+
+    int fd = open(gpi_fr_path(path, sizeof(path)), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    if (fd < 0)
+        return;
+
+    memcpy(header, GPI_FR_MAGIC, 8);
+    memcpy(header + 8, fields, sizeof(fields));
+
+    if (write(fd, header, sizeof(header)) == (ssize_t)sizeof(header)) {
+        /* Nothing more can be done if this fails */
+        ssize_t written = write(fd, gpi_fr_ring, sizeof(gpi_fr_ring));
+        (void)written;
+    }
+
+    close(fd);
+}
+
+/* The ring is only written at the end when asked for, a crash always writes it */
+void gpi_fr_end(void)
+{
+    if (fr_dump_at_end)
+        gpi_fr_dump();
+}
+
+#if defined(__MINGW32__) || defined (__CYGWIN32__)
+static void gpi_fr_fatal(int sig)
+{
+    fr_handler_t old = sig == SIGSEGV ? fr_old_segv : fr_old_abrt;
+
+    gpi_fr_dump();
+
+    /* Let whatever was there before, normally the default, finish off */
+    signal(sig, old == SIG_IGN ? SIG_DFL : old);
+    raise(sig);
+}
+
+static void gpi_fr_install(void)
+{
+    fr_old_segv = signal(SIGSEGV, gpi_fr_fatal);
+    fr_old_abrt = signal(SIGABRT, gpi_fr_fatal);
+
+    if (fr_old_segv == SIG_ERR)
+        fr_old_segv = SIG_DFL;
+    if (fr_old_abrt == SIG_ERR)
+        fr_old_abrt = SIG_DFL;
+}
+#else
+static void gpi_fr_fatal(int sig, siginfo_t *info, void *context)
+{
+    const struct sigaction *old = sig == SIGSEGV ? &fr_old_segv : &fr_old_abrt;
+
+    (void)context;
+    gpi_fr_dump();
+
+    /* Put back whatever was there before, normally the default, with its
+     * flags so an SA_SIGINFO handler of the simulator is still called as one */
+    if (!(old->sa_flags & SA_SIGINFO) && old->sa_handler == SIG_IGN)
+        signal(sig, SIG_DFL);
+    else
+        sigaction(sig, old, NULL);
+
+    /* A real fault happens again on return, with the same siginfo, and
+     * abort() would reset to the default, so only those are raised again */
+    if (sig != SIGSEGV || info == NULL || info->si_code <= 0)
+        raise(sig);
+}
+
+static void gpi_fr_install(void)
+{
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = gpi_fr_fatal;
+    sigemptyset(&action.sa_mask);
+    /* Run once, and on the alternate stack if the process has one so a
+     * stack overflow can still be recorded */
+    action.sa_flags = SA_SIGINFO | SA_RESETHAND | SA_ONSTACK;
+
+    if (sigaction(SIGSEGV, &action, &fr_old_segv) != 0) {
+        memset(&fr_old_segv, 0, sizeof(fr_old_segv));
+        fr_old_segv.sa_handler = SIG_DFL;
+    }
+    if (sigaction(SIGABRT, &action, &fr_old_abrt) != 0) {
+        memset(&fr_old_abrt, 0, sizeof(fr_old_abrt));
+        fr_old_abrt.sa_handler = SIG_DFL;
+    }
+}
+#endif
+
+void gpi_fr_init(void)
+{
+    const char *path = getenv("COCOTB_FLIGHT_RECORDER");
+
+    if (path && *path) {
+        strncpy(fr_path, path, sizeof(fr_path) - 1);
+        fr_path[sizeof(fr_path) - 1] = '\0';
+        fr_dump_at_end = true;
+    }
+    fr_pid = getpid();
+
+    gpi_fr_install();
+}
@@ -0,0 +1,329 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* Signal recorder
+ *
+ * Attaches a value change callback to each recorded signal and appends the
+ * transitions to a binary trace from C, so recording costs no Python time.
+ * bin/cocotb_trace2vcd.py converts a trace into a VCD file.
+ *
+ * File layout, all fields little-endian:
+ *
+ *     char     magic[8]        "COCOTBTR"
+ *     uint32_t version         1
+ *     uint32_t num_signals
+ *     int32_t  precision       simulator precision as a power of 10 seconds
+ *     for each signal:
+ *         uint32_t width       in bits
+ *         uint16_t name_len
+ *         char     name[name_len]
+ *     chunks until the end of the file:
+ *         uint32_t payload_bytes
+ *         uint32_t num_events
+ *         uint64_t base_time
+ *         events:
+ *             varint   time delta from the previous event (or base_time)
+ *             varint   signal index << 1 | four_state
+ *             value    four_state ? width chars : (width + 7) / 8 bytes LSB first
+ *
+ * The initial value of every signal is written when recording starts.
+ */
+
+#include "gpi_priv.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define GPI_RECORDER_MAGIC      "COCOTBTR"
+#define GPI_RECORDER_VERSION    1
+#define GPI_RECORDER_CHUNK_SIZE (256 * 1024)
+#define GPI_RECORDER_CHUNK_HDR  16
+
+class GpiRecorder;
+
+class GpiRecordedSignal {
+public:
+    GpiRecordedSignal(GpiRecorder *recorder, GpiSignalObjHdl *signal, uint32_t index) :
+        m_recorder(recorder),
+        m_signal(signal),
+        m_cb(NULL),
+        m_index(index),
+        m_width(0) { }
+
+    GpiRecorder *m_recorder;
+    GpiSignalObjHdl *m_signal;
+    GpiCbHdl *m_cb;
+    uint32_t m_index;
+    uint32_t m_width;
+};
+
+class GpiRecorder {
+public:
+    GpiRecorder() : m_file(NULL),
+                    m_num_events(0),
+                    m_base_time(0),
+                    m_last_time(0) { }
+    ~GpiRecorder();
+
+    int start(const char *path, std::vector<GpiSignalObjHdl*> &signals);
+    void stop(void);
+    void close_file(void);
+    void record(GpiRecordedSignal *sig);
+
+private:
+    void flush(void);
+    void put_varint(uint64_t value);
+    void put_value(GpiRecordedSignal *sig, const char *binstr);
+
+    static int handle_value_change(const void *data);
+
+    FILE *m_file;
+    std::vector<GpiRecordedSignal*> m_signals;
+    std::vector<uint8_t> m_chunk;
+    uint32_t m_num_events;
+    uint64_t m_base_time;
+    uint64_t m_last_time;
+};
+
+/* Recorders still running when the simulator exits are flushed here, the
+   simulator has gone so the callbacks are left alone */
+static std::vector<GpiRecorder*> active_recorders;
+
+class GpiRecorderCleanup {
+public:
+    ~GpiRecorderCleanup() {
+        for (size_t i = 0; i < active_recorders.size(); i++)
+            active_recorders[i]->close_file();
+    }
+};
+
+static GpiRecorderCleanup recorder_cleanup;
+
+static inline uint64_t recorder_time(void)
+{
+    uint32_t high, low;
+    gpi_get_sim_time(&high, &low);
+    return ((uint64_t)high << 32) | low;
+}
+
+static void put_le(FILE *fp, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        fputc((int)((value >> (8 * i)) & 0xff), fp);
+}
+
+GpiRecorder::~GpiRecorder()
+{
+    stop();
+}
+
+int GpiRecorder::start(const char *path, std::vector<GpiSignalObjHdl*> &signals)
+{
+    int32_t precision;
+
+    m_file = fopen(path, "wb");
+    if (!m_file) {
+        LOG_ERROR("GPI: Unable to open %s to record signals", path);
+        return -1;
+    }
+
+    gpi_get_sim_precision(&precision);
+
+    fwrite(GPI_RECORDER_MAGIC, 1, 8, m_file);
+    put_le(m_file, GPI_RECORDER_VERSION, 4);
+    put_le(m_file, signals.size(), 4);
+    put_le(m_file, (uint32_t)precision, 4);
+
+    for (size_t i = 0; i < signals.size(); i++) {
+        GpiRecordedSignal *sig = new GpiRecordedSignal(this, signals[i], (uint32_t)i);
+        const char *value = sig->m_signal->get_signal_value_binstr();
+        const std::string &name = sig->m_signal->get_fullname();
+
+        sig->m_width = value ? (uint32_t)strlen(value) : 0;
+        if (!sig->m_width)
+            sig->m_width = 1;
+
+        put_le(m_file, sig->m_width, 4);
+        put_le(m_file, name.length(), 2);
+        fwrite(name.c_str(), 1, name.length(), m_file);
+
+        m_signals.push_back(sig);
+    }
+
+    m_chunk.reserve(GPI_RECORDER_CHUNK_SIZE);
+    m_chunk.resize(GPI_RECORDER_CHUNK_HDR);
+    m_base_time = m_last_time = recorder_time();
+
+    for (size_t i = 0; i < m_signals.size(); i++) {
+        GpiRecordedSignal *sig = m_signals[i];
+
+        record(sig);
+
+        sig->m_cb = sig->m_signal->new_value_change_cb(GPI_RISING | GPI_FALLING);
+        if (!sig->m_cb) {
+            LOG_ERROR("GPI: Unable to record changes of %s", sig->m_signal->get_fullname_str());
+            return -1;
+        }
+        sig->m_cb->set_user_data(handle_value_change, sig);
+    }
+
+    return 0;
+}
+
+void GpiRecorder::stop(void)
+{
+    for (size_t i = 0; i < m_signals.size(); i++) {
+        GpiCbHdl *cb = m_signals[i]->m_cb;
+        if (cb) {
+            if (cb->get_call_state() != GPI_FREE)
+                cb->cleanup_callback();
+            delete cb;
+        }
+        delete m_signals[i];
+    }
+    m_signals.clear();
+
+    close_file();
+}
+
+void GpiRecorder::close_file(void)
+{
+    if (m_file) {
+        flush();
+        fclose(m_file);
+        m_file = NULL;
+    }
+}
+
+int GpiRecorder::handle_value_change(const void *data)
+{
+    GpiRecordedSignal *sig = const_cast<GpiRecordedSignal *>(static_cast<const GpiRecordedSignal *>(data));
+
+    sig->m_recorder->record(sig);
+
+    /* Keep the simulator callback registered for the next change */
+    sig->m_cb->set_call_state(GPI_PRIMED);
+    return 0;
+}
+
+void GpiRecorder::record(GpiRecordedSignal *sig)
+{
+    if (!m_file)
+        return;
+
+    const char *value = sig->m_signal->get_signal_value_binstr();
+    if (!value)
+        return;
+
+    /* Worst case size of an event, two varints and a four state value */
+    if (m_chunk.size() + 20 + sig->m_width > GPI_RECORDER_CHUNK_SIZE && m_num_events)
+        flush();
+
+    uint64_t now = recorder_time();
+    if (m_num_events == 0)
+        m_base_time = m_last_time = now;
+
+    put_varint(now - m_last_time);
+    m_last_time = now;
+
+    put_value(sig, value);
+    m_num_events++;
+}
+
+void GpiRecorder::put_varint(uint64_t value)
+{
+    while (value >= 0x80) {
+        m_chunk.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    m_chunk.push_back((uint8_t)value);
+}
+
+/* Values that are all 0/1 are packed eight bits to a byte, anything else is
+   kept as characters */
+void GpiRecorder::put_value(GpiRecordedSignal *sig, const char *binstr)
+{
+    uint32_t width = sig->m_width;
+    size_t len = strlen(binstr);
+    bool four_state = false;
+
+    for (size_t i = 0; i < len; i++) {
+        if (binstr[i] != '0' && binstr[i] != '1') {
+            four_state = true;
+            break;
+        }
+    }
+
+    put_varint(((uint64_t)sig->m_index << 1) | (four_state ? 1 : 0));
+
+    /* Right align the value in the recorded width */
+    if (four_state) {
+        for (uint32_t bit = width; bit > 0; bit--) {
+            size_t pos = bit - 1;
+            m_chunk.push_back(pos < len ? (uint8_t)binstr[len - 1 - pos] : '0');
+        }
+    } else {
+        size_t start = m_chunk.size();
+        m_chunk.resize(start + (width + 7) / 8, 0);
+        for (uint32_t bit = 0; bit < width && bit < len; bit++) {
+            if (binstr[len - 1 - bit] == '1')
+                m_chunk[start + bit / 8] |= (uint8_t)(1 << (bit % 8));
+        }
+    }
+}
+
+void GpiRecorder::flush(void)
+{
+    if (!m_file || !m_num_events)
+        return;
+
+    uint32_t payload = (uint32_t)(m_chunk.size() - GPI_RECORDER_CHUNK_HDR);
+    uint8_t *hdr = &m_chunk[0];
+
+    for (int i = 0; i < 4; i++) {
+        hdr[i] = (uint8_t)(payload >> (8 * i));
+        hdr[4 + i] = (uint8_t)(m_num_events >> (8 * i));
+    }
+    for (int i = 0; i < 8; i++)
+        hdr[8 + i] = (uint8_t)(m_base_time >> (8 * i));
+
+    fwrite(hdr, 1, m_chunk.size(), m_file);
+
+    m_chunk.resize(GPI_RECORDER_CHUNK_HDR);
+    m_num_events = 0;
+}
+
+gpi_sim_hdl gpi_start_recording(const char *path, gpi_sim_hdl *sig_hdls, int num_sigs)
+{
+    std::vector<GpiSignalObjHdl*> signals;
+
+    for (int i = 0; i < num_sigs; i++)
+        signals.push_back(sim_to_hdl<GpiSignalObjHdl*>(sig_hdls[i]));
+
+    GpiRecorder *recorder = new GpiRecorder();
+    if (recorder->start(path, signals)) {
+        delete recorder;
+        return NULL;
+    }
+
+    active_recorders.push_back(recorder);
+    return (gpi_sim_hdl)recorder;
+}
+
+void gpi_stop_recording(gpi_sim_hdl recorder_hdl)
+{
+    GpiRecorder *recorder = sim_to_hdl<GpiRecorder*>(recorder_hdl);
+    std::vector<GpiRecorder*>::iterator it;
+
+    for (it = active_recorders.begin(); it != active_recorders.end(); it++) {
+        if (*it == recorder) {
+            active_recorders.erase(it);
+            delete recorder;
+            return;
+        }
+    }
+
+    LOG_WARN("GPI: Attempt to stop a recorder that is not running");
+}
@@ -0,0 +1,928 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* Out-of-process testbench
+ *
+ * With COCOTB_REMOTE=<path> Python is not embedded in the simulator. A
+ * channel file is created at <path> and mapped by a separate Python process,
+ * started with $COCOTB_REMOTE_PYTHON (default "python"), in which
+ * cocotb.remote stands in for the simulator module.
+ *
+ * File layout, all fields in native byte order:
+ *
+ *     char     magic[8]        "COCOTBCH"
+ *     uint32_t version         1
+ *     uint32_t ring_size       bytes of data in each ring, a power of two
+ *     padding to 64 bytes
+ *     two rings, requests from the testbench and then events from the
+ *     simulator, each laid out as
+ *         uint64_t head        bytes ever written, padded to 64 bytes
+ *         uint64_t tail        bytes ever read, padded to 64 bytes
+ *         uint8_t  data[ring_size]
+ *
+ * A record is a uint32_t payload length, a uint16_t type and a uint16_t of
+ * flags followed by the payload, padded to a multiple of 8 bytes. Records
+ * never wrap, the end of the ring is skipped with a GPI_CH_PAD record. The
+ * head and tail are only published once a batch of records is written or
+ * read, so the writes and callback registrations made while reacting to
+ * one callback cross the channel together and only requests which return
+ * something wait for the simulator.
+ *
+ * Callbacks stop the simulator until the testbench sends GPI_CH_RESUME, as
+ * they would with an embedded testbench. Value change callbacks registered
+ * with a list of signals to sample instead post their values as a
+ * GPI_CH_SAMPLE at every edge and let the simulator carry on, so monitors
+ * and scoreboards can run in parallel with the simulation.
+ */
+
+#include "gpi_priv.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(__MINGW32__) || defined (__CYGWIN32__)
+#define GPI_REMOTE_UNSUPPORTED
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define GPI_CH_MAGIC            "COCOTBCH"
+#define GPI_CH_VERSION          1
+#define GPI_CH_RING_SIZE        (1 << 20)
+#define GPI_CH_HEADER_SIZE      64
+#define GPI_CH_CONTROL_SIZE     128
+
+/* Busy wait for this many polls before yielding, then sleeping. There is no
+ * busy waiting on a single CPU, where it only delays the other process. */
+#define GPI_CH_SPINS            4096
+#define GPI_CH_YIELDS           1024
+#define GPI_CH_SLEEP_US         50
+
+typedef enum gpi_ch_type_e {
+    GPI_CH_PAD = 0,
+
+    /* Requests, from the testbench */
+    GPI_CH_RESUME = 1,          // Return from the callback or start up
+    GPI_CH_STOP,                // gpi_sim_end()
+    GPI_CH_LOG_LEVEL,           // int32_t level
+    GPI_CH_GET_ROOT,            // name                          -> handle
+    GPI_CH_GET_BY_NAME,         // uint32_t parent, name         -> handle
+    GPI_CH_GET_BY_INDEX,        // uint32_t parent, int32_t index -> handle
+    GPI_CH_ITERATE,             // uint32_t parent, int32_t type -> handles
+    GPI_CH_GET_VALUE,           // uint32_t handle               -> value
+    GPI_CH_SET_LONG,            // uint32_t handle, pad, int64_t value
+    GPI_CH_SET_REAL,            // uint32_t handle, pad, double value
+    GPI_CH_SET_STR,             // uint32_t handle, string
+    GPI_CH_REGISTER,            // gpi_ch_register_t, uint32_t samples[]
+    GPI_CH_DEREGISTER,          // uint32_t ids[]
+
+    /* Events, from the simulator */
+    GPI_CH_INIT = 64,           // gpi_ch_init_t, product, version, argv[]
+    GPI_CH_REPLY,               // value or gpi_ch_handle_t and strings
+    GPI_CH_CALLBACK,            // uint32_t id, pad, uint64_t time
+    GPI_CH_SAMPLE,              // uint32_t id, pad, uint64_t time, values
+    GPI_CH_FAILED,              // uint32_t id of a callback not registered
+    GPI_CH_SIM_EVENT,           // int32_t level, message
+    GPI_CH_END,                 // The simulator is exiting
+} gpi_ch_type_t;
+
+/* Flags */
+#define GPI_CH_MORE             1   // REPLY: another reply to the same request follows
+#define GPI_CH_BINSTR           1   // GET_VALUE: binary string whatever the type
+#define GPI_CH_SAMPLE_CB        1   // REGISTER: post GPI_CH_SAMPLE without stopping
+
+/* Kinds of callback, the same as the CB_* constants of the simulator module */
+enum {
+    GPI_CH_CB_TIMER,
+    GPI_CH_CB_VALUE_CHANGE,
+    GPI_CH_CB_READWRITE,
+    GPI_CH_CB_READONLY,
+    GPI_CH_CB_NEXTTIME,
+};
+
+typedef struct gpi_ch_record_s {
+    uint32_t len;
+    uint16_t type;
+    uint16_t flags;
+} gpi_ch_record_t;
+
+typedef struct gpi_ch_init_s {
+    uint64_t time;
+    int32_t precision;
+    int32_t argc;
+} gpi_ch_init_t;
+
+/* Followed by name, fullname, type string, definition name and definition
+ * file, each NUL terminated, empty if set in null_mask */
+typedef struct gpi_ch_handle_s {
+    uint32_t id;
+    int32_t type;
+    int32_t is_const;
+    int32_t num_elems;
+    int32_t indexable;
+    int32_t left;
+    int32_t right;
+    uint32_t null_mask;
+} gpi_ch_handle_t;
+
+typedef struct gpi_ch_register_s {
+    uint32_t id;                // Chosen by the testbench, never reused
+    uint16_t kind;
+    uint16_t edge;
+    uint32_t handle;
+    uint32_t num_samples;
+    uint64_t time;
+} gpi_ch_register_t;
+
+typedef struct gpi_ch_callback_s {
+    uint32_t id;
+    uint32_t pad;
+    uint64_t time;
+} gpi_ch_callback_t;
+
+#ifndef GPI_REMOTE_UNSUPPORTED
+
+static inline uint32_t ch_align(uint32_t len)
+{
+    return (len + 7) & ~7U;
+}
+
+/* One direction of the channel. As the producer, pos is the end of the
+ * records written but not yet published; as the consumer, the end of the
+ * records read but not yet released.
+ */
+class GpiRing {
+public:
+    GpiRing() : m_head(NULL), m_tail(NULL), m_data(NULL), m_size(0), m_pos(0) { }
+
+    void attach(uint8_t *base, uint32_t size) {
+        m_head = (uint64_t *)base;
+        m_tail = (uint64_t *)(base + 64);
+        m_data = base + GPI_CH_CONTROL_SIZE;
+        m_size = size;
+        m_pos = 0;
+    }
+
+    /* Producer */
+    bool has_space(uint32_t len) const {
+        uint32_t need = sizeof(gpi_ch_record_t) + ch_align(len);
+        uint32_t offset = (uint32_t)(m_pos & (m_size - 1));
+        if (offset + need > m_size)
+            need += m_size - offset;
+        return m_pos + need - __atomic_load_n(m_tail, __ATOMIC_ACQUIRE) <= m_size;
+    }
+
+    void *put(uint16_t type, uint16_t flags, uint32_t len) {
+        uint32_t offset = (uint32_t)(m_pos & (m_size - 1));
+        if (offset + sizeof(gpi_ch_record_t) + ch_align(len) > m_size) {
+            gpi_ch_record_t *pad = (gpi_ch_record_t *)(m_data + offset);
+            pad->len = m_size - offset - sizeof(gpi_ch_record_t);
+            pad->type = GPI_CH_PAD;
+            pad->flags = 0;
+            m_pos += m_size - offset;
+            offset = 0;
+        }
+        gpi_ch_record_t *rec = (gpi_ch_record_t *)(m_data + offset);
+        rec->len = len;
+        rec->type = type;
+        rec->flags = flags;
+        m_pos += sizeof(gpi_ch_record_t) + ch_align(len);
+        return rec + 1;
+    }
+
+    void publish() {
+        __atomic_store_n(m_head, m_pos, __ATOMIC_RELEASE);
+    }
+
+    /* Consumer */
+    gpi_ch_record_t *get(void) {
+        while (m_pos != __atomic_load_n(m_head, __ATOMIC_ACQUIRE)) {
+            gpi_ch_record_t *rec = (gpi_ch_record_t *)(m_data + (m_pos & (m_size - 1)));
+            m_pos += sizeof(gpi_ch_record_t) + ch_align(rec->len);
+            if (rec->type != GPI_CH_PAD)
+                return rec;
+        }
+        return NULL;
+    }
+
+    void release() {
+        __atomic_store_n(m_tail, m_pos, __ATOMIC_RELEASE);
+    }
+
+    uint32_t max_record(void) const {
+        return m_size / 2;
+    }
+
+private:
+    uint64_t *m_head;
+    uint64_t *m_tail;
+    uint8_t *m_data;
+    uint32_t m_size;
+    uint64_t m_pos;
+};
+
+class RemoteCb {
+public:
+    RemoteCb() : id(0), kind(0), edge(0), flags(0), time(0), sig(NULL), cb_hdl(NULL) { }
+
+    uint32_t id;
+    int kind;
+    unsigned int edge;
+    int flags;
+    uint64_t time;
+    gpi_sim_hdl sig;
+    std::vector<gpi_sim_hdl> samples;
+    gpi_sim_hdl cb_hdl;
+};
+
+static int remote_callback(const void *data);
+
+class GpiRemote {
+public:
+    GpiRemote() : m_base(NULL),
+                  m_map_size(0),
+                  m_spins(0),
+                  m_pid(-1),
+                  m_alive(false),
+                  m_stopped(false),
+                  m_ended(false),
+                  m_handles(1, (gpi_sim_hdl)NULL) { }
+
+    int start(const char *path);
+    void sim_init(gpi_sim_info_t *info);
+    void sim_event(gpi_event_t level, const char *msg);
+    void sim_end(void);
+    int fire(RemoteCb *cb);
+
+private:
+    void *post(uint16_t type, uint16_t flags, uint32_t len);
+    bool send(uint16_t type, uint16_t flags, const void *data, uint32_t len);
+    void flush(void);
+    void wait(int &polls);
+    void serve(void);
+    bool handle_request(gpi_ch_record_t *rec);
+    void reply_handle(gpi_sim_hdl hdl, uint16_t flags);
+    void reply_value(uint32_t id, uint16_t flags);
+    void register_callback(const gpi_ch_register_t *req, const uint32_t *samples);
+    void deregister_callback(uint32_t id);
+    gpi_sim_hdl lookup(uint32_t id);
+
+    uint8_t *m_base;
+    size_t m_map_size;
+    GpiRing m_requests;
+    GpiRing m_events;
+    int m_spins;
+    pid_t m_pid;
+    bool m_alive;
+    bool m_stopped;                                 // The testbench asked the simulator to stop
+    bool m_ended;
+    std::vector<gpi_sim_hdl> m_handles;             // Index is the id known by the testbench
+    std::map<gpi_sim_hdl, uint32_t> m_handle_ids;
+    std::map<uint32_t, RemoteCb *> m_callbacks;
+};
+
+int GpiRemote::start(const char *path)
+{
+    m_map_size = GPI_CH_HEADER_SIZE + 2 * (GPI_CH_CONTROL_SIZE + GPI_CH_RING_SIZE);
+
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        LOG_ERROR("Unable to create channel %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    if (ftruncate(fd, (off_t)m_map_size)) {
+        LOG_ERROR("Unable to size channel %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR("Unable to map channel %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    m_base = (uint8_t *)base;
+    uint32_t version = GPI_CH_VERSION;
+    uint32_t ring_size = GPI_CH_RING_SIZE;
+    memcpy(m_base + 8, &version, sizeof(version));
+    memcpy(m_base + 12, &ring_size, sizeof(ring_size));
+    memcpy(m_base, GPI_CH_MAGIC, 8);
+
+    m_requests.attach(m_base + GPI_CH_HEADER_SIZE, GPI_CH_RING_SIZE);
+    m_events.attach(m_base + GPI_CH_HEADER_SIZE + GPI_CH_CONTROL_SIZE + GPI_CH_RING_SIZE,
+                    GPI_CH_RING_SIZE);
+
+    m_spins = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? GPI_CH_SPINS : 0;
+
+    const char *python = getenv("COCOTB_REMOTE_PYTHON");
+    if (!python || !*python)
+        python = "python";
+
+    fflush(NULL);
+    m_pid = fork();
+    if (m_pid < 0) {
+        LOG_ERROR("Unable to start the testbench process: %s", strerror(errno));
+        return -1;
+    }
+
+    if (m_pid == 0) {
+        execlp(python, python, "-c", "import cocotb.remote; cocotb.remote.main()", (char *)NULL);
+        fprintf(stderr, "Unable to run %s: %s\n", python, strerror(errno));
+        _exit(127);
+    }
+
+    m_alive = true;
+    LOG_INFO("Testbench running in process %d over %s", (int)m_pid, path);
+    return 0;
+}
+
+/* Wait for the testbench, checking that it is still running once polling
+ * gives way to sleeping
+ */
+void GpiRemote::wait(int &polls)
+{
+    polls++;
+
+    if (polls < m_spins) {
+#if defined(__i386__) || defined(__x86_64__)
+        __asm__ __volatile__("pause");
+#endif
+        return;
+    }
+
+    if (polls < m_spins + GPI_CH_YIELDS) {
+        sched_yield();
+        return;
+    }
+
+    int status;
+    if (waitpid(m_pid, &status, WNOHANG) == m_pid) {
+        m_alive = false;
+        LOG_ERROR("Testbench process exited unexpectedly");
+        gpi_sim_end();
+        return;
+    }
+
+    usleep(GPI_CH_SLEEP_US);
+}
+
+/* Reserve an event record of len bytes for the caller to fill in. Returns
+ * NULL, posting nothing, if the record is too large for the ring or the
+ * testbench has gone.
+ */
+void *GpiRemote::post(uint16_t type, uint16_t flags, uint32_t len)
+{
+    if (len > m_events.max_record()) {
+        LOG_ERROR("Channel record of %u bytes is too large", len);
+        return NULL;
+    }
+
+    if (!m_events.has_space(len)) {
+        m_events.publish();
+        int polls = 0;
+        while (m_alive && !m_events.has_space(len))
+            wait(polls);
+    }
+
+    if (!m_alive)
+        return NULL;
+
+    return m_events.put(type, flags, len);
+}
+
+bool GpiRemote::send(uint16_t type, uint16_t flags, const void *data, uint32_t len)
+{
+    void *p = post(type, flags, len);
+
+    if (!p)
+        return false;
+    memcpy(p, data, len);
+    return true;
+}
+
+void GpiRemote::flush(void)
+{
+    m_events.publish();
+}
+
+gpi_sim_hdl GpiRemote::lookup(uint32_t id)
+{
+    if (id == 0 || id >= m_handles.size()) {
+        LOG_ERROR("Testbench used an unknown handle %u", id);
+        return NULL;
+    }
+    return m_handles[id];
+}
+
+/* Handle requests until the testbench hands control back */
+void GpiRemote::serve(void)
+{
+    int polls = 0;
+
+    flush();
+
+    while (m_alive) {
+        gpi_ch_record_t *rec = m_requests.get();
+
+        if (!rec) {
+            // Replies are only needed once the testbench is waiting for them
+            flush();
+            m_requests.release();
+            wait(polls);
+            continue;
+        }
+
+        polls = 0;
+        if (!handle_request(rec))
+            break;
+    }
+
+    m_requests.release();
+    flush();
+}
+
+bool GpiRemote::handle_request(gpi_ch_record_t *rec)
+{
+    uint8_t *payload = (uint8_t *)(rec + 1);
+    uint32_t id;
+    int32_t arg;
+
+    // Strings are always NUL terminated by the testbench
+    switch (rec->type) {
+        case GPI_CH_RESUME:
+            return false;
+
+        case GPI_CH_STOP:
+            m_stopped = true;
+            gpi_sim_end();
+            break;
+
+        case GPI_CH_LOG_LEVEL:
+            memcpy(&arg, payload, sizeof(arg));
+            set_log_level((enum gpi_log_levels)arg);
+            break;
+
+        case GPI_CH_GET_ROOT:
+            reply_handle(gpi_get_root_handle(rec->len > 1 ? (const char *)payload : NULL), 0);
+            break;
+
+        case GPI_CH_GET_BY_NAME: {
+            memcpy(&id, payload, sizeof(id));
+            gpi_sim_hdl parent = lookup(id);
+            reply_handle(parent ? gpi_get_handle_by_name(parent, (const char *)payload + 4) : NULL, 0);
+            break;
+        }
+
+        case GPI_CH_GET_BY_INDEX: {
+            memcpy(&id, payload, sizeof(id));
+            memcpy(&arg, payload + 4, sizeof(arg));
+            gpi_sim_hdl parent = lookup(id);
+            reply_handle(parent ? gpi_get_handle_by_index(parent, arg) : NULL, 0);
+            break;
+        }
+
+        case GPI_CH_ITERATE: {
+            memcpy(&id, payload, sizeof(id));
+            memcpy(&arg, payload + 4, sizeof(arg));
+            gpi_sim_hdl parent = lookup(id);
+            gpi_iterator_hdl iter = parent ? gpi_iterate(parent, (gpi_iterator_sel_t)arg) : NULL;
+            if (iter) {
+                gpi_sim_hdl child;
+                while ((child = gpi_next(iter)) != NULL)
+                    reply_handle(child, GPI_CH_MORE);
+            }
+            reply_handle(NULL, 0);
+            break;
+        }
+
+        case GPI_CH_GET_VALUE:
+            memcpy(&id, payload, sizeof(id));
+            reply_value(id, rec->flags);
+            break;
+
+        case GPI_CH_SET_LONG: {
+            int64_t value;
+            memcpy(&id, payload, sizeof(id));
+            memcpy(&value, payload + 8, sizeof(value));
+            gpi_sim_hdl hdl = lookup(id);
+            if (hdl)
+                gpi_set_signal_value_long(hdl, (long)value);
+            break;
+        }
+
+        case GPI_CH_SET_REAL: {
+            double value;
+            memcpy(&id, payload, sizeof(id));
+            memcpy(&value, payload + 8, sizeof(value));
+            gpi_sim_hdl hdl = lookup(id);
+            if (hdl)
+                gpi_set_signal_value_real(hdl, value);
+            break;
+        }
+
+        case GPI_CH_SET_STR: {
+            memcpy(&id, payload, sizeof(id));
+            gpi_sim_hdl hdl = lookup(id);
+            if (hdl)
+                gpi_set_signal_value_str(hdl, (const char *)payload + 4);
+            break;
+        }
+
+        case GPI_CH_REGISTER: {
+            gpi_ch_register_t req;
+            memcpy(&req, payload, sizeof(req));
+            register_callback(&req, (const uint32_t *)(payload + sizeof(req)));
+            break;
+        }
+
+        case GPI_CH_DEREGISTER: {
+            uint32_t i;
+            for (i = 0; i + sizeof(id) <= rec->len; i += sizeof(id)) {
+                memcpy(&id, payload + i, sizeof(id));
+                deregister_callback(id);
+            }
+            break;
+        }
+
+        default:
+            LOG_ERROR("Unknown channel request %d", rec->type);
+            break;
+    }
+
+    return true;
+}
+
+void GpiRemote::reply_handle(gpi_sim_hdl hdl, uint16_t flags)
+{
+    uint32_t none = 0;
+
+    if (!hdl) {
+        send(GPI_CH_REPLY, flags, &none, sizeof(none));
+        return;
+    }
+
+    gpi_ch_handle_t info;
+    std::map<gpi_sim_hdl, uint32_t>::iterator it = m_handle_ids.find(hdl);
+    if (it == m_handle_ids.end()) {
+        info.id = (uint32_t)m_handles.size();
+        m_handles.push_back(hdl);
+        m_handle_ids[hdl] = info.id;
+    } else {
+        info.id = it->second;
+    }
+
+    info.type = gpi_get_object_type(hdl);
+    info.is_const = gpi_is_constant(hdl);
+    info.num_elems = gpi_get_num_elems(hdl);
+    info.indexable = gpi_is_indexable(hdl);
+    info.left = info.indexable ? gpi_get_range_left(hdl) : 0;
+    info.right = info.indexable ? gpi_get_range_right(hdl) : 0;
+    info.null_mask = 0;
+
+    const char *strs[5] = {
+        gpi_get_signal_name_str(hdl),
+        gpi_get_signal_fullname_str(hdl),
+        gpi_get_signal_type_str(hdl),
+        gpi_get_definition_name(hdl),
+        gpi_get_definition_file(hdl),
+    };
+    size_t lens[5];
+    uint32_t len = sizeof(info);
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        if (!strs[i]) {
+            info.null_mask |= 1U << i;
+            strs[i] = "";
+        }
+        lens[i] = strlen(strs[i]) + 1;
+        len += (uint32_t)lens[i];
+    }
+
+    // Names too long for the ring are looked up as not found
+    uint8_t *p = (uint8_t *)post(GPI_CH_REPLY, flags, len);
+    if (!p) {
+        send(GPI_CH_REPLY, flags, &none, sizeof(none));
+        return;
+    }
+    memcpy(p, &info, sizeof(info));
+    p += sizeof(info);
+    for (i = 0; i < 5; i++) {
+        memcpy(p, strs[i], lens[i]);
+        p += lens[i];
+    }
+}
+
+/* Integers and enums are sent as an int64_t, reals as a double and
+ * everything else as a string
+ */
+void GpiRemote::reply_value(uint32_t id, uint16_t flags)
+{
+    gpi_sim_hdl hdl = lookup(id);
+    const char *str = "";
+
+    if (hdl && !(flags & GPI_CH_BINSTR)) {
+        switch (gpi_get_object_type(hdl)) {
+            case GPI_INTEGER:
+            case GPI_ENUM: {
+                int64_t value = gpi_get_signal_value_long(hdl);
+                send(GPI_CH_REPLY, 0, &value, sizeof(value));
+                return;
+            }
+            case GPI_REAL: {
+                double value = gpi_get_signal_value_real(hdl);
+                send(GPI_CH_REPLY, 0, &value, sizeof(value));
+                return;
+            }
+            case GPI_STRING:
+                str = gpi_get_signal_value_str(hdl);
+                break;
+            default:
+                str = gpi_get_signal_value_binstr(hdl);
+                break;
+        }
+    } else if (hdl) {
+        str = gpi_get_signal_value_binstr(hdl);
+    }
+
+    if (!str)
+        str = "";
+
+    // A value too long for the ring reads as an empty string
+    uint32_t len = (uint32_t)strlen(str) + 1;
+    if (!send(GPI_CH_REPLY, 0, str, len))
+        send(GPI_CH_REPLY, 0, "", 1);
+}
+
+void GpiRemote::register_callback(const gpi_ch_register_t *req, const uint32_t *samples)
+{
+    RemoteCb *cb = new RemoteCb();
+    uint32_t i;
+
+    cb->id = req->id;
+    cb->kind = req->kind;
+    cb->edge = req->edge;
+    cb->time = req->time;
+
+    if (req->kind == GPI_CH_CB_VALUE_CHANGE) {
+        cb->sig = lookup(req->handle);
+        for (i = 0; i < req->num_samples; i++) {
+            gpi_sim_hdl hdl = lookup(samples[i]);
+            if (hdl)
+                cb->samples.push_back(hdl);
+        }
+        if (req->num_samples)
+            cb->flags |= GPI_CH_SAMPLE_CB;
+    }
+
+    switch (cb->kind) {
+        case GPI_CH_CB_TIMER:
+            cb->cb_hdl = gpi_register_timed_callback(remote_callback, cb, cb->time);
+            break;
+        case GPI_CH_CB_VALUE_CHANGE:
+            if (cb->sig)
+                cb->cb_hdl = gpi_register_value_change_callback(remote_callback, cb, cb->sig, cb->edge);
+            break;
+        case GPI_CH_CB_READWRITE:
+            cb->cb_hdl = gpi_register_readwrite_callback(remote_callback, cb);
+            break;
+        case GPI_CH_CB_READONLY:
+            cb->cb_hdl = gpi_register_readonly_callback(remote_callback, cb);
+            break;
+        case GPI_CH_CB_NEXTTIME:
+            cb->cb_hdl = gpi_register_nexttime_callback(remote_callback, cb);
+            break;
+        default:
+            break;
+    }
+
+    if (!cb->cb_hdl) {
+        send(GPI_CH_FAILED, 0, &cb->id, sizeof(cb->id));
+        delete cb;
+        return;
+    }
+
+    m_callbacks[cb->id] = cb;
+}
+
+/* Callbacks which have already fired are no longer known and are ignored */
+void GpiRemote::deregister_callback(uint32_t id)
+{
+    std::map<uint32_t, RemoteCb *>::iterator it = m_callbacks.find(id);
+
+    if (it == m_callbacks.end())
+        return;
+
+    RemoteCb *cb = it->second;
+    m_callbacks.erase(it);
+    gpi_deregister_callback(cb->cb_hdl);
+    delete cb;
+}
+
+int GpiRemote::fire(RemoteCb *cb)
+{
+    uint32_t high, low;
+    gpi_get_sim_time(&high, &low);
+
+    if (!m_alive || m_ended)
+        return 0;
+
+    if (cb->flags & GPI_CH_SAMPLE_CB) {
+        std::vector<const char *> values;
+        std::vector<uint32_t> lens;
+        uint32_t len = sizeof(gpi_ch_callback_t);
+        size_t i;
+
+        for (i = 0; i < cb->samples.size(); i++) {
+            const char *value = gpi_get_signal_value_binstr(cb->samples[i]);
+            if (!value)
+                value = "";
+            values.push_back(value);
+            lens.push_back((uint32_t)strlen(value) + 1);
+            len += lens.back();
+        }
+
+        // A sample too large for the ring is dropped
+        uint8_t *p = (uint8_t *)post(GPI_CH_SAMPLE, 0, len);
+        if (p) {
+            gpi_ch_callback_t event = { cb->id, 0, ((uint64_t)high << 32) | low };
+            memcpy(p, &event, sizeof(event));
+            p += sizeof(event);
+            for (i = 0; i < values.size(); i++) {
+                memcpy(p, values[i], lens[i]);
+                p += lens[i];
+            }
+            flush();
+        }
+
+        // Stays registered until the testbench drops it
+        cb->cb_hdl = gpi_register_value_change_callback(remote_callback, cb, cb->sig, cb->edge);
+        return 0;
+    }
+
+    // Other callbacks only fire once
+    m_callbacks.erase(cb->id);
+
+    gpi_ch_callback_t event = { cb->id, 0, ((uint64_t)high << 32) | low };
+    send(GPI_CH_CALLBACK, 0, &event, sizeof(event));
+    delete cb;
+
+    serve();
+    return 0;
+}
+
+void GpiRemote::sim_init(gpi_sim_info_t *info)
+{
+    gpi_ch_init_t init;
+    uint32_t high, low;
+    uint32_t len = sizeof(init);
+    int i;
+
+    gpi_get_sim_time(&high, &low);
+    init.time = ((uint64_t)high << 32) | low;
+    gpi_get_sim_precision(&init.precision);
+    init.argc = info->argc;
+
+    const char *product = info->product ? info->product : "";
+    const char *version = info->version ? info->version : "";
+    len += (uint32_t)(strlen(product) + strlen(version) + 2);
+    for (i = 0; i < info->argc; i++)
+        len += (uint32_t)strlen(info->argv[i]) + 1;
+
+    // Arguments too long for the ring are left out
+    if (len > m_events.max_record()) {
+        for (i = 0; i < info->argc; i++)
+            len -= (uint32_t)strlen(info->argv[i]) + 1;
+        init.argc = 0;
+    }
+
+    uint8_t *p = (uint8_t *)post(GPI_CH_INIT, 0, len);
+    if (!p)
+        return;
+    memcpy(p, &init, sizeof(init));
+    p += sizeof(init);
+    memcpy(p, product, strlen(product) + 1);
+    p += strlen(product) + 1;
+    memcpy(p, version, strlen(version) + 1);
+    p += strlen(version) + 1;
+    for (i = 0; i < init.argc; i++) {
+        memcpy(p, info->argv[i], strlen(info->argv[i]) + 1);
+        p += strlen(info->argv[i]) + 1;
+    }
+
+    serve();
+}
+
+void GpiRemote::sim_event(gpi_event_t level, const char *msg)
+{
+    if (!m_alive || m_ended)
+        return;
+
+    // Messages too long for the ring are cut short
+    int32_t lvl = level;
+    size_t len = strlen(msg);
+    if (len >= m_events.max_record() - sizeof(lvl))
+        len = m_events.max_record() - sizeof(lvl) - 1;
+    uint8_t *p = (uint8_t *)post(GPI_CH_SIM_EVENT, 0, (uint32_t)(sizeof(lvl) + len + 1));
+    if (!p)
+        return;
+    memcpy(p, &lvl, sizeof(lvl));
+    memcpy(p + sizeof(lvl), msg, len);
+    p[sizeof(lvl) + len] = '\0';
+
+    serve();
+}
+
+/* Let the testbench finish up, then wait for it so that its results are
+ * written before the simulator exits
+ */
+void GpiRemote::sim_end(void)
+{
+    if (m_ended || m_pid <= 0)
+        return;
+
+    if (!m_stopped)
+        sim_event(SIM_FAIL, "Simulator shutdown prematurely");
+    m_ended = true;
+
+    if (m_alive) {
+        post(GPI_CH_END, 0, 0);
+        flush();
+
+        int status;
+        while (waitpid(m_pid, &status, 0) < 0 && errno == EINTR)
+            ;
+        m_alive = false;
+    }
+}
+
+static GpiRemote remote;
+
+static int remote_callback(const void *data)
+{
+    return remote.fire(const_cast<RemoteCb *>(static_cast<const RemoteCb *>(data)));
+}
+
+static void remote_atexit(void)
+{
+    remote.sim_end();
+}
+
+#endif /* GPI_REMOTE_UNSUPPORTED */
+
+bool gpi_remote_enabled(void)
+{
+    static int enabled = -1;
+
+    if (enabled < 0) {
+        const char *path = getenv("COCOTB_REMOTE");
+        enabled = path && *path;
+#ifdef GPI_REMOTE_UNSUPPORTED
+        if (enabled)
+            LOG_WARN("COCOTB_REMOTE is not supported on this platform, embedding Python");
+        enabled = 0;
+#endif
+    }
+
+    return enabled;
+}
+
+void gpi_remote_start(void)
+{
+#ifndef GPI_REMOTE_UNSUPPORTED
+    if (remote.start(getenv("COCOTB_REMOTE")))
+        LOG_CRITICAL("Unable to start the out-of-process testbench");
+    atexit(remote_atexit);
+#endif
+}
+
+void gpi_remote_sim_init(gpi_sim_info_t *info)
+{
+#ifndef GPI_REMOTE_UNSUPPORTED
+    remote.sim_init(info);
+#endif
+}
+
+void gpi_remote_sim_event(gpi_event_t level, const char *msg)
+{
+#ifndef GPI_REMOTE_UNSUPPORTED
+    remote.sim_event(level, msg);
+#endif
+}
+
+void gpi_remote_sim_end(void)
+{
+#ifndef GPI_REMOTE_UNSUPPORTED
+    remote.sim_end();
+#endif
+}
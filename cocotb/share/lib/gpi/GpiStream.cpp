@@ -0,0 +1,561 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* Stimulus streaming
+ *
+ * A stream maps a fixed-record binary file and drives one record onto a set of
+ * signals on each active edge of a clock, optionally comparing another set of
+ * signals against a second mapped file of expected values. Python is only
+ * called when a batch of mismatches is ready or the stream has finished.
+ *
+ * File layout, all fields little-endian:
+ *
+ *     char     magic[8]        "COCOTBSF"
+ *     uint32_t version         1
+ *     uint32_t num_fields
+ *     uint64_t num_records
+ *     uint32_t width[num_fields]   width of each field in bits
+ *     padding to a multiple of 8 bytes
+ *     records, each field packed into (width + 7) / 8 bytes, LSB first
+ */
+
+#include "gpi_priv.h"
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#if defined(__MINGW32__) || defined (__CYGWIN32__)
+#include <stdio.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define GPI_STREAM_MAGIC        "COCOTBSF"
+#define GPI_STREAM_VERSION      1
+#define GPI_STREAM_MAX_PENDING  65536
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t read_le64(const uint8_t *p)
+{
+    return (uint64_t)read_le32(p) | ((uint64_t)read_le32(p + 4) << 32);
+}
+
+class GpiStreamFile {
+public:
+    GpiStreamFile() : m_base(NULL),
+                      m_size(0),
+                      m_records(NULL),
+                      m_record_bytes(0),
+                      m_num_records(0) { }
+    ~GpiStreamFile() { unmap(); }
+
+    int open(const char *path);
+
+    const uint8_t *record(uint64_t index) const {
+        return m_records + index * m_record_bytes;
+    }
+
+    uint64_t num_records(void) const { return m_num_records; }
+    size_t num_fields(void) const { return m_widths.size(); }
+
+    std::vector<uint32_t> m_widths;     // Width of each field in bits
+    std::vector<size_t> m_offsets;      // Byte offset of each field in a record
+
+private:
+    void unmap(void);
+
+    uint8_t *m_base;
+    size_t m_size;
+    const uint8_t *m_records;
+    size_t m_record_bytes;
+    uint64_t m_num_records;
+};
+
+int GpiStreamFile::open(const char *path)
+{
+#if defined(__MINGW32__) || defined (__CYGWIN32__)
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        LOG_ERROR("GPI: Unable to open stream file %s", path);
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    m_size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    m_base = (uint8_t *)malloc(m_size ? m_size : 1);
+    if (!m_base || fread(m_base, 1, m_size, fp) != m_size) {
+        LOG_ERROR("GPI: Unable to read stream file %s", path);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("GPI: Unable to open stream file %s", path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) || st.st_size == 0) {
+        LOG_ERROR("GPI: Unable to stat stream file %s", path);
+        close(fd);
+        return -1;
+    }
+    m_size = (size_t)st.st_size;
+
+    void *base = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        LOG_ERROR("GPI: Unable to map stream file %s", path);
+        m_size = 0;
+        return -1;
+    }
+    m_base = (uint8_t *)base;
+
+    /* Records are consumed in order so let the kernel read ahead */
+    madvise(m_base, m_size, MADV_SEQUENTIAL);
+#endif
+
+    if (m_size < 24 || memcmp(m_base, GPI_STREAM_MAGIC, 8)) {
+        LOG_ERROR("GPI: %s is not a stream file", path);
+        return -1;
+    }
+
+    uint32_t version = read_le32(m_base + 8);
+    if (version != GPI_STREAM_VERSION) {
+        LOG_ERROR("GPI: Stream file %s has unsupported version %u", path, version);
+        return -1;
+    }
+
+    uint32_t num_fields = read_le32(m_base + 12);
+    m_num_records = read_le64(m_base + 16);
+
+    size_t header = 24 + (size_t)num_fields * 4;
+    header = (header + 7) & ~(size_t)7;
+    if (header > m_size) {
+        LOG_ERROR("GPI: Stream file %s has a truncated header", path);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < num_fields; i++) {
+        uint32_t width = read_le32(m_base + 24 + i * 4);
+        if (!width) {
+            LOG_ERROR("GPI: Stream file %s has a zero width field", path);
+            return -1;
+        }
+        m_widths.push_back(width);
+        m_offsets.push_back(m_record_bytes);
+        m_record_bytes += (width + 7) / 8;
+    }
+
+    if (m_record_bytes && m_num_records > (m_size - header) / m_record_bytes) {
+        LOG_ERROR("GPI: Stream file %s is truncated, header claims %llu records",
+                  path, (unsigned long long)m_num_records);
+        return -1;
+    }
+
+    m_records = m_base + header;
+
+    return 0;
+}
+
+void GpiStreamFile::unmap(void)
+{
+    if (!m_base)
+        return;
+
+#if defined(__MINGW32__) || defined (__CYGWIN32__)
+    free(m_base);
+#else
+    munmap(m_base, m_size);
+#endif
+    m_base = NULL;
+}
+
+struct GpiStreamMismatch {
+    uint64_t record;
+    uint64_t sim_time;
+    size_t field;
+    std::string expected;
+    std::string actual;
+};
+
+class GpiStream {
+public:
+    GpiStream() : m_has_expect(false),
+                  m_clk_cb(NULL),
+                  m_next(0),
+                  m_mismatches(0),
+                  m_dropped(0),
+                  m_done(false),
+                  m_in_edge(false),
+                  m_closed(false),
+                  m_batch(0),
+                  m_gpi_function(NULL),
+                  m_cb_data(NULL) { }
+    ~GpiStream();
+
+    int open(const char *stim_path,
+             const char *expect_path,
+             GpiSignalObjHdl *clk,
+             unsigned int edge,
+             std::vector<GpiSignalObjHdl*> &drive,
+             std::vector<GpiSignalObjHdl*> &check);
+    void close(void);
+    void on_edge(void);
+
+    /* Returns the data of a registration that is replaced before it fired */
+    void *set_callback(int (*gpi_function)(const void *), void *data, int batch) {
+        void *replaced = m_gpi_function ? m_cb_data : NULL;
+
+        m_gpi_function = gpi_function;
+        m_cb_data = data;
+        m_batch = batch;
+        return replaced;
+    }
+
+    void get_status(gpi_stream_status_t *status);
+    int next_mismatch(gpi_stream_mismatch_t *mismatch);
+
+    bool in_edge(void) const { return m_in_edge; }
+
+private:
+    void drive(const uint8_t *record);
+    void check(const uint8_t *record, uint64_t index);
+    void notify(void);
+
+    static int handle_clock_edge(const void *data);
+
+    GpiStreamFile m_stim;
+    GpiStreamFile m_expect;
+    bool m_has_expect;
+
+    std::vector<GpiSignalObjHdl*> m_drive;
+    std::vector<GpiSignalObjHdl*> m_check;
+    std::vector<std::string> m_drive_str;       // Per field binstr buffers for wide values
+    std::vector<std::string> m_expect_str;
+
+    GpiCbHdl *m_clk_cb;
+    uint64_t m_next;                            // Index of the next edge
+    uint64_t m_mismatches;
+    uint64_t m_dropped;
+    bool m_done;
+    bool m_in_edge;
+    bool m_closed;
+
+    std::deque<GpiStreamMismatch> m_pending;
+    GpiStreamMismatch m_last;                   // Backs the strings handed out by next_mismatch
+
+    int m_batch;
+    int (*m_gpi_function)(const void *);
+    void *m_cb_data;
+};
+
+/* Streams closed from within their own clock callback are reaped on the next
+   open or close, once the simulator has finished with the callback handle */
+static std::vector<GpiStream*> closed_streams;
+
+static void reap_closed_streams(void)
+{
+    std::vector<GpiStream*>::iterator it = closed_streams.begin();
+
+    while (it != closed_streams.end()) {
+        if ((*it)->in_edge()) {
+            it++;
+        } else {
+            delete *it;
+            it = closed_streams.erase(it);
+        }
+    }
+}
+
+GpiStream::~GpiStream()
+{
+    if (m_clk_cb) {
+        if (m_clk_cb->get_call_state() != GPI_FREE)
+            m_clk_cb->cleanup_callback();
+        delete m_clk_cb;
+    }
+}
+
+int GpiStream::open(const char *stim_path,
+                    const char *expect_path,
+                    GpiSignalObjHdl *clk,
+                    unsigned int edge,
+                    std::vector<GpiSignalObjHdl*> &drive,
+                    std::vector<GpiSignalObjHdl*> &check)
+{
+    if (m_stim.open(stim_path))
+        return -1;
+
+    if (m_stim.num_fields() != drive.size()) {
+        LOG_ERROR("GPI: Stream file %s has %u fields but %u signals to drive",
+                  stim_path, (unsigned)m_stim.num_fields(), (unsigned)drive.size());
+        return -1;
+    }
+
+    m_has_expect = (expect_path != NULL);
+    if (m_has_expect) {
+        if (m_expect.open(expect_path))
+            return -1;
+
+        if (m_expect.num_fields() != check.size()) {
+            LOG_ERROR("GPI: Stream file %s has %u fields but %u signals to check",
+                      expect_path, (unsigned)m_expect.num_fields(), (unsigned)check.size());
+            return -1;
+        }
+    }
+
+    m_drive = drive;
+    m_check = check;
+
+    for (size_t i = 0; i < m_drive.size(); i++) {
+        if (m_drive[i]->get_num_elems() != (int)m_stim.m_widths[i]) {
+            LOG_WARN("GPI: Stream field %u is %u bits wide but %s has %d elements",
+                     (unsigned)i, m_stim.m_widths[i],
+                     m_drive[i]->get_fullname_str(), m_drive[i]->get_num_elems());
+        }
+        m_drive_str.push_back(std::string(m_stim.m_widths[i], '0'));
+    }
+
+    for (size_t i = 0; i < m_check.size(); i++)
+        m_expect_str.push_back(std::string(m_expect.m_widths[i], '0'));
+
+    m_clk_cb = clk->new_value_change_cb(edge);
+    if (!m_clk_cb) {
+        LOG_ERROR("GPI: Unable to register a clock callback on %s for stream %s",
+                  clk->get_fullname_str(), stim_path);
+        return -1;
+    }
+    m_clk_cb->set_user_data(handle_clock_edge, this);
+
+    return 0;
+}
+
+void GpiStream::close(void)
+{
+    if (m_clk_cb && m_clk_cb->get_call_state() != GPI_FREE)
+        m_clk_cb->cleanup_callback();
+
+    m_done = true;
+    m_closed = true;
+    m_gpi_function = NULL;
+}
+
+int GpiStream::handle_clock_edge(const void *data)
+{
+    GpiStream *stream = const_cast<GpiStream *>(static_cast<const GpiStream *>(data));
+    stream->on_edge();
+    return 0;
+}
+
+/* Edge n drives stimulus record n and checks expected record n - 1, which
+   is the response to the stimulus driven on the previous edge */
+void GpiStream::on_edge(void)
+{
+    if (m_done)
+        return;
+
+    m_in_edge = true;
+
+    uint64_t edge = m_next++;
+
+    if (m_has_expect && edge >= 1 && edge <= m_expect.num_records())
+        check(m_expect.record(edge - 1), edge - 1);
+
+    if (edge < m_stim.num_records())
+        drive(m_stim.record(edge));
+
+    uint64_t last_check = m_has_expect ? m_expect.num_records() : 0;
+    if (edge + 1 >= m_stim.num_records() && edge >= last_check)
+        m_done = true;
+
+    /* Arm the clock callback for the next edge as an edge trigger would, the
+       implementation keeps the registration it already has with the simulator */
+    if (!m_done && m_clk_cb->arm_callback()) {
+        LOG_ERROR("GPI: Unable to re-arm the clock callback of stream %llu edges in, stopping it",
+                  (unsigned long long)m_next);
+        m_done = true;
+    }
+
+    if (m_done || (m_batch > 0 && m_pending.size() >= (size_t)m_batch))
+        notify();
+
+    m_in_edge = false;
+}
+
+void GpiStream::drive(const uint8_t *record)
+{
+    for (size_t i = 0; i < m_drive.size(); i++) {
+        const uint8_t *field = record + m_stim.m_offsets[i];
+        uint32_t width = m_stim.m_widths[i];
+
+        if (width <= 32) {
+            uint32_t value = 0;
+            for (uint32_t b = 0; b < (width + 7) / 8; b++)
+                value |= (uint32_t)field[b] << (8 * b);
+            m_drive[i]->set_signal_value((long)value);
+        } else {
+            std::string &str = m_drive_str[i];
+            for (uint32_t bit = 0; bit < width; bit++)
+                str[width - 1 - bit] = (field[bit / 8] >> (bit % 8)) & 1 ? '1' : '0';
+            m_drive[i]->set_signal_value(str);
+        }
+    }
+}
+
+void GpiStream::check(const uint8_t *record, uint64_t index)
+{
+    uint32_t high, low;
+    bool have_time = false;
+
+    for (size_t i = 0; i < m_check.size(); i++) {
+        const uint8_t *field = record + m_expect.m_offsets[i];
+        uint32_t width = m_expect.m_widths[i];
+        std::string &expected = m_expect_str[i];
+
+        for (uint32_t bit = 0; bit < width; bit++)
+            expected[width - 1 - bit] = (field[bit / 8] >> (bit % 8)) & 1 ? '1' : '0';
+
+        const char *actual = m_check[i]->get_signal_value_binstr();
+        if (actual && !strcmp(actual, expected.c_str()))
+            continue;
+
+        m_mismatches++;
+
+        if (m_pending.size() >= GPI_STREAM_MAX_PENDING) {
+            m_dropped++;
+            continue;
+        }
+
+        if (!have_time) {
+            gpi_get_sim_time(&high, &low);
+            have_time = true;
+        }
+
+        m_pending.push_back(GpiStreamMismatch());
+        GpiStreamMismatch &mismatch = m_pending.back();
+        mismatch.record = index;
+        mismatch.sim_time = ((uint64_t)high << 32) | low;
+        mismatch.field = i;
+        mismatch.expected = expected;
+        mismatch.actual = actual ? actual : "";
+    }
+}
+
+/* The registered function is one-shot, the same as any other GPI callback,
+   so it is cleared before calling in case it re-registers */
+void GpiStream::notify(void)
+{
+    int (*gpi_function)(const void *) = m_gpi_function;
+
+    if (!gpi_function)
+        return;
+
+    m_gpi_function = NULL;
+    gpi_function(m_cb_data);
+}
+
+void GpiStream::get_status(gpi_stream_status_t *status)
+{
+    status->records_driven = m_next < m_stim.num_records() ? m_next : m_stim.num_records();
+    status->records_total = m_stim.num_records();
+    status->mismatches = m_mismatches;
+    status->dropped = m_dropped;
+    status->done = m_done;
+}
+
+int GpiStream::next_mismatch(gpi_stream_mismatch_t *mismatch)
+{
+    if (m_pending.empty())
+        return 0;
+
+    m_last = m_pending.front();
+    m_pending.pop_front();
+
+    mismatch->record = m_last.record;
+    mismatch->sim_time = m_last.sim_time;
+    mismatch->name = m_check[m_last.field]->get_fullname_str();
+    mismatch->expected = m_last.expected.c_str();
+    mismatch->actual = m_last.actual.c_str();
+
+    return 1;
+}
+
+gpi_sim_hdl gpi_stream_open(const char *stim_path,
+                            const char *expect_path,
+                            gpi_sim_hdl clk_hdl,
+                            unsigned int edge,
+                            gpi_sim_hdl *drive_hdls,
+                            int num_drive,
+                            gpi_sim_hdl *check_hdls,
+                            int num_check)
+{
+    reap_closed_streams();
+
+    GpiSignalObjHdl *clk = sim_to_hdl<GpiSignalObjHdl*>(clk_hdl);
+    std::vector<GpiSignalObjHdl*> drive;
+    std::vector<GpiSignalObjHdl*> check;
+
+    for (int i = 0; i < num_drive; i++)
+        drive.push_back(sim_to_hdl<GpiSignalObjHdl*>(drive_hdls[i]));
+
+    for (int i = 0; i < num_check; i++)
+        check.push_back(sim_to_hdl<GpiSignalObjHdl*>(check_hdls[i]));
+
+    GpiStream *stream = new GpiStream();
+    if (stream->open(stim_path, expect_path, clk, edge, drive, check)) {
+        delete stream;
+        return NULL;
+    }
+
+    return (gpi_sim_hdl)stream;
+}
+
+void *gpi_stream_register_callback(gpi_sim_hdl stream_hdl,
+                                   int (*gpi_function)(const void *),
+                                   void *gpi_cb_data,
+                                   int batch)
+{
+    GpiStream *stream = sim_to_hdl<GpiStream*>(stream_hdl);
+    return stream->set_callback(gpi_function, gpi_cb_data, batch);
+}
+
+void *gpi_stream_deregister_callback(gpi_sim_hdl stream_hdl)
+{
+    GpiStream *stream = sim_to_hdl<GpiStream*>(stream_hdl);
+    return stream->set_callback(NULL, NULL, 0);
+}
+
+void gpi_stream_get_status(gpi_sim_hdl stream_hdl, gpi_stream_status_t *status)
+{
+    GpiStream *stream = sim_to_hdl<GpiStream*>(stream_hdl);
+    stream->get_status(status);
+}
+
+int gpi_stream_next_mismatch(gpi_sim_hdl stream_hdl, gpi_stream_mismatch_t *mismatch)
+{
+    GpiStream *stream = sim_to_hdl<GpiStream*>(stream_hdl);
+    return stream->next_mismatch(mismatch);
+}
+
+void *gpi_stream_close(gpi_sim_hdl stream_hdl)
+{
+    GpiStream *stream = sim_to_hdl<GpiStream*>(stream_hdl);
+    void *cb_data = stream->set_callback(NULL, NULL, 0);
+
+    stream->close();
+    closed_streams.push_back(stream);
+    reap_closed_streams();
+    return cb_data;
+}
@@ -173,16 +173,26 @@ public:
     virtual const char* get_signal_value_str(void) = 0;
     virtual double get_signal_value_real(void) = 0;
     virtual long get_signal_value_long(void) = 0;
+    // Packed as for gpi_get_signal_value_words(), implementations that can
+    // read the values without building the binary string override this
+    virtual int get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words);
 
     int m_length;
 
     virtual int set_signal_value(const long value) = 0;
     virtual int set_signal_value(const double value) = 0;
     virtual int set_signal_value(std::string &value) = 0;
+    // Set from a NUL terminated string, implementations that can pass the
+    // string straight to the simulator override this to avoid a copy
+    virtual int set_signal_value_str(const char *value);
     //virtual GpiCbHdl monitor_value(bool rising_edge) = 0; this was for the triggers
     // but the explicit ones are probably better
 
     virtual GpiCbHdl *value_change_cb(unsigned int edge) = 0;
+
+    // Returns a newly allocated and armed value change callback, separate from
+    // the shared per-edge ones above, the caller owns the returned handle
+    virtual GpiCbHdl *new_value_change_cb(unsigned int edge) { return NULL; }
 };
 
 
@@ -209,6 +219,13 @@ public:
 
     virtual ~GpiCbHdl();
 
+    // Storage is recycled through the per-size slabs in GpiCbPool.cpp
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
+
+    // Registrations made with the simulator across all implementations
+    static gpi_cb_counters_t counters;
+
 protected:
     int (*gpi_function)(const void *);    // GPI function to callback
     const void *m_cb_data;                // GPI data supplied to "gpi_function"
@@ -333,6 +350,81 @@ private:
     std::string m_name;
 };
 
+/* Flight recorder of the most recent GPI events, see GpiFlightRecorder.cpp */
+#define GPI_FR_EVENTS 4096      // Must be a power of two
+
+typedef enum gpi_fr_type_e {
+    GPI_FR_CB_FIRED = 1,        // arg: call state, value: sim time or GPI_FR_TIME_UNKNOWN
+    GPI_FR_CB_ARMED,            // arg: GPI_FR_CB_*, value: time or edge
+    GPI_FR_CB_REMOVED,
+    GPI_FR_LOOKUP,              // arg: GPI_FR_LOOKUP_*, value: name prefix or index
+    GPI_FR_WRITE_LONG,          // value: the value written
+    GPI_FR_WRITE_STR,           // value: first 8 characters written
+    GPI_FR_WRITE_REAL,          // value: bits of the double written
+    GPI_FR_SIM_END,
+    GPI_FR_EMBED_END,
+    GPI_FR_SIM_TIME,            // value: sim time read through gpi_get_sim_time()
+} gpi_fr_type_t;
+
+#define GPI_FR_TIME_UNKNOWN (~(uint64_t)0)
+
+enum {
+    GPI_FR_CB_VALUE_CHANGE,
+    GPI_FR_CB_TIMED,
+    GPI_FR_CB_READONLY,
+    GPI_FR_CB_NEXTTIME,
+    GPI_FR_CB_READWRITE,
+};
+
+enum {
+    GPI_FR_LOOKUP_ROOT,
+    GPI_FR_LOOKUP_NAME,
+    GPI_FR_LOOKUP_INDEX,
+};
+
+typedef struct gpi_fr_event_s {
+    uint32_t seq;               // Order the event was recorded in, 0 if unused
+    uint16_t type;
+    uint16_t arg;
+    uint64_t hdl;
+    uint64_t value;
+} gpi_fr_event_t;
+
+extern gpi_fr_event_t gpi_fr_ring[GPI_FR_EVENTS];
+extern uint32_t gpi_fr_seq;
+
+/* The simulator only calls into the GPI from one thread so there is a single
+ * writer and no lock is needed. seq is cleared first and set last, with
+ * compiler barriers around the rest, so a crash handler on the same thread
+ * never takes a half written event as valid.
+ */
+static inline void gpi_fr_record(uint16_t type, uint16_t arg, const void *hdl, uint64_t value)
+{
+    uint32_t seq = gpi_fr_seq++;
+    gpi_fr_event_t *event = &gpi_fr_ring[seq & (GPI_FR_EVENTS - 1)];
+
+    event->seq   = 0;
+    __asm__ __volatile__("" ::: "memory");
+    event->type  = type;
+    event->arg   = arg;
+    event->hdl   = (uint64_t)(uintptr_t)hdl;
+    event->value = value;
+    __asm__ __volatile__("" ::: "memory");
+    event->seq   = seq + 1;
+}
+
+/* The time is what the simulator handed over with the callback, if it did,
+ * so that recording costs no call back into the simulator */
+static inline void gpi_fr_record_fired(GpiCbHdl *cb_hdl, uint64_t time)
+{
+    gpi_fr_record(GPI_FR_CB_FIRED, (uint16_t)cb_hdl->get_call_state(), cb_hdl, time);
+}
+
+uint64_t gpi_fr_prefix(const char *name);
+void gpi_fr_init(void);
+void gpi_fr_dump(void);
+void gpi_fr_end(void);
+
 /* Called from implementation layers back up the stack */
 int gpi_register_impl(GpiImplInterface *func_tbl);
 
@@ -341,6 +433,14 @@ void gpi_embed_end(void);
 void gpi_embed_event(gpi_event_t level, const char *msg);
 void gpi_load_extra_libs(void);
 
+/* Out-of-process testbench, used in place of the embedded one when
+ * COCOTB_REMOTE is set */
+bool gpi_remote_enabled(void);
+void gpi_remote_start(void);
+void gpi_remote_sim_init(gpi_sim_info_t *info);
+void gpi_remote_sim_event(gpi_event_t level, const char *msg);
+void gpi_remote_sim_end(void);
+
 typedef const void (*layer_entry_func)(void);
 
 /* Use this macro in an implementation layer to define an enty point */
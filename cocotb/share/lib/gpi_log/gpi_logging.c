@@ -34,6 +34,11 @@
 // Used to log using the standard python mechanism
 static PyObject *pLogHandler;
 static PyObject *pLogFilter;
+
+/* Effective level of the cocotb.gpi logger, pushed down from Python
+ * whenever a logger level changes so that messages which would be
+ * filtered out are dropped here without taking the GIL.
+ */
 static enum gpi_log_levels local_level = GPIInfo;
 
 void set_log_handler(void *handler)
@@ -82,12 +87,166 @@ const char *log_level(long level)
   return str;
 }
 
+/* A formatted message waiting to be emitted. The name, pathname and
+ * funcname always come from string literals in the LOG_* macros so
+ * only the pointers are kept.
+ */
+#define LOG_SIZE    512
+
+typedef struct gpi_log_entry_s {
+    const char *name;
+    long level;
+    const char *pathname;
+    const char *funcname;
+    long lineno;
+    char msg[LOG_SIZE];
+} gpi_log_entry_t;
+
 // We keep this module global to avoid reallocation
 // we do not need to worry about locking here as
 // are single threaded and can not have multiple calls
 // into gpi_log at once.
-#define LOG_SIZE    512
-static char log_buff[LOG_SIZE];
+static gpi_log_entry_t log_entry;
+
+/* Optional buffered mode, enabled with COCOTB_GPI_LOG_BUFFER=<entries>
+ * and/or COCOTB_GPI_LOG_FILE=<path>. Messages are formatted into
+ * log_buffer and emitted in one batch when it fills, when a warning or
+ * worse is logged, before control passes back to Python and at the end
+ * of the simulation.
+ */
+#define LOG_BUFFER_DEFAULT  256
+
+static gpi_log_entry_t *log_buffer;
+static gpi_log_entry_t *log_spare;
+static int log_buffer_size;
+static int log_buffer_used;
+static FILE *log_file;
+static int log_buffer_checked;
+
+static void log_to_stream(FILE *stream, const gpi_log_entry_t *entry)
+{
+    int n;
+
+    fprintf(stream, "     -.--ns ");
+    fprintf(stream, "%-9s", log_level(entry->level));
+    fprintf(stream, "%-35s", entry->name);
+
+    n = strlen(entry->pathname);
+    if (n > 20) {
+        fprintf(stream, "..%18s:", (entry->pathname + (n - 18)));
+    } else {
+        fprintf(stream, "%20s:", entry->pathname);
+    }
+
+    fprintf(stream, "%-4ld", entry->lineno);
+    fprintf(stream, " in %-31s ", entry->funcname);
+    fprintf(stream, "%s", entry->msg);
+    fprintf(stream, "\n");
+}
+
+static void log_to_python(const gpi_log_entry_t *entry)
+{
+    // Ignore truncation
+    // calling args is level, filename, lineno, msg, function
+    //
+    PyObject *call_args = PyTuple_New(5);
+    PyTuple_SetItem(call_args, 0, PyLong_FromLong(entry->level));           // Note: This function steals a reference.
+    PyTuple_SetItem(call_args, 1, PyUnicode_FromString(entry->pathname));   // Note: This function steals a reference.
+    PyTuple_SetItem(call_args, 2, PyLong_FromLong(entry->lineno));          // Note: This function steals a reference.
+    PyTuple_SetItem(call_args, 3, PyUnicode_FromString(entry->msg));        // Note: This function steals a reference.
+    PyTuple_SetItem(call_args, 4, PyUnicode_FromString(entry->funcname));
+
+    PyObject *retuple = PyObject_CallObject(pLogHandler, call_args);
+
+    Py_DECREF(call_args);
+    Py_XDECREF(retuple);
+}
+
+/* Emit a batch of entries, taking the GIL at most once */
+static void log_emit(const gpi_log_entry_t *entries, int count)
+{
+    int i;
+
+    if (log_file) {
+        for (i = 0; i < count; i++)
+            log_to_stream(log_file, &entries[i]);
+        fflush(log_file);
+        return;
+    }
+
+    if (!pLogHandler || !Py_IsInitialized()) {
+        for (i = 0; i < count; i++)
+            log_to_stream(stdout, &entries[i]);
+        return;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    for (i = 0; i < count; i++)
+        log_to_python(&entries[i]);
+
+    PyGILState_Release(gstate);
+}
+
+void gpi_log_flush(void)
+{
+    gpi_log_entry_t *entries = log_buffer;
+    int count = log_buffer_used;
+
+    if (!count)
+        return;
+
+    /* Messages logged while these are emitted, by the Python handler or a
+     * GPI call it makes, go into the spare buffer. If that is being emitted
+     * already they are not buffered at all.
+     */
+    log_buffer = log_spare;
+    log_spare = NULL;
+    log_buffer_used = 0;
+
+    log_emit(entries, count);
+
+    if (log_buffer) {
+        log_spare = entries;
+    } else {
+        log_buffer = entries;
+        log_buffer_used = 0;
+    }
+}
+
+static void log_buffer_init(void)
+{
+    const char *size = getenv("COCOTB_GPI_LOG_BUFFER");
+    const char *path = getenv("COCOTB_GPI_LOG_FILE");
+
+    log_buffer_checked = 1;
+
+    if (path && *path) {
+        log_file = fopen(path, "w");
+        if (!log_file)
+            fprintf(stderr, "Unable to open %s for GPI log output\n", path);
+    }
+
+    if (size && *size)
+        log_buffer_size = atoi(size);
+    else if (log_file)
+        log_buffer_size = LOG_BUFFER_DEFAULT;
+
+    if (log_buffer_size <= 0) {
+        log_buffer_size = 0;
+        return;
+    }
+
+    log_buffer = (gpi_log_entry_t *)calloc(2 * log_buffer_size, sizeof(*log_buffer));
+    if (!log_buffer) {
+        fprintf(stderr, "Unable to allocate GPI log buffer, logging unbuffered\n");
+        log_buffer_size = 0;
+        return;
+    }
+    log_spare = log_buffer + log_buffer_size;
+
+    atexit(gpi_log_flush);
+}
 
 /**
  * @name    GPI logging
@@ -98,9 +257,11 @@ static char log_buff[LOG_SIZE];
  *
  * GILState after calling: Unknown
  *
- * Makes one call to PyGILState_Ensure and one call to PyGILState_Release
+ * Makes at most one call to PyGILState_Ensure and one call to
+ * PyGILState_Release, none if the message is below the cached level
+ * or is held in the log buffer.
  *
- * If the Python logging mechanism is not initialised, dumps to stderr.
+ * If the Python logging mechanism is not initialised, dumps to stdout.
  *
  */
 void gpi_log(const char *name, long level, const char *pathname, const char *funcname, long lineno, const char *msg, ...)
@@ -109,79 +270,37 @@ void gpi_log(const char *name, long level, const char *pathname, const char *fun
      * before going to the expense of processing the variable
      * arguments
      */
+    gpi_log_entry_t *entry;
     va_list ap;
     int n;
 
-    if (!pLogHandler) {
-        if (level >= GPIInfo) {
-            va_start(ap, msg);
-            n = vsnprintf(log_buff, LOG_SIZE, msg, ap);
-            va_end(ap);
-
-            if (n < 0) {
-               fprintf(stderr, "Log message construction failed\n");
-            }
-
-            fprintf(stdout, "     -.--ns ");
-            fprintf(stdout, "%-9s", log_level(level));
-            fprintf(stdout, "%-35s", name);
-
-            n = strlen(pathname);
-            if (n > 20) {
-                fprintf(stdout, "..%18s:", (pathname + (n - 18)));
-            } else {
-                fprintf(stdout, "%20s:", pathname);
-            }
-
-            fprintf(stdout, "%-4ld", lineno);
-            fprintf(stdout, " in %-31s ", funcname);
-            fprintf(stdout, "%s", log_buff);
-            fprintf(stdout, "\n");
-        }
-        return;
-    }
-
     if (level < local_level)
         return;
 
-    // Ignore truncation
-    // calling args is level, filename, lineno, msg, function
-    //
-    PyGILState_STATE gstate = PyGILState_Ensure();
-
-    PyObject *check_args = PyTuple_New(1);
-    PyTuple_SetItem(check_args, 0, PyLong_FromLong(level));
-    PyObject *retuple = PyObject_CallObject(pLogFilter, check_args);
+    if (!log_buffer_checked)
+        log_buffer_init();
 
-    if (retuple != Py_True) {
-        Py_DECREF(check_args);
-        PyGILState_Release(gstate);
-        return;
-    }
+    entry = log_buffer ? &log_buffer[log_buffer_used++] : &log_entry;
 
-    Py_DECREF(retuple);
-    Py_DECREF(check_args);
+    entry->name = name;
+    entry->level = level;
+    entry->pathname = pathname;
+    entry->funcname = funcname;
+    entry->lineno = lineno;
 
     va_start(ap, msg);
-    n = vsnprintf(log_buff, LOG_SIZE, msg, ap);
+    n = vsnprintf(entry->msg, LOG_SIZE, msg, ap);
     va_end(ap);
 
-    PyObject *call_args = PyTuple_New(5);
-    PyTuple_SetItem(call_args, 0, PyLong_FromLong(level));           // Note: This function steals a reference.
-    PyTuple_SetItem(call_args, 1, PyUnicode_FromString(pathname));   // Note: This function steals a reference.
-    PyTuple_SetItem(call_args, 2, PyLong_FromLong(lineno));          // Note: This function steals a reference.
-    PyTuple_SetItem(call_args, 3, PyUnicode_FromString(log_buff));   // Note: This function steals a reference.
-    PyTuple_SetItem(call_args, 4, PyUnicode_FromString(funcname));
-
-    retuple = PyObject_CallObject(pLogHandler, call_args);
+    if (n < 0) {
+       fprintf(stderr, "Log message construction failed\n");
+    }
 
-    if (retuple != Py_True) {
-        PyGILState_Release(gstate);
+    if (!log_buffer) {
+        log_emit(entry, 1);
         return;
     }
 
-    Py_DECREF(call_args);
-    Py_DECREF(retuple);
-
-    PyGILState_Release(gstate);
+    if (log_buffer_used == log_buffer_size || level >= GPIWarning)
+        gpi_log_flush();
 }
@@ -0,0 +1,677 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/**
+* @file   schedulercore.c
+* @brief  Native event loop for cocotb.scheduler.Scheduler
+*
+* Works through the triggers fired while reacting exactly as
+* Scheduler._dispatch does, on the scheduler's own containers. Waking a
+* coroutine, sending it the trigger and making it wait on the trigger it
+* yields next are done here; everything else calls back into the Scheduler.
+*/
+
+#include "schedulercore.h"
+
+#if PY_MAJOR_VERSION >= 3
+#define INTERN PyUnicode_InternFromString
+#else
+#define INTERN PyString_InternFromString
+#endif
+
+// Consumed triggers are dropped from the front of the pending list in one go
+// once there are this many
+#define PENDING_COMPACT 1024
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *scheduler;
+    PyObject *react;
+    PyObject *trigger2coros;
+    PyObject *coro2trigger;
+    PyObject *pending_triggers;
+    PyObject *pending_events;
+    PyObject *pending_coros;
+    PyObject *pending_callbacks;
+    PyObject *pending_threads;
+    PyObject *gpi_to_prime;
+} scheduler_core_object;
+
+// Classes and attribute names, looked up when the first core is created
+static PyObject *trigger_cls;
+static PyObject *gpi_trigger_cls;
+static PyObject *test_complete_cls;
+static PyObject *return_value_cls;
+static PyObject *coroutine_complete_cls;
+static PyObject *running_coroutine_cls;
+static PyObject *value_cls;
+static PyObject *error_cls;
+
+// Trigger._outcome, RunningCoroutine._advance and GPITrigger._callback_spec,
+// and for each type seen whether it still uses them
+static PyObject *base_outcome;
+static PyObject *base_advance;
+static PyObject *base_callback_spec;
+static PyObject *outcome_cache;
+static PyObject *advance_cache;
+static PyObject *callback_spec_cache;
+
+static PyObject *str_advance;
+static PyObject *str_after_schedule;
+static PyObject *str_callback_spec;
+static PyObject *str_coro;
+static PyObject *str_finish_test;
+static PyObject *str_func;
+static PyObject *str_is_reacting;
+static PyObject *str_late_gpi_trigger;
+static PyObject *str_no_waiters;
+static PyObject *str_outcome;
+static PyObject *str_prime;
+static PyObject *str_prime_failed;
+static PyObject *str_primed;
+static PyObject *str_retval;
+static PyObject *str_schedule_result;
+static PyObject *str_send;
+static PyObject *str_set;
+static PyObject *str_started;
+static PyObject *str_terminate;
+static PyObject *str_unprime;
+static PyObject *str_unschedule;
+static PyObject *str_value;
+
+static PyObject *import_attr(const char *module_name, const char *name)
+{
+    PyObject *module = PyImport_ImportModule(module_name);
+    PyObject *attr;
+
+    if (module == NULL)
+        return NULL;
+    attr = PyObject_GetAttrString(module, name);
+    Py_DECREF(module);
+    return attr;
+}
+
+// The plain function behind a method, as Python 2 hands out unbound methods
+static PyObject *function_of(PyObject *method)
+{
+    PyObject *func = PyObject_GetAttr(method, str_func);
+
+    if (func != NULL)
+        return func;
+    if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+        return NULL;
+    PyErr_Clear();
+    Py_INCREF(method);
+    return method;
+}
+
+static int core_init_globals(void)
+{
+    PyObject *cls;
+    PyObject *advance;
+    PyObject *spec;
+
+    if (trigger_cls != NULL)
+        return 0;
+
+#define NAME(var, s) if ((var = INTERN(s)) == NULL) return -1
+    NAME(str_advance, "_advance");
+    NAME(str_after_schedule, "_after_schedule");
+    NAME(str_callback_spec, "_callback_spec");
+    NAME(str_coro, "_coro");
+    NAME(str_finish_test, "finish_test");
+    NAME(str_func, "__func__");
+    NAME(str_is_reacting, "_is_reacting");
+    NAME(str_late_gpi_trigger, "_late_gpi_trigger");
+    NAME(str_no_waiters, "_no_waiters");
+    NAME(str_outcome, "_outcome");
+    NAME(str_prime, "prime");
+    NAME(str_prime_failed, "_prime_failed");
+    NAME(str_primed, "primed");
+    NAME(str_retval, "retval");
+    NAME(str_schedule_result, "_schedule_result");
+    NAME(str_send, "send");
+    NAME(str_set, "set");
+    NAME(str_started, "_started");
+    NAME(str_terminate, "_terminate");
+    NAME(str_unprime, "unprime");
+    NAME(str_unschedule, "unschedule");
+    NAME(str_value, "value");
+#undef NAME
+
+    if ((outcome_cache = PyDict_New()) == NULL ||
+        (advance_cache = PyDict_New()) == NULL ||
+        (callback_spec_cache = PyDict_New()) == NULL)
+        return -1;
+
+    if ((gpi_trigger_cls = import_attr("cocotb.triggers", "GPITrigger")) == NULL ||
+        (test_complete_cls = import_attr("cocotb.result", "TestComplete")) == NULL ||
+        (return_value_cls = import_attr("cocotb.result", "ReturnValue")) == NULL ||
+        (coroutine_complete_cls = import_attr("cocotb.decorators", "CoroutineComplete")) == NULL ||
+        (running_coroutine_cls = import_attr("cocotb.decorators", "RunningCoroutine")) == NULL ||
+        (value_cls = import_attr("cocotb.outcomes", "Value")) == NULL ||
+        (error_cls = import_attr("cocotb.outcomes", "Error")) == NULL)
+        return -1;
+
+    if ((spec = PyObject_GetAttr(gpi_trigger_cls, str_callback_spec)) == NULL)
+        return -1;
+    base_callback_spec = function_of(spec);
+    Py_DECREF(spec);
+    if (base_callback_spec == NULL)
+        return -1;
+
+    if ((cls = import_attr("cocotb.triggers", "Trigger")) == NULL)
+        return -1;
+    if ((base_outcome = PyObject_GetAttr(cls, str_outcome)) == NULL ||
+        (advance = PyObject_GetAttr(running_coroutine_cls, str_advance)) == NULL) {
+        Py_DECREF(cls);
+        return -1;
+    }
+    base_advance = function_of(advance);
+    Py_DECREF(advance);
+    if (base_advance == NULL) {
+        Py_DECREF(cls);
+        return -1;
+    }
+
+    // Set last as it marks the lookups above as done
+    trigger_cls = cls;
+    return 0;
+}
+
+static int is_a(PyObject *obj, PyObject *cls)
+{
+    return PyType_IsSubtype(Py_TYPE(obj), (PyTypeObject *)cls);
+}
+
+/* Whether instances of the type of obj still get attribute name from the
+   base class, which is what found. Returns -1 on error. */
+static int uses_base(PyObject *cache, PyObject *obj, PyObject *name, PyObject *found)
+{
+    PyObject *type = (PyObject *)Py_TYPE(obj);
+    PyObject *cached = PyDict_GetItem(cache, type);
+    PyObject *attr;
+    PyObject *func;
+    int same;
+
+    if (cached != NULL)
+        return cached == Py_True;
+
+    if ((attr = PyObject_GetAttr(type, name)) == NULL)
+        return -1;
+    func = function_of(attr);
+    Py_DECREF(attr);
+    if (func == NULL)
+        return -1;
+    same = func == found;
+    Py_DECREF(func);
+
+    if (PyDict_SetItem(cache, type, same ? Py_True : Py_False) < 0)
+        return -1;
+    return same;
+}
+
+static PyObject *call_method(PyObject *obj, PyObject *name, PyObject *arg1, PyObject *arg2)
+{
+    return PyObject_CallMethodObjArgs(obj, name, arg1, arg2, NULL);
+}
+
+/* Call a method and drop what it returns. Returns -1 on error. */
+static int call_method_void(PyObject *obj, PyObject *name, PyObject *arg1, PyObject *arg2)
+{
+    PyObject *res = PyObject_CallMethodObjArgs(obj, name, arg1, arg2, NULL);
+
+    if (res == NULL)
+        return -1;
+    Py_DECREF(res);
+    return 0;
+}
+
+static int attr_true(PyObject *obj, PyObject *name)
+{
+    PyObject *attr = PyObject_GetAttr(obj, name);
+    int truth;
+
+    if (attr == NULL)
+        return -1;
+    truth = PyObject_IsTrue(attr);
+    Py_DECREF(attr);
+    return truth;
+}
+
+/* The exception being raised, normalised and with its traceback attached,
+   clearing it. */
+static PyObject *take_exception(void)
+{
+    PyObject *type, *value, *tb;
+
+    PyErr_Fetch(&type, &value, &tb);
+    PyErr_NormalizeException(&type, &value, &tb);
+#if PY_MAJOR_VERSION >= 3
+    if (tb != NULL && value != NULL)
+        PyException_SetTraceback(value, tb);
+#endif
+    Py_XDECREF(type);
+    Py_XDECREF(tb);
+    if (value == NULL) {
+        Py_INCREF(Py_None);
+        value = Py_None;
+    }
+    return value;
+}
+
+/* Send value into a generator. Returns what it yielded, otherwise NULL with
+   *retval set to what it returned or an exception raised. */
+static PyObject *gen_send(PyObject *gen, PyObject *value, PyObject **retval)
+{
+#if PY_VERSION_HEX >= 0x030A0000
+    PyObject *result;
+
+    switch (PyIter_Send(gen, value, &result)) {
+        case PYGEN_NEXT:
+            return result;
+        case PYGEN_RETURN:
+            *retval = result;
+            return NULL;
+        default:
+            return NULL;
+    }
+#else
+    (void)retval;
+    return PyObject_CallMethodObjArgs(gen, str_send, value, NULL);
+#endif
+}
+
+/* Resume a coroutine with the outcome of trigger, as
+   RunningCoroutine._advance does. Returns what it yielded. When it finishes
+   its outcome is stored and NULL is returned with *done set, otherwise NULL
+   means an exception was raised. */
+static PyObject *core_advance(PyObject *coro, PyObject *trigger, int *done)
+{
+    PyObject *outcome = NULL;
+    PyObject *result = NULL;
+    PyObject *retval = NULL;
+    PyObject *gen;
+    int plain_outcome;
+    int plain_advance;
+
+    if ((plain_outcome = uses_base(outcome_cache, trigger, str_outcome, base_outcome)) < 0)
+        return NULL;
+    if (!plain_outcome && (outcome = PyObject_GetAttr(trigger, str_outcome)) == NULL)
+        return NULL;
+
+    if ((plain_advance = uses_base(advance_cache, coro, str_advance, base_advance)) < 0)
+        goto out;
+    if (!plain_advance) {
+        if (outcome == NULL &&
+            (outcome = PyObject_CallFunctionObjArgs(value_cls, trigger, NULL)) == NULL)
+            goto out;
+        result = call_method(coro, str_advance, outcome, NULL);
+        goto out;
+    }
+
+    if (PyObject_SetAttr(coro, str_started, Py_True) < 0)
+        goto out;
+    if ((gen = PyObject_GetAttr(coro, str_coro)) == NULL)
+        goto out;
+    // Trigger._outcome is Value(trigger), so the trigger itself is sent
+    if (outcome == NULL)
+        result = gen_send(gen, trigger, &retval);
+    else
+        result = call_method(outcome, str_send, gen, NULL);
+    Py_DECREF(gen);
+    if (result != NULL)
+        goto out;
+
+    // Finished, keep the outcome as RunningCoroutine._advance would
+    Py_CLEAR(outcome);
+    if (retval == NULL) {
+        if (PyErr_ExceptionMatches(return_value_cls)) {
+            PyObject *exc = take_exception();
+            retval = PyObject_GetAttr(exc, str_retval);
+            Py_DECREF(exc);
+            if (retval == NULL)
+                goto out;
+        } else if (PyErr_ExceptionMatches(PyExc_StopIteration)) {
+            PyObject *exc = take_exception();
+            retval = PyObject_GetAttr(exc, str_value);
+            Py_DECREF(exc);
+            if (retval == NULL) {
+                if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+                    goto out;
+                PyErr_Clear();
+                Py_INCREF(Py_None);
+                retval = Py_None;
+            }
+        } else {
+            PyObject *exc = take_exception();
+            outcome = PyObject_CallFunctionObjArgs(error_cls, exc, NULL);
+            Py_DECREF(exc);
+        }
+    }
+    if (retval != NULL)
+        outcome = PyObject_CallFunctionObjArgs(value_cls, retval, NULL);
+    if (outcome != NULL && PyObject_SetAttr(coro, str_outcome, outcome) == 0)
+        *done = 1;
+
+out:
+    Py_XDECREF(outcome);
+    Py_XDECREF(retval);
+    return result;
+}
+
+/* Make coro wait on trigger, as Scheduler._coroutine_yielded does. */
+static int core_wait(scheduler_core_object *self, PyObject *coro, PyObject *trigger)
+{
+    PyObject *waiting;
+    PyObject *res;
+    int primed;
+
+    if (PyDict_SetItem(self->coro2trigger, coro, trigger) < 0)
+        return -1;
+
+    if ((waiting = PyDict_GetItem(self->trigger2coros, trigger)) != NULL) {
+        if (PyList_Append(waiting, coro) < 0)
+            return -1;
+    } else {
+        if ((waiting = PyList_New(1)) == NULL)
+            return -1;
+        Py_INCREF(coro);
+        PyList_SET_ITEM(waiting, 0, coro);
+        if (PyDict_SetItem(self->trigger2coros, trigger, waiting) < 0) {
+            Py_DECREF(waiting);
+            return -1;
+        }
+        Py_DECREF(waiting);
+    }
+
+    if ((primed = attr_true(trigger, str_primed)) != 0)
+        return primed < 0 ? -1 : 0;
+
+    // Only triggers with their own _callback_spec can be registered in a
+    // batch, others such as StreamEvent are primed straight away
+    if (is_a(trigger, gpi_trigger_cls)) {
+        int reacting = attr_true(self->scheduler, str_is_reacting);
+        int plain_spec;
+        if (reacting < 0)
+            return -1;
+        if (reacting) {
+            plain_spec = uses_base(callback_spec_cache, trigger, str_callback_spec,
+                                   base_callback_spec);
+            if (plain_spec < 0)
+                return -1;
+            if (!plain_spec)
+                return PyList_Append(self->gpi_to_prime, trigger);
+        }
+    }
+
+    if ((res = call_method(trigger, str_prime, self->react, NULL)) != NULL) {
+        Py_DECREF(res);
+        return 0;
+    }
+    if (PyErr_ExceptionMatches(PyExc_Exception)) {
+        PyObject *exc = take_exception();
+        int rc = call_method_void(self->scheduler, str_prime_failed, trigger, exc);
+        Py_DECREF(exc);
+        return rc;
+    }
+    return -1;
+}
+
+static int any_pending(scheduler_core_object *self)
+{
+    return PyList_GET_SIZE(self->pending_threads) ||
+           PyList_GET_SIZE(self->pending_coros) ||
+           PyList_GET_SIZE(self->pending_callbacks);
+}
+
+/* Wake coro with trigger, as Scheduler.schedule does. */
+static int core_schedule(scheduler_core_object *self, PyObject *coro, PyObject *trigger)
+{
+    int done = 0;
+    int terminate;
+    int rc;
+    PyObject *result = core_advance(coro, trigger, &done);
+
+    if (result == NULL) {
+        if (done)
+            return call_method_void(self->scheduler, str_unschedule, coro, NULL);
+        if (PyErr_ExceptionMatches(test_complete_cls)) {
+            PyObject *exc = take_exception();
+            rc = call_method_void(self->scheduler, str_finish_test, exc, NULL);
+            Py_DECREF(exc);
+            return rc;
+        }
+        if (PyErr_ExceptionMatches(coroutine_complete_cls)) {
+            PyErr_Clear();
+            return call_method_void(self->scheduler, str_unschedule, coro, NULL);
+        }
+        return -1;
+    }
+
+    if ((terminate = attr_true(self->scheduler, str_terminate)) != 0) {
+        Py_DECREF(result);
+        return terminate < 0 ? -1 : 0;
+    }
+
+    if (is_a(result, trigger_cls))
+        rc = core_wait(self, coro, result);
+    else
+        rc = call_method_void(self->scheduler, str_schedule_result, coro, result);
+    Py_DECREF(result);
+    if (rc < 0)
+        return -1;
+
+    if (any_pending(self))
+        return call_method_void(self->scheduler, str_after_schedule, NULL, NULL);
+    return 0;
+}
+
+/* Wake everything waiting on trigger. */
+static int core_fire(scheduler_core_object *self, PyObject *trigger)
+{
+    PyObject *scheduling = PyDict_GetItem(self->trigger2coros, trigger);
+    Py_ssize_t i;
+    int rc = 0;
+
+    if (scheduling == NULL)
+        return call_method_void(self->scheduler, str_no_waiters, trigger, NULL);
+
+    // Scheduled coroutines may append to our waiting list so the first
+    // thing to do is pop all entries waiting on this trigger.
+    Py_INCREF(scheduling);
+    if (PyDict_DelItem(self->trigger2coros, trigger) < 0 ||
+        call_method_void(trigger, str_unprime, NULL, NULL) < 0) {
+        Py_DECREF(scheduling);
+        return -1;
+    }
+
+    for (i = 0; rc == 0 && i < PyList_GET_SIZE(scheduling); i++) {
+        PyObject *coro = PyList_GET_ITEM(scheduling, i);
+        Py_INCREF(coro);
+        rc = core_schedule(self, coro, trigger);
+        Py_DECREF(coro);
+    }
+    Py_DECREF(scheduling);
+
+    // Schedule may have queued up some events so we'll burn through those
+    while (rc == 0 && PyList_GET_SIZE(self->pending_events)) {
+        PyObject *event = PyList_GET_ITEM(self->pending_events, 0);
+        Py_INCREF(event);
+        if ((rc = PyList_SetSlice(self->pending_events, 0, 1, NULL)) == 0)
+            rc = call_method_void(event, str_set, NULL, NULL);
+        Py_DECREF(event);
+    }
+    return rc;
+}
+
+static PyObject *scheduler_core_dispatch(scheduler_core_object *self, PyObject *trigger)
+{
+    PyObject *pending = self->pending_triggers;
+    Py_ssize_t next = 0;
+    int rc = 0;
+
+    if (PyList_Append(pending, trigger) < 0)
+        return NULL;
+
+    // Walked with a cursor rather than popping each trigger off the front
+    while (rc == 0 && next < PyList_GET_SIZE(pending)) {
+        PyObject *fired = PyList_GET_ITEM(pending, next);
+        Py_INCREF(fired);
+
+        if (next++ > 0 && is_a(fired, gpi_trigger_cls))
+            rc = call_method_void(self->scheduler, str_late_gpi_trigger, fired, NULL);
+        if (rc == 0)
+            rc = core_fire(self, fired);
+        Py_DECREF(fired);
+
+        if (rc == 0 && next >= PENDING_COMPACT && next * 2 >= PyList_GET_SIZE(pending)) {
+            rc = PyList_SetSlice(pending, 0, next, NULL);
+            next = 0;
+        }
+    }
+
+    if (rc < 0) {
+        // Drop what was handled, keeping the error for the caller
+        PyObject *type, *value, *tb;
+
+        PyErr_Fetch(&type, &value, &tb);
+        if (next > PyList_GET_SIZE(pending))
+            next = PyList_GET_SIZE(pending);
+        PyList_SetSlice(pending, 0, next, NULL);
+        PyErr_Restore(type, value, tb);
+        return NULL;
+    }
+    if (PyList_SetSlice(pending, 0, next, NULL) < 0)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+static int scheduler_core_init(scheduler_core_object *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *scheduler;
+
+    (void)kwds;
+    if (!PyArg_ParseTuple(args, "O:SchedulerCore", &scheduler))
+        return -1;
+    if (core_init_globals() < 0)
+        return -1;
+
+#define TAKE(field, name, check)                                                \
+    do {                                                                        \
+        PyObject *attr = PyObject_GetAttrString(scheduler, name);               \
+        if (attr == NULL)                                                       \
+            return -1;                                                          \
+        if (!check(attr)) {                                                     \
+            PyErr_Format(PyExc_TypeError, "Scheduler." name " has the wrong type"); \
+            Py_DECREF(attr);                                                    \
+            return -1;                                                          \
+        }                                                                       \
+        Py_XDECREF(self->field);                                                \
+        self->field = attr;                                                     \
+    } while (0)
+#define ANY(attr) 1
+    TAKE(react, "react", ANY);
+    TAKE(trigger2coros, "_trigger2coros", PyDict_Check);
+    TAKE(coro2trigger, "_coro2trigger", PyDict_Check);
+    TAKE(pending_triggers, "_pending_triggers", PyList_Check);
+    TAKE(pending_events, "_pending_events", PyList_Check);
+    TAKE(pending_coros, "_pending_coros", PyList_Check);
+    TAKE(pending_callbacks, "_pending_callbacks", PyList_Check);
+    TAKE(pending_threads, "_pending_threads", PyList_Check);
+    TAKE(gpi_to_prime, "_gpi_to_prime", PyList_Check);
+#undef ANY
+#undef TAKE
+
+    Py_INCREF(scheduler);
+    Py_XDECREF(self->scheduler);
+    self->scheduler = scheduler;
+    return 0;
+}
+
+static int scheduler_core_traverse(scheduler_core_object *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->scheduler);
+    Py_VISIT(self->react);
+    Py_VISIT(self->trigger2coros);
+    Py_VISIT(self->coro2trigger);
+    Py_VISIT(self->pending_triggers);
+    Py_VISIT(self->pending_events);
+    Py_VISIT(self->pending_coros);
+    Py_VISIT(self->pending_callbacks);
+    Py_VISIT(self->pending_threads);
+    Py_VISIT(self->gpi_to_prime);
+    return 0;
+}
+
+static int scheduler_core_clear(scheduler_core_object *self)
+{
+    Py_CLEAR(self->scheduler);
+    Py_CLEAR(self->react);
+    Py_CLEAR(self->trigger2coros);
+    Py_CLEAR(self->coro2trigger);
+    Py_CLEAR(self->pending_triggers);
+    Py_CLEAR(self->pending_events);
+    Py_CLEAR(self->pending_coros);
+    Py_CLEAR(self->pending_callbacks);
+    Py_CLEAR(self->pending_threads);
+    Py_CLEAR(self->gpi_to_prime);
+    return 0;
+}
+
+static void scheduler_core_dealloc(scheduler_core_object *self)
+{
+    PyObject_GC_UnTrack(self);
+    scheduler_core_clear(self);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyMethodDef scheduler_core_methods[] = {
+    {"dispatch", (PyCFunction)scheduler_core_dispatch, METH_O,
+     "dispatch(trigger)\nSchedule the coroutines waiting on a trigger that fired, "
+     "then those waiting on any triggers that fire as a result, until none are left."},
+    {NULL, NULL, 0, NULL}
+};
+
+PyTypeObject scheduler_core_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "simulator.SchedulerCore",                  /* tp_name */
+    sizeof(scheduler_core_object),              /* tp_basicsize */
+    0,                                          /* tp_itemsize */
+    (destructor)scheduler_core_dealloc,         /* tp_dealloc */
+    0,                                          /* tp_print */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_compare */
+    0,                                          /* tp_repr */
+    0,                                          /* tp_as_number */
+    0,                                          /* tp_as_sequence */
+    0,                                          /* tp_as_mapping */
+    0,                                          /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    0,                                          /* tp_getattro */
+    0,                                          /* tp_setattro */
+    0,                                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,    /* tp_flags */
+    "Event loop of a cocotb.scheduler.Scheduler", /* tp_doc */
+    (traverseproc)scheduler_core_traverse,      /* tp_traverse */
+    (inquiry)scheduler_core_clear,              /* tp_clear */
+    0,                                          /* tp_richcompare */
+    0,                                          /* tp_weaklistoffset */
+    0,                                          /* tp_iter */
+    0,                                          /* tp_iternext */
+    scheduler_core_methods,                     /* tp_methods */
+    0,                                          /* tp_members */
+    0,                                          /* tp_getset */
+    0,                                          /* tp_base */
+    0,                                          /* tp_dict */
+    0,                                          /* tp_descr_get */
+    0,                                          /* tp_descr_set */
+    0,                                          /* tp_dictoffset */
+    (initproc)scheduler_core_init,              /* tp_init */
+    0,                                          /* tp_alloc */
+    PyType_GenericNew,                          /* tp_new */
+};
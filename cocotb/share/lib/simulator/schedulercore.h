@@ -0,0 +1,14 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef _SCHEDULER_CORE_H
+#define _SCHEDULER_CORE_H
+
+#include <Python.h>
+
+// Dispatches fired triggers to the coroutines waiting on them for
+// cocotb.scheduler.Scheduler, added to the simulator module as SchedulerCore
+extern PyTypeObject scheduler_core_type;
+
+#endif
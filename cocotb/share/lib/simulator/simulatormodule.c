@@ -38,12 +38,27 @@ static int takes = 0;
 static int releases = 0;
 
 #include "simulatormodule.h"
+#include "schedulercore.h"
 #include <cocotb_utils.h>
+#include <time.h>
 
 typedef int (*gpi_function_t)(const void *);
 
+/* With hold_gil(True) the simulator thread keeps the GIL when a callback
+   returns, saving a lock hand-over and thread state swap on every callback.
+   The scheduler only asks for this while no external threads are pending,
+   as nothing else can run Python until the GIL is released again. */
+static int gil_hold = 0;
+static int gil_held = 0;
+static PyGILState_STATE gil_held_state;
+
 PyGILState_STATE TAKE_GIL(void)
 {
+    if (gil_held) {
+        gil_held = 0;
+        return gil_held_state;
+    }
+
     PyGILState_STATE state = PyGILState_Ensure();
     takes ++;
     return state;
@@ -51,10 +66,42 @@ PyGILState_STATE TAKE_GIL(void)
 
 void DROP_GIL(PyGILState_STATE state)
 {
+    if (gil_hold) {
+        gil_held_state = state;
+        gil_held = 1;
+        return;
+    }
+
     PyGILState_Release(state);
     releases++;
 }
 
+/* Wall time spent running Python callbacks, and in the simulator between
+   returning from one callback and the next one firing. The simulator time
+   is put down to the kind of callback that ended the wait. */
+static const char *cb_kind_names[CB_KIND_MAX] = {
+    "Timer",
+    "ValueChange",
+    "ReadWrite",
+    "ReadOnly",
+    "NextTimeStep",
+};
+
+static struct {
+    uint64_t calls;
+    uint64_t python_ns;
+    uint64_t sim_ns;
+} cb_times[CB_KIND_MAX];
+
+static uint64_t cb_returned_ns = 0;
+
+static uint64_t cb_time_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
 struct sim_time {
     uint32_t high;
     uint32_t low;
@@ -66,6 +113,11 @@ static struct sim_time cache_time;
 // can be used by PyArg_ParseTuple format O&.
 static int gpi_sim_hdl_converter(PyObject *o, gpi_sim_hdl *data)
 {
+    if (Py_TYPE(o) == &sim_hdl_type) {
+        *data = ((sim_hdl_object *)o)->hdl;
+        return 1;
+    }
+
     void *p = PyLong_AsVoidPtr(o);
     if ((p == NULL) && PyErr_Occurred()) {
         return 0;
@@ -93,6 +145,29 @@ static int gpi_iterator_hdl_converter(PyObject *o, gpi_iterator_hdl *data)
     return 1;
 }
 
+/* Callback data is allocated for every trigger that is primed and freed
+   when it fires, so a few blocks are kept for reuse instead of going back
+   to malloc each time. */
+#define CB_DATA_FREE_MAX    64
+
+static p_callback_data cb_data_free[CB_DATA_FREE_MAX];
+static int cb_data_free_count = 0;
+
+static p_callback_data callback_data_alloc(void)
+{
+    if (cb_data_free_count)
+        return cb_data_free[--cb_data_free_count];
+    return (p_callback_data)malloc(sizeof(s_callback_data));
+}
+
+static void callback_data_free(p_callback_data callback_data_p)
+{
+    if (cb_data_free_count < CB_DATA_FREE_MAX)
+        cb_data_free[cb_data_free_count++] = callback_data_p;
+    else
+        free(callback_data_p);
+}
+
 /**
  * @name    Callback Handling
  * @brief   Handle a callback coming from GPI
@@ -131,9 +206,18 @@ int handle_gpi_callback(void *user_data)
     }
     callback_data_p->id_value = COCOTB_INACTIVE_ID;
 
+    int kind = callback_data_p->kind;
+    uint64_t entered_ns = cb_time_now();
+    if (cb_returned_ns)
+        cb_times[kind].sim_ns += entered_ns - cb_returned_ns;
+    cb_times[kind].calls++;
+
     /* Cache the sim time */
     gpi_get_sim_time(&cache_time.high, &cache_time.low);
 
+    /* Keep buffered GPI messages in order with Python output */
+    gpi_log_flush();
+
     PyGILState_STATE gstate;
     gstate = TAKE_GIL();
 
@@ -175,12 +259,15 @@ int handle_gpi_callback(void *user_data)
         Py_DECREF(callback_data_p->args);
 
         // Free the callback data
-        free(callback_data_p);
+        callback_data_free(callback_data_p);
     }
 
 out:
     DROP_GIL(gstate);
 
+    cb_returned_ns = cb_time_now();
+    cb_times[kind].python_ns += cb_returned_ns - entered_ns;
+
 err:
     to_simulator();
     return ret;
@@ -203,51 +290,78 @@ static PyObject *log_msg(PyObject *self, PyObject *args)
 }
 
 
-// Register a callback for read only state of sim
-// First argument is the function to call
-// Remaining arguments are keyword arguments to be passed to the callback
-static PyObject *register_readonly_callback(PyObject *self, PyObject *args)
+// Check the number of arguments passed to a fast call, max of -1 for
+// functions taking any number of trailing arguments
+static int check_nargs(const char *name, Py_ssize_t nargs, Py_ssize_t min, Py_ssize_t max)
 {
-    FENTER
+    if (nargs >= min && (max < 0 || nargs <= max)) {
+        return 1;
+    }
 
-    PyObject *fArgs;
-    PyObject *function;
-    gpi_sim_hdl hdl;
+    PyErr_Format(PyExc_TypeError, "%s() takes %s %zd arguments (%zd given)",
+                 name, max < 0 ? "at least" : "exactly", min, nargs);
+    return 0;
+}
 
+// Set up the user data for a callback to function with the remaining
+// arguments of a fast call, NULL with an exception set on failure
+static p_callback_data callback_data_new(PyObject *function, PyObject *const *args, Py_ssize_t nargs, int kind)
+{
     p_callback_data callback_data_p;
+    PyObject *fArgs;
+    Py_ssize_t i;
 
-    Py_ssize_t numargs = PyTuple_Size(args);
-
-    if (numargs < 1) {
-        fprintf(stderr, "Attempt to register ReadOnly callback with!\n");
-        return NULL;
-    }
-
-    // Extract the callback function
-    function = PyTuple_GetItem(args, 0);
     if (!PyCallable_Check(function)) {
-        fprintf(stderr, "Attempt to register ReadOnly without supplying a callback!\n");
+        PyErr_SetString(PyExc_TypeError, "Attempt to register a callback without passing a callable callback");
         return NULL;
     }
-    Py_INCREF(function);
 
-    // Remaining args for function
-    fArgs = PyTuple_GetSlice(args, 1, numargs);   // New reference
+    fArgs = PyTuple_New(nargs);
     if (fArgs == NULL) {
         return NULL;
     }
+    for (i = 0; i < nargs; i++) {
+        Py_INCREF(args[i]);
+        PyTuple_SET_ITEM(fArgs, i, args[i]);
+    }
 
-    callback_data_p = (p_callback_data)malloc(sizeof(s_callback_data));
+    callback_data_p = callback_data_alloc();
     if (callback_data_p == NULL) {
-        return PyErr_NoMemory();
+        Py_DECREF(fArgs);
+        PyErr_NoMemory();
+        return NULL;
     }
 
     // Set up the user data (no more python API calls after this!)
+    Py_INCREF(function);
     callback_data_p->_saved_thread_state = PyThreadState_Get();
     callback_data_p->id_value = COCOTB_ACTIVE_ID;
     callback_data_p->function = function;
     callback_data_p->args = fArgs;
     callback_data_p->kwargs = NULL;
+    callback_data_p->kind = kind;
+
+    return callback_data_p;
+}
+
+// Register a callback for read only state of sim
+// First argument is the function to call
+// Remaining arguments are keyword arguments to be passed to the callback
+static PyObject *register_readonly_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    FENTER
+
+    gpi_sim_hdl hdl;
+    p_callback_data callback_data_p;
+
+    if (!check_nargs("register_readonly_callback", nargs, 1, -1)) {
+        return NULL;
+    }
+
+    callback_data_p = callback_data_new(args[0], args + 1, nargs - 1, CB_KIND_READONLY);
+    if (callback_data_p == NULL) {
+        return NULL;
+    }
 
     hdl = gpi_register_readonly_callback((gpi_function_t)handle_gpi_callback, callback_data_p);
 
@@ -258,49 +372,22 @@ static PyObject *register_readonly_callback(PyObject *self, PyObject *args)
 }
 
 
-static PyObject *register_rwsynch_callback(PyObject *self, PyObject *args)
+static PyObject *register_rwsynch_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     FENTER
 
-    PyObject *fArgs;
-    PyObject *function;
     gpi_sim_hdl hdl;
-
     p_callback_data callback_data_p;
 
-    Py_ssize_t numargs = PyTuple_Size(args);
-
-    if (numargs < 1) {
-        fprintf(stderr, "Attempt to register ReadOnly callback with!\n");
-        return NULL;
-    }
-
-    // Extract the callback function
-    function = PyTuple_GetItem(args, 0);
-    if (!PyCallable_Check(function)) {
-        fprintf(stderr, "Attempt to register ReadOnly without supplying a callback!\n");
-        return NULL;
-    }
-    Py_INCREF(function);
-
-    // Remaining args for function
-    fArgs = PyTuple_GetSlice(args, 1, numargs);   // New reference
-    if (fArgs == NULL) {
+    if (!check_nargs("register_rwsynch_callback", nargs, 1, -1)) {
         return NULL;
     }
 
-    callback_data_p = (p_callback_data)malloc(sizeof(s_callback_data));
+    callback_data_p = callback_data_new(args[0], args + 1, nargs - 1, CB_KIND_READWRITE);
     if (callback_data_p == NULL) {
-        return PyErr_NoMemory();
+        return NULL;
     }
 
-    // Set up the user data (no more python API calls after this!)
-    callback_data_p->_saved_thread_state = PyThreadState_Get();
-    callback_data_p->id_value = COCOTB_ACTIVE_ID;
-    callback_data_p->function = function;
-    callback_data_p->args = fArgs;
-    callback_data_p->kwargs = NULL;
-
     hdl = gpi_register_readwrite_callback((gpi_function_t)handle_gpi_callback, callback_data_p);
 
     PyObject *rv = PyLong_FromVoidPtr(hdl);
@@ -310,49 +397,22 @@ static PyObject *register_rwsynch_callback(PyObject *self, PyObject *args)
 }
 
 
-static PyObject *register_nextstep_callback(PyObject *self, PyObject *args)
+static PyObject *register_nextstep_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     FENTER
 
-    PyObject *fArgs;
-    PyObject *function;
     gpi_sim_hdl hdl;
-
     p_callback_data callback_data_p;
 
-    Py_ssize_t numargs = PyTuple_Size(args);
-
-    if (numargs < 1) {
-        fprintf(stderr, "Attempt to register ReadOnly callback with!\n");
-        return NULL;
-    }
-
-    // Extract the callback function
-    function = PyTuple_GetItem(args, 0);
-    if (!PyCallable_Check(function)) {
-        fprintf(stderr, "Attempt to register ReadOnly without supplying a callback!\n");
-        return NULL;
-    }
-    Py_INCREF(function);
-
-    // Remaining args for function
-    fArgs = PyTuple_GetSlice(args, 1, numargs);   // New reference
-    if (fArgs == NULL) {
+    if (!check_nargs("register_nextstep_callback", nargs, 1, -1)) {
         return NULL;
     }
 
-    callback_data_p = (p_callback_data)malloc(sizeof(s_callback_data));
+    callback_data_p = callback_data_new(args[0], args + 1, nargs - 1, CB_KIND_NEXTTIME);
     if (callback_data_p == NULL) {
-        return PyErr_NoMemory();
+        return NULL;
     }
 
-    // Set up the user data (no more python API calls after this!)
-    callback_data_p->_saved_thread_state = PyThreadState_Get();
-    callback_data_p->id_value = COCOTB_ACTIVE_ID;
-    callback_data_p->function = function;
-    callback_data_p->args = fArgs;
-    callback_data_p->kwargs = NULL;
-
     hdl = gpi_register_nexttime_callback((gpi_function_t)handle_gpi_callback, callback_data_p);
 
     PyObject *rv = PyLong_FromVoidPtr(hdl);
@@ -366,54 +426,29 @@ static PyObject *register_nextstep_callback(PyObject *self, PyObject *args)
 // First argument should be the time in picoseconds
 // Second argument is the function to call
 // Remaining arguments and keyword arguments are to be passed to the callback
-static PyObject *register_timed_callback(PyObject *self, PyObject *args)
+static PyObject *register_timed_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     FENTER
 
-    PyObject *fArgs;
-    PyObject *function;
     gpi_sim_hdl hdl;
     uint64_t time_ps;
-
     p_callback_data callback_data_p;
 
-    Py_ssize_t numargs = PyTuple_Size(args);
-
-    if (numargs < 2) {
-        fprintf(stderr, "Attempt to register timed callback without enough arguments!\n");
+    if (!check_nargs("register_timed_callback", nargs, 2, -1)) {
         return NULL;
     }
 
     // Extract the time
-    PyObject *pTime = PyTuple_GetItem(args, 0);
-    time_ps = PyLong_AsLongLong(pTime);
-
-    // Extract the callback function
-    function = PyTuple_GetItem(args, 1);
-    if (!PyCallable_Check(function)) {
-        fprintf(stderr, "Attempt to register timed callback without passing a callable callback!\n");
-        return NULL;
-    }
-    Py_INCREF(function);
-
-    // Remaining args for function
-    fArgs = PyTuple_GetSlice(args, 2, numargs);   // New reference
-    if (fArgs == NULL) {
+    time_ps = PyLong_AsLongLong(args[0]);
+    if (PyErr_Occurred()) {
         return NULL;
     }
 
-    callback_data_p = (p_callback_data)malloc(sizeof(s_callback_data));
+    callback_data_p = callback_data_new(args[1], args + 2, nargs - 2, CB_KIND_TIMER);
     if (callback_data_p == NULL) {
-        return PyErr_NoMemory();
+        return NULL;
     }
 
-    // Set up the user data (no more python API calls after this!)
-    callback_data_p->_saved_thread_state = PyThreadState_Get();
-    callback_data_p->id_value = COCOTB_ACTIVE_ID;
-    callback_data_p->function = function;
-    callback_data_p->args = fArgs;
-    callback_data_p->kwargs = NULL;
-
     hdl = gpi_register_timed_callback((gpi_function_t)handle_gpi_callback, callback_data_p, time_ps);
 
     // Check success
@@ -424,75 +459,244 @@ static PyObject *register_timed_callback(PyObject *self, PyObject *args)
 }
 
 
+// Register a value change callback on sig_hdl, the arguments are the
+// function to call, the edge and the arguments to pass to the function
+static PyObject *value_change_callback(gpi_sim_hdl sig_hdl, PyObject *const *args, Py_ssize_t nargs)
+{
+    gpi_sim_hdl hdl;
+    unsigned int edge;
+    p_callback_data callback_data_p;
+
+    edge = (unsigned int)PyLong_AsLong(args[1]);
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+
+    callback_data_p = callback_data_new(args[0], args + 2, nargs - 2, CB_KIND_VALUE_CHANGE);
+    if (callback_data_p == NULL) {
+        return NULL;
+    }
+
+    hdl = gpi_register_value_change_callback((gpi_function_t)handle_gpi_callback,
+                                             callback_data_p,
+                                             sig_hdl,
+                                             edge);
+
+    // Check success
+    return PyLong_FromVoidPtr(hdl);
+}
+
 // Register signal change callback
 // First argument should be the signal handle
 // Second argument is the function to call
 // Remaining arguments and keyword arguments are to be passed to the callback
-static PyObject *register_value_change_callback(PyObject *self, PyObject *args) //, PyObject *keywds)
+static PyObject *register_value_change_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     FENTER
 
-    PyObject *fArgs;
-    PyObject *function;
     gpi_sim_hdl sig_hdl;
-    gpi_sim_hdl hdl;
-    unsigned int edge;
-
-    p_callback_data callback_data_p;
 
-    Py_ssize_t numargs = PyTuple_Size(args);
+    if (!check_nargs("register_value_change_callback", nargs, 3, -1)) {
+        return NULL;
+    }
 
-    if (numargs < 3) {
-        fprintf(stderr, "Attempt to register value change callback without enough arguments!\n");
+    if (!gpi_sim_hdl_converter(args[0], &sig_hdl)) {
         return NULL;
     }
 
-    PyObject *pSihHdl = PyTuple_GetItem(args, 0);
-    if (!gpi_sim_hdl_converter(pSihHdl, &sig_hdl)) {
+    PyObject *rv = value_change_callback(sig_hdl, args + 1, nargs - 1);
+    FEXIT
+
+    return rv;
+}
+
+
+// Register one callback per entry of a list of specs, all calling the same
+// function. Each spec is a tuple of the callback kind, the signal handle for
+// a value change (None otherwise), the edge or time in picoseconds (None
+// otherwise) and any arguments for the function. Returns a list of callback
+// handles, 0 where the GPI could not register the callback. A bad spec raises
+// an exception with none of the callbacks left registered.
+typedef struct t_registered_cb {
+    gpi_sim_hdl hdl;
+    p_callback_data callback_data;
+} s_registered_cb;
+
+static PyObject *register_callbacks(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    FENTER
+
+    PyObject *specs;
+    PyObject *function;
+    PyObject *result;
+    Py_ssize_t num, i;
+    s_registered_cb *registered;
+
+    if (!check_nargs("register_callbacks", nargs, 2, 2)) {
         return NULL;
     }
 
-    // Extract the callback function
-    function = PyTuple_GetItem(args, 1);
+    function = args[1];
     if (!PyCallable_Check(function)) {
-        fprintf(stderr, "Attempt to register value change callback without passing a callable callback!\n");
+        PyErr_SetString(PyExc_TypeError, "Attempt to register callbacks without passing a callable callback");
         return NULL;
     }
-    Py_INCREF(function);
-
-    PyObject *pedge = PyTuple_GetItem(args, 2);
-    edge = (unsigned int)PyLong_AsLong(pedge);
 
-    // Remaining args for function
-    fArgs = PyTuple_GetSlice(args, 3, numargs);   // New reference
-    if (fArgs == NULL) {
+    specs = PySequence_Fast(args[0], "expected a sequence of callback specs");
+    if (specs == NULL) {
         return NULL;
     }
 
+    num = PySequence_Fast_GET_SIZE(specs);
+    result = PyList_New(num);
+    if (result == NULL) {
+        Py_DECREF(specs);
+        return NULL;
+    }
 
-    callback_data_p = (p_callback_data)malloc(sizeof(s_callback_data));
-    if (callback_data_p == NULL) {
+    registered = (s_registered_cb *)malloc(sizeof(s_registered_cb) * (num ? num : 1));
+    if (registered == NULL) {
+        Py_DECREF(specs);
+        Py_DECREF(result);
         return PyErr_NoMemory();
     }
 
-    // Set up the user data (no more python API calls after this!)
-    // Causes segfault?
-    callback_data_p->_saved_thread_state = PyThreadState_Get();//PyThreadState_Get();
-    callback_data_p->id_value = COCOTB_ACTIVE_ID;
-    callback_data_p->function = function;
-    callback_data_p->args = fArgs;
-    callback_data_p->kwargs = NULL;
+    for (i = 0; i < num; i++) {
+        PyObject *spec = PySequence_Fast_GET_ITEM(specs, i);
+        PyObject *const *items;
+        Py_ssize_t nitems;
+        p_callback_data callback_data_p;
+        gpi_sim_hdl sig_hdl = NULL;
+        gpi_sim_hdl hdl = NULL;
+        long kind;
+
+        if (!PyTuple_Check(spec) || PyTuple_GET_SIZE(spec) < 3) {
+            PyErr_SetString(PyExc_TypeError, "callback spec must be a tuple of (kind, handle, edge or time, *args)");
+            goto err;
+        }
+        items = &PyTuple_GET_ITEM(spec, 0);
+        nitems = PyTuple_GET_SIZE(spec);
 
-    hdl = gpi_register_value_change_callback((gpi_function_t)handle_gpi_callback,
-                                             callback_data_p,
-                                             sig_hdl,
-                                             edge);
+        kind = PyLong_AsLong(items[0]);
+        if (PyErr_Occurred()) {
+            goto err;
+        }
+        if (kind < 0 || kind >= CB_KIND_MAX) {
+            PyErr_Format(PyExc_ValueError, "unknown callback kind %ld", kind);
+            goto err;
+        }
 
-    // Check success
-    PyObject *rv = PyLong_FromVoidPtr(hdl);
+        if (kind == CB_KIND_VALUE_CHANGE && !gpi_sim_hdl_converter(items[1], &sig_hdl)) {
+            goto err;
+        }
+
+        callback_data_p = callback_data_new(function, items + 3, nitems - 3, (int)kind);
+        if (callback_data_p == NULL) {
+            goto err;
+        }
+
+        switch (kind) {
+            case CB_KIND_TIMER: {
+                uint64_t time_ps = PyLong_AsUnsignedLongLong(items[2]);
+                if (PyErr_Occurred()) {
+                    break;
+                }
+                hdl = gpi_register_timed_callback((gpi_function_t)handle_gpi_callback, callback_data_p, time_ps);
+                break;
+            }
+            case CB_KIND_VALUE_CHANGE: {
+                unsigned int edge = (unsigned int)PyLong_AsLong(items[2]);
+                if (PyErr_Occurred()) {
+                    break;
+                }
+                hdl = gpi_register_value_change_callback((gpi_function_t)handle_gpi_callback,
+                                                         callback_data_p, sig_hdl, edge);
+                break;
+            }
+            case CB_KIND_READWRITE:
+                hdl = gpi_register_readwrite_callback((gpi_function_t)handle_gpi_callback, callback_data_p);
+                break;
+            case CB_KIND_READONLY:
+                hdl = gpi_register_readonly_callback((gpi_function_t)handle_gpi_callback, callback_data_p);
+                break;
+            case CB_KIND_NEXTTIME:
+                hdl = gpi_register_nexttime_callback((gpi_function_t)handle_gpi_callback, callback_data_p);
+                break;
+        }
+
+        if (hdl == NULL) {
+            // Nothing will call back with this data
+            Py_DECREF(callback_data_p->function);
+            Py_DECREF(callback_data_p->args);
+            callback_data_free(callback_data_p);
+            if (PyErr_Occurred()) {
+                goto err;
+            }
+            callback_data_p = NULL;
+        }
+
+        registered[i].hdl = hdl;
+        registered[i].callback_data = callback_data_p;
+        PyObject *item = PyLong_FromVoidPtr(hdl);
+        if (item == NULL) {
+            i++;
+            goto err;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+
+    free(registered);
+    Py_DECREF(specs);
     FEXIT
+    return result;
 
-    return rv;
+err:
+    // The batch is all or nothing, so the callbacks registered before the
+    // failing spec are removed again. None of them can have fired yet.
+    while (i-- > 0) {
+        if (registered[i].hdl != NULL) {
+            gpi_deregister_callback(registered[i].hdl);
+            Py_DECREF(registered[i].callback_data->function);
+            Py_DECREF(registered[i].callback_data->args);
+            callback_data_free(registered[i].callback_data);
+        }
+    }
+    free(registered);
+    Py_DECREF(specs);
+    Py_DECREF(result);
+    return NULL;
+}
+
+// Deregister every callback handle in a sequence
+static PyObject *deregister_callbacks(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *hdls;
+    Py_ssize_t num, i;
+    gpi_sim_hdl hdl;
+
+    FENTER
+
+    if (!check_nargs("deregister_callbacks", nargs, 1, 1)) {
+        return NULL;
+    }
+
+    hdls = PySequence_Fast(args[0], "expected a sequence of callback handles");
+    if (hdls == NULL) {
+        return NULL;
+    }
+
+    num = PySequence_Fast_GET_SIZE(hdls);
+    for (i = 0; i < num; i++) {
+        if (!gpi_sim_hdl_converter(PySequence_Fast_GET_ITEM(hdls, i), &hdl)) {
+            Py_DECREF(hdls);
+            return NULL;
+        }
+        gpi_deregister_callback(hdl);
+    }
+
+    Py_DECREF(hdls);
+    FEXIT
+    Py_RETURN_NONE;
 }
 
 
@@ -515,13 +719,12 @@ static PyObject *iterate(PyObject *self, PyObject *args)
 }
 
 
-static PyObject *next(PyObject *self, PyObject *args)
+static PyObject *next(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_iterator_hdl hdl;
     gpi_sim_hdl result;
-    PyObject *res;
 
-    if (!PyArg_ParseTuple(args, "O&", gpi_iterator_hdl_converter, &hdl)) {
+    if (!check_nargs("next", nargs, 1, 1) || !gpi_iterator_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
@@ -540,124 +743,595 @@ static PyObject *next(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    res = PyLong_FromVoidPtr(result);
-
-    return res;
+    return sim_hdl_new(result);
 }
 
 
-static PyObject *get_signal_val_binstr(PyObject *self, PyObject *args)
+static PyObject *get_signal_val_binstr(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
-    const char *result;
-    PyObject *retstr;
 
-    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &hdl)) {
+    if (!check_nargs("get_signal_val_binstr", nargs, 1, 1) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
-    result = gpi_get_signal_value_binstr(hdl);
-    retstr = Py_BuildValue("s", result);
-
-    return retstr;
+    return Py_BuildValue("s", gpi_get_signal_value_binstr(hdl));
 }
 
-static PyObject *get_signal_val_str(PyObject *self, PyObject *args)
+static PyObject *get_signal_val_str(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
-    const char *result;
-    PyObject *retstr;
 
-    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &hdl)) {
+    if (!check_nargs("get_signal_val_str", nargs, 1, 1) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
-    result = gpi_get_signal_value_str(hdl);
-    retstr = Py_BuildValue("s", result);
-
-    return retstr;
+    return Py_BuildValue("s", gpi_get_signal_value_str(hdl));
 }
 
-static PyObject *get_signal_val_real(PyObject *self, PyObject *args)
+static PyObject *get_signal_val_real(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
-    double result;
-    PyObject *retval;
 
-    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &hdl)) {
+    if (!check_nargs("get_signal_val_real", nargs, 1, 1) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
-    result = gpi_get_signal_value_real(hdl);
-    retval = Py_BuildValue("d", result);
-
-    return retval;
+    return PyFloat_FromDouble(gpi_get_signal_value_real(hdl));
 }
 
 
-static PyObject *get_signal_val_long(PyObject *self, PyObject *args)
+static PyObject *get_signal_val_long(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
-    long result;
-    PyObject *retval;
 
-    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &hdl)) {
+    if (!check_nargs("get_signal_val_long", nargs, 1, 1) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
-    result = gpi_get_signal_value_long(hdl);
-    retval = Py_BuildValue("l", result);
-
-    return retval;
+    return PyLong_FromLong(gpi_get_signal_value_long(hdl));
 }
 
 
-static PyObject *set_signal_val_str(PyObject *self, PyObject *args)
+static PyObject *set_signal_val_str(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
     const char *binstr;
-    PyObject *res;
 
-    if (!PyArg_ParseTuple(args, "O&s", gpi_sim_hdl_converter, &hdl, &binstr)) {
+    if (!check_nargs("set_signal_val_str", nargs, 2, 2) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
-    gpi_set_signal_value_str(hdl, binstr);
-    res = Py_BuildValue("s", "OK!");
+    if (!PyArg_Parse(args[1], "s", &binstr)) {
+        return NULL;
+    }
 
-    return res;
+    gpi_set_signal_value_str(hdl, binstr);
+    Py_RETURN_NONE;
 }
 
-static PyObject *set_signal_val_real(PyObject *self, PyObject *args)
+static PyObject *set_signal_val_real(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
     double value;
-    PyObject *res;
 
-    if (!PyArg_ParseTuple(args, "O&d", gpi_sim_hdl_converter, &hdl, &value)) {
+    if (!check_nargs("set_signal_val_real", nargs, 2, 2) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
-    gpi_set_signal_value_real(hdl, value);
-    res = Py_BuildValue("s", "OK!");
+    value = PyFloat_AsDouble(args[1]);
+    if (value == -1.0 && PyErr_Occurred()) {
+        return NULL;
+    }
 
-    return res;
+    gpi_set_signal_value_real(hdl, value);
+    Py_RETURN_NONE;
 }
 
-static PyObject *set_signal_val_long(PyObject *self, PyObject *args)
+static PyObject *set_signal_val_long(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
     long value;
-    PyObject *res;
 
-    if (!PyArg_ParseTuple(args, "O&l", gpi_sim_hdl_converter, &hdl, &value)) {
+    if (!check_nargs("set_signal_val_long", nargs, 2, 2) || !gpi_sim_hdl_converter(args[0], &hdl)) {
+        return NULL;
+    }
+
+    value = PyLong_AsLong(args[1]);
+    if (value == -1 && PyErr_Occurred()) {
         return NULL;
     }
 
     gpi_set_signal_value_long(hdl, value);
-    res = Py_BuildValue("s", "OK!");
+    Py_RETURN_NONE;
+}
 
-    return res;
+// X, Z and friends in a read follow COCOTB_RESOLVE_X as BinaryValue does
+enum resolve_x_e {
+    RESOLVE_VALUE_ERROR,
+    RESOLVE_ZEROS,
+    RESOLVE_ONES,
+    RESOLVE_RANDOM
+};
+
+static int resolve_x = -1;
+
+static int get_resolve_x(void)
+{
+    if (resolve_x < 0) {
+        const char *env = getenv("COCOTB_RESOLVE_X");
+
+        if (env && !strcmp(env, "ZEROS"))
+            resolve_x = RESOLVE_ZEROS;
+        else if (env && !strcmp(env, "ONES"))
+            resolve_x = RESOLVE_ONES;
+        else if (env && !strcmp(env, "RANDOM"))
+            resolve_x = RESOLVE_RANDOM;
+        else
+            resolve_x = RESOLVE_VALUE_ERROR;
+    }
+    return resolve_x;
+}
+
+// Scratch space for converting between Python ints and binary strings,
+// grown as needed and kept since the same widths are seen repeatedly
+static unsigned char *int_scratch;
+static size_t int_scratch_size;
+
+static unsigned char *get_int_scratch(size_t size)
+{
+    if (size > int_scratch_size) {
+        unsigned char *grown = (unsigned char *)realloc(int_scratch, size);
+        if (grown == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        int_scratch = grown;
+        int_scratch_size = size;
+    }
+    return int_scratch;
+}
+
+// Read the value of a signal of any width as an unsigned int. The value is
+// fetched packed into words, without a binary string, and X, Z and friends
+// are resolved from it following COCOTB_RESOLVE_X. Integers and enumerations
+// are read directly, reals, strings and objects without a vector value give
+// None.
+static PyObject *get_signal_val_int(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    gpi_sim_hdl hdl;
+    int width, num_words, bits, word, bit;
+    uint32_t unknown = 0;
+
+    if (!check_nargs("get_signal_val_int", nargs, 1, 1) || !gpi_sim_hdl_converter(args[0], &hdl)) {
+        return NULL;
+    }
+
+    switch (gpi_get_object_type(hdl)) {
+        case GPI_INTEGER:
+        case GPI_ENUM:
+            return PyLong_FromLong(gpi_get_signal_value_long(hdl));
+        case GPI_REAL:
+        case GPI_STRING:
+            Py_RETURN_NONE;
+        default:
+            break;
+    }
+
+    width = gpi_get_num_elems(hdl);
+    num_words = width > 0 ? (width + 31) / 32 : 1;
+
+    // aval and bval words, then room for the value as a string in an error
+    uint32_t *aval = (uint32_t *)get_int_scratch((sizeof(uint32_t) * 2 + 32) * (size_t)num_words + 1);
+    if (aval == NULL) {
+        return NULL;
+    }
+    uint32_t *bval = aval + num_words;
+
+    bits = gpi_get_signal_value_words(hdl, aval, bval, num_words);
+    if (bits < 0) {
+        Py_RETURN_NONE;
+    }
+
+    for (word = 0; word < num_words; word++) {
+        unknown |= bval[word];
+    }
+
+    if (unknown) {
+        switch (get_resolve_x()) {
+            case RESOLVE_ZEROS:
+                for (word = 0; word < num_words; word++)
+                    aval[word] &= ~bval[word];
+                break;
+            case RESOLVE_ONES:
+                for (word = 0; word < num_words; word++)
+                    aval[word] |= bval[word];
+                break;
+            case RESOLVE_RANDOM:
+                for (bit = 0; bit < bits; bit++) {
+                    uint32_t mask = (uint32_t)1 << (bit % 32);
+                    if (bval[bit / 32] & mask) {
+                        aval[bit / 32] = (aval[bit / 32] & ~mask) | (rand() & 1 ? mask : 0);
+                    }
+                }
+                break;
+            default: {
+                // Report the value as BinaryValue would
+                char *binstr = (char *)(bval + num_words);
+                for (bit = 0; bit < bits; bit++) {
+                    uint32_t mask = (uint32_t)1 << (bit % 32);
+                    int plane = (aval[bit / 32] & mask ? 1 : 0) | (bval[bit / 32] & mask ? 2 : 0);
+                    binstr[bits - bit - 1] = "01ZX"[plane];
+                }
+                binstr[bits] = '\0';
+                PyErr_Format(PyExc_ValueError, "Unable to resolve to binary >%s<", binstr);
+                return NULL;
+            }
+        }
+    }
+
+    if (bits <= 64) {
+        unsigned long long value = aval[0];
+        if (num_words > 1) {
+            value |= (unsigned long long)aval[1] << 32;
+        }
+        return PyLong_FromUnsignedLongLong(value);
+    }
+
+    // Little endian bytes, whatever the byte order of the words
+    unsigned char *bytes = (unsigned char *)bval;
+    for (word = 0; word < num_words; word++) {
+        uint32_t value = aval[word];
+        bytes[4 * word]     = (unsigned char)value;
+        bytes[4 * word + 1] = (unsigned char)(value >> 8);
+        bytes[4 * word + 2] = (unsigned char)(value >> 16);
+        bytes[4 * word + 3] = (unsigned char)(value >> 24);
+    }
+
+    return _PyLong_FromByteArray(bytes, 4 * (size_t)num_words, 1, 0);
+}
+
+// Write a non-negative int of any width, raising OverflowError if it is
+// negative or does not fit in the signal
+static PyObject *set_hdl_val_int(gpi_sim_hdl hdl, PyObject *arg)
+{
+    PyObject *value;
+    size_t width, num_bytes, i;
+    int rc;
+
+    width = (size_t)gpi_get_num_elems(hdl);
+    num_bytes = (width + 7) / 8;
+
+    unsigned char *bytes = get_int_scratch(num_bytes + width + 1);
+    if (bytes == NULL) {
+        return NULL;
+    }
+    char *binstr = (char *)bytes + num_bytes;
+
+    value = PyNumber_Long(arg);         // New reference
+    if (value == NULL) {
+        return NULL;
+    }
+#if PY_VERSION_HEX >= 0x030D0000
+    rc = _PyLong_AsByteArray((PyLongObject *)value, bytes, num_bytes, 1, 0, 1);
+#else
+    rc = _PyLong_AsByteArray((PyLongObject *)value, bytes, num_bytes, 1, 0);
+#endif
+    Py_DECREF(value);
+    if (rc < 0) {
+        return NULL;
+    }
+
+    if (width % 8 && (bytes[num_bytes - 1] >> (width % 8))) {
+        PyErr_SetString(PyExc_OverflowError, "int too big to fit in signal");
+        return NULL;
+    }
+
+    for (i = 0; i < width; i++) {
+        size_t bit = width - 1 - i;
+        binstr[i] = (bytes[bit / 8] >> (bit % 8)) & 1 ? '1' : '0';
+    }
+    binstr[width] = '\0';
+
+    gpi_set_signal_value_str(hdl, binstr);
+    Py_RETURN_NONE;
+}
+
+static PyObject *set_signal_val_int(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    gpi_sim_hdl hdl;
+
+    if (!check_nargs("set_signal_val_int", nargs, 2, 2) || !gpi_sim_hdl_converter(args[0], &hdl)) {
+        return NULL;
+    }
+
+    if (!PyLong_Check(args[1]) && !PyInt_Check(args[1])) {
+        PyErr_SetString(PyExc_TypeError, "set_signal_val_int() requires an int");
+        return NULL;
+    }
+
+    return set_hdl_val_int(hdl, args[1]);
+}
+
+/* Bulk access to arrays of integer elements through the buffer protocol.
+ * Item i of the buffer is the element i places from the left index of the
+ * array. Items of 1, 2, 4 or 8 bytes are used in native byte order and are
+ * signed if the buffer format is (b, h, i, l or q), so bytearray, array,
+ * memoryview and numpy.ndarray can all be passed without copying.
+ */
+
+// Elements of an array handle, looked up once and kept on the handle
+static sim_hdl_elem *array_elements(PyObject *o, int *count)
+{
+    sim_hdl_object *obj = (sim_hdl_object *)o;
+
+    if (Py_TYPE(o) != &sim_hdl_type) {
+        PyErr_SetString(PyExc_TypeError, "expected a gpi_sim_hdl");
+        return NULL;
+    }
+
+    if (obj->elems == NULL) {
+        if (!gpi_is_indexable(obj->hdl)) {
+            PyErr_Format(PyExc_TypeError, "%s is not indexable",
+                         gpi_get_signal_fullname_str(obj->hdl));
+            return NULL;
+        }
+
+        int left = gpi_get_range_left(obj->hdl);
+        int right = gpi_get_range_right(obj->hdl);
+        int step = left > right ? -1 : 1;
+        int num = (left > right ? left - right : right - left) + 1;
+        int i;
+
+        sim_hdl_elem *elems = (sim_hdl_elem *)malloc(sizeof(sim_hdl_elem) * num);
+        if (elems == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+
+        for (i = 0; i < num; i++) {
+            gpi_sim_hdl elem = gpi_get_handle_by_index(obj->hdl, left + i * step);
+            if (elem == NULL) {
+                PyErr_Format(PyExc_IndexError, "%s contains no object at index %d",
+                             gpi_get_signal_fullname_str(obj->hdl), left + i * step);
+                free(elems);
+                return NULL;
+            }
+
+            elems[i].hdl = elem;
+            elems[i].type = gpi_get_object_type(elem);
+            if (elems[i].type == GPI_INTEGER || elems[i].type == GPI_ENUM) {
+                elems[i].width = 32;
+            } else {
+                elems[i].width = gpi_get_num_elems(elem);
+            }
+
+            if (elems[i].width < 1 || elems[i].width > 64) {
+                PyErr_Format(PyExc_ValueError, "Element %d of %s is %d bits wide, only 1 to 64 are supported",
+                             i, gpi_get_signal_fullname_str(obj->hdl), elems[i].width);
+                free(elems);
+                return NULL;
+            }
+        }
+
+        obj->elems = elems;
+        obj->num_array_elems = num;
+    }
+
+    *count = obj->num_array_elems;
+    return obj->elems;
+}
+
+// Check that the buffer has an integer item per element, each wide enough
+static int check_array_buffer(Py_buffer *view, sim_hdl_elem *elems, int count, int *is_signed)
+{
+    const char *format = view->format ? view->format : "B";
+    Py_ssize_t itemsize = view->itemsize;
+    int i;
+
+    if (*format == '@' || *format == '=')
+        format++;
+
+    if (format[0] && !format[1] && strchr("bhilq", format[0])) {
+        *is_signed = 1;
+    } else if (format[0] && !format[1] && strchr("BHILQ", format[0])) {
+        *is_signed = 0;
+    } else {
+        PyErr_Format(PyExc_ValueError, "Unsupported buffer format '%s', expected native integers", view->format);
+        return 0;
+    }
+
+    if (itemsize != 1 && itemsize != 2 && itemsize != 4 && itemsize != 8) {
+        PyErr_Format(PyExc_ValueError, "Unsupported buffer item size %zd", itemsize);
+        return 0;
+    }
+
+    if (view->len / itemsize != count) {
+        PyErr_Format(PyExc_ValueError, "Buffer holds %zd items but the array has %d elements",
+                     view->len / itemsize, count);
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (elems[i].width > itemsize * 8) {
+            PyErr_Format(PyExc_ValueError, "Element %d is %d bits wide, too wide for %zd byte items",
+                         i, elems[i].width, itemsize);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static void store_item(char *item, Py_ssize_t itemsize, uint64_t value)
+{
+    uint8_t v8;
+    uint16_t v16;
+    uint32_t v32;
+
+    switch (itemsize) {
+        case 1: v8 = (uint8_t)value; memcpy(item, &v8, 1); break;
+        case 2: v16 = (uint16_t)value; memcpy(item, &v16, 2); break;
+        case 4: v32 = (uint32_t)value; memcpy(item, &v32, 4); break;
+        default: memcpy(item, &value, 8); break;
+    }
+}
+
+static uint64_t load_item(const char *item, Py_ssize_t itemsize, int is_signed)
+{
+    int8_t v8;
+    int16_t v16;
+    int32_t v32;
+    uint64_t v64;
+
+    switch (itemsize) {
+        case 1:
+            memcpy(&v8, item, 1);
+            return is_signed ? (uint64_t)(int64_t)v8 : (uint64_t)(uint8_t)v8;
+        case 2:
+            memcpy(&v16, item, 2);
+            return is_signed ? (uint64_t)(int64_t)v16 : (uint64_t)(uint16_t)v16;
+        case 4:
+            memcpy(&v32, item, 4);
+            return is_signed ? (uint64_t)(int64_t)v32 : (uint64_t)(uint32_t)v32;
+        default:
+            memcpy(&v64, item, 8);
+            return v64;
+    }
+}
+
+// Read every element of an array handle into a writable buffer
+static PyObject *get_array_val(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    sim_hdl_elem *elems;
+    Py_buffer view;
+    int count, is_signed, i;
+
+    if (!check_nargs("get_array_val", nargs, 2, 2)) {
+        return NULL;
+    }
+
+    if ((elems = array_elements(args[0], &count)) == NULL) {
+        return NULL;
+    }
+
+    if (PyObject_GetBuffer(args[1], &view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+        return NULL;
+    }
+
+    if (!check_array_buffer(&view, elems, count, &is_signed)) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        sim_hdl_elem *elem = &elems[i];
+        uint64_t value = 0;
+
+        if (elem->type == GPI_INTEGER || elem->type == GPI_ENUM) {
+            value = (uint64_t)(int64_t)gpi_get_signal_value_long(elem->hdl);
+        } else {
+            const char *binstr = gpi_get_signal_value_binstr(elem->hdl);
+            const char *c;
+
+            for (c = binstr; *c; c++) {
+                uint64_t bit;
+
+                if (*c == '0') {
+                    bit = 0;
+                } else if (*c == '1') {
+                    bit = 1;
+                } else {
+                    switch (get_resolve_x()) {
+                        case RESOLVE_ZEROS:  bit = 0; break;
+                        case RESOLVE_ONES:   bit = 1; break;
+                        case RESOLVE_RANDOM: bit = (uint64_t)(rand() & 1); break;
+                        default:
+                            PyErr_Format(PyExc_ValueError, "Unable to resolve element %d to binary >%s<", i, binstr);
+                            PyBuffer_Release(&view);
+                            return NULL;
+                    }
+                }
+                value = (value << 1) | bit;
+            }
+
+            if (is_signed && elem->width < 64 && ((value >> (elem->width - 1)) & 1)) {
+                value |= ~(uint64_t)0 << elem->width;
+            }
+        }
+
+        store_item((char *)view.buf + i * view.itemsize, view.itemsize, value);
+    }
+
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
+// Write every element of an array handle from a buffer, raising
+// OverflowError before anything is written if an item does not fit
+static PyObject *set_array_val(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    sim_hdl_elem *elems;
+    Py_buffer view;
+    int count, is_signed, i;
+    char binstr[65];
+
+    if (!check_nargs("set_array_val", nargs, 2, 2)) {
+        return NULL;
+    }
+
+    if ((elems = array_elements(args[0], &count)) == NULL) {
+        return NULL;
+    }
+
+    if (PyObject_GetBuffer(args[1], &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+        return NULL;
+    }
+
+    if (!check_array_buffer(&view, elems, count, &is_signed)) {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    for (i = 0; i < count; i++) {
+        uint64_t value = load_item((const char *)view.buf + i * view.itemsize, view.itemsize, is_signed);
+        int width = elems[i].width;
+        int fits;
+
+        if (width == 64) {
+            fits = 1;
+        } else if (is_signed) {
+            int64_t limit = (int64_t)1 << (width - 1);
+            fits = (int64_t)value >= -limit && (int64_t)value < limit;
+        } else {
+            fits = (value >> width) == 0;
+        }
+
+        if (!fits) {
+            PyErr_Format(PyExc_OverflowError, "Item %d does not fit in %d bits", i, width);
+            PyBuffer_Release(&view);
+            return NULL;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        sim_hdl_elem *elem = &elems[i];
+        uint64_t value = load_item((const char *)view.buf + i * view.itemsize, view.itemsize, is_signed);
+
+        if (elem->type == GPI_INTEGER || elem->type == GPI_ENUM) {
+            gpi_set_signal_value_long(elem->hdl, (long)(int64_t)value);
+        } else {
+            int bit;
+            for (bit = 0; bit < elem->width; bit++) {
+                binstr[bit] = (value >> (elem->width - 1 - bit)) & 1 ? '1' : '0';
+            }
+            binstr[elem->width] = '\0';
+            gpi_set_signal_value_str(elem->hdl, binstr);
+        }
+    }
+
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
 }
 
 static PyObject *get_definition_name(PyObject *self, PyObject *args)
@@ -705,7 +1379,7 @@ static PyObject *get_handle_by_name(PyObject *self, PyObject *args)
 
     result = gpi_get_handle_by_name((gpi_sim_hdl)hdl, name);
 
-    res = PyLong_FromVoidPtr(result);
+    res = sim_hdl_new(result);
 
     return res;
 }
@@ -723,7 +1397,7 @@ static PyObject *get_handle_by_index(PyObject *self, PyObject *args)
 
     result = gpi_get_handle_by_index((gpi_sim_hdl)hdl, index);
 
-    value = PyLong_FromVoidPtr(result);
+    value = sim_hdl_new(result);
 
     return value;
 }
@@ -744,7 +1418,7 @@ static PyObject *get_root_handle(PyObject *self, PyObject *args)
     }
 
 
-    value = PyLong_FromVoidPtr(result);
+    value = sim_hdl_new(result);
 
     return value;
 }
@@ -890,23 +1564,440 @@ static PyObject *stop_simulator(PyObject *self, PyObject *args)
 }
 
 
-static PyObject *deregister_callback(PyObject *self, PyObject *args)
+static PyObject *deregister_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
 {
     gpi_sim_hdl hdl;
-    PyObject *value;
 
     FENTER
 
-    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &hdl)) {
+    if (!check_nargs("deregister_callback", nargs, 1, 1) || !gpi_sim_hdl_converter(args[0], &hdl)) {
         return NULL;
     }
 
     gpi_deregister_callback(hdl);
 
-    value = Py_BuildValue("s", "OK!");
+    FEXIT
+    Py_RETURN_NONE;
+}
+
+// Convert a sequence of handles into a malloc'd array for the GPI, the
+// entries can be raw handles or objects with a _handle attribute
+static gpi_sim_hdl *handle_list_converter(PyObject *seq, int *num)
+{
+    PyObject *fast = PySequence_Fast(seq, "expected a sequence of handles");
+    if (fast == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t len = PySequence_Fast_GET_SIZE(fast);
+    gpi_sim_hdl *hdls = (gpi_sim_hdl *)malloc(sizeof(gpi_sim_hdl) * (len ? len : 1));
+    if (hdls == NULL) {
+        Py_DECREF(fast);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    Py_ssize_t i;
+    for (i = 0; i < len; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(fast, i);
+        PyObject *raw;
+
+        if (PyObject_HasAttrString(item, "_handle")) {
+            raw = PyObject_GetAttrString(item, "_handle");   // New reference
+        } else {
+            Py_INCREF(item);
+            raw = item;
+        }
+
+        int ok = raw != NULL && gpi_sim_hdl_converter(raw, &hdls[i]);
+
+        Py_XDECREF(raw);
+        if (!ok) {
+            free(hdls);
+            Py_DECREF(fast);
+            return NULL;
+        }
+    }
+
+    Py_DECREF(fast);
+    *num = (int)len;
+    return hdls;
+}
+
+static PyObject *stream_open(PyObject *self, PyObject *args)
+{
+    gpi_sim_hdl clk_hdl;
+    unsigned int edge;
+    const char *stim_path;
+    const char *expect_path;
+    PyObject *drive_list;
+    PyObject *check_list;
+    gpi_sim_hdl *drive_hdls;
+    gpi_sim_hdl *check_hdls;
+    int num_drive;
+    int num_check;
+    gpi_sim_hdl result;
+
+    if (!PyArg_ParseTuple(args, "O&IszOO", gpi_sim_hdl_converter, &clk_hdl, &edge,
+                          &stim_path, &expect_path, &drive_list, &check_list)) {
+        return NULL;
+    }
+
+    drive_hdls = handle_list_converter(drive_list, &num_drive);
+    if (drive_hdls == NULL) {
+        return NULL;
+    }
+
+    check_hdls = handle_list_converter(check_list, &num_check);
+    if (check_hdls == NULL) {
+        free(drive_hdls);
+        return NULL;
+    }
+
+    result = gpi_stream_open(stim_path, expect_path, clk_hdl, edge,
+                             drive_hdls, num_drive, check_hdls, num_check);
+
+    free(drive_hdls);
+    free(check_hdls);
+
+    return PyLong_FromVoidPtr(result);
+}
+
+// Release the user data of a stream callback the GPI dropped without firing
+static void stream_callback_data_release(void *gpi_cb_data)
+{
+    p_callback_data callback_data_p = (p_callback_data)gpi_cb_data;
+
+    if (callback_data_p == NULL) {
+        return;
+    }
+
+    callback_data_p->id_value = COCOTB_INACTIVE_ID;
+    Py_DECREF(callback_data_p->function);
+    Py_DECREF(callback_data_p->args);
+    callback_data_free(callback_data_p);
+}
+
+// Register a callback for when a stream has a batch of mismatches or has finished
+// First argument is the stream, then the batch size and the function to call
+// Remaining arguments are passed to the callback
+static PyObject *register_stream_callback(PyObject *self, PyObject *args)
+{
+    FENTER
+
+    gpi_sim_hdl stream_hdl;
+    int batch;
+    p_callback_data callback_data_p;
+    Py_ssize_t numargs = PyTuple_Size(args);
+
+    if (!check_nargs("register_stream_callback", numargs, 3, -1)) {
+        return NULL;
+    }
+
+    if (!gpi_sim_hdl_converter(PyTuple_GET_ITEM(args, 0), &stream_hdl)) {
+        return NULL;
+    }
+
+    batch = (int)PyLong_AsLong(PyTuple_GET_ITEM(args, 1));
+    if (batch == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+
+    // Streams call back from the clock edges they follow
+    callback_data_p = callback_data_new(PyTuple_GET_ITEM(args, 2), PySequence_Fast_ITEMS(args) + 3,
+                                        numargs - 3, CB_KIND_VALUE_CHANGE);
+    if (callback_data_p == NULL) {
+        return NULL;
+    }
+
+    stream_callback_data_release(
+        gpi_stream_register_callback(stream_hdl, (gpi_function_t)handle_gpi_callback, callback_data_p, batch));
 
     FEXIT
-    return value;
+    Py_RETURN_NONE;
+}
+
+static PyObject *deregister_stream_callback(PyObject *self, PyObject *args)
+{
+    gpi_sim_hdl stream_hdl;
+
+    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &stream_hdl)) {
+        return NULL;
+    }
+
+    stream_callback_data_release(gpi_stream_deregister_callback(stream_hdl));
+
+    Py_RETURN_NONE;
+}
+
+// Returns a tuple of (records driven, total records, mismatches, dropped mismatches, done)
+static PyObject *stream_status(PyObject *self, PyObject *args)
+{
+    gpi_sim_hdl stream_hdl;
+    gpi_stream_status_t status;
+
+    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &stream_hdl)) {
+        return NULL;
+    }
+
+    gpi_stream_get_status(stream_hdl, &status);
+
+    return Py_BuildValue("(KKKKO)",
+                         (unsigned long long)status.records_driven,
+                         (unsigned long long)status.records_total,
+                         (unsigned long long)status.mismatches,
+                         (unsigned long long)status.dropped,
+                         status.done ? Py_True : Py_False);
+}
+
+// Drain the pending mismatches as a list of
+// (record, sim time, signal name, expected binstr, actual binstr)
+static PyObject *stream_mismatches(PyObject *self, PyObject *args)
+{
+    gpi_sim_hdl stream_hdl;
+    gpi_stream_mismatch_t mismatch;
+
+    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &stream_hdl)) {
+        return NULL;
+    }
+
+    PyObject *list = PyList_New(0);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    while (gpi_stream_next_mismatch(stream_hdl, &mismatch)) {
+        PyObject *item = Py_BuildValue("(KKsss)",
+                                       (unsigned long long)mismatch.record,
+                                       (unsigned long long)mismatch.sim_time,
+                                       mismatch.name,
+                                       mismatch.expected,
+                                       mismatch.actual);
+        if (item == NULL || PyList_Append(list, item)) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    return list;
+}
+
+static PyObject *stream_close(PyObject *self, PyObject *args)
+{
+    gpi_sim_hdl stream_hdl;
+
+    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &stream_hdl)) {
+        return NULL;
+    }
+
+    stream_callback_data_release(gpi_stream_close(stream_hdl));
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *start_recording(PyObject *self, PyObject *args)
+{
+    PyObject *sig_list;
+    const char *path;
+    gpi_sim_hdl *sig_hdls;
+    int num_sigs;
+    gpi_sim_hdl result;
+
+    if (!PyArg_ParseTuple(args, "Os", &sig_list, &path)) {
+        return NULL;
+    }
+
+    sig_hdls = handle_list_converter(sig_list, &num_sigs);
+    if (sig_hdls == NULL) {
+        return NULL;
+    }
+
+    result = gpi_start_recording(path, sig_hdls, num_sigs);
+    free(sig_hdls);
+
+    return PyLong_FromVoidPtr(result);
+}
+
+static PyObject *stop_recording(PyObject *self, PyObject *args)
+{
+    gpi_sim_hdl recorder_hdl;
+
+    if (!PyArg_ParseTuple(args, "O&", gpi_sim_hdl_converter, &recorder_hdl)) {
+        return NULL;
+    }
+
+    gpi_stop_recording(recorder_hdl);
+
+    return Py_BuildValue("s", "OK!");
+}
+
+static PyObject *get_alloc_count(PyObject *self, PyObject *args)
+{
+    return PyLong_FromLongLong(gpi_get_alloc_count());
+}
+
+// GPI call statistics as a list of
+// (impl, call, calls, total ns, max ns, latency histogram)
+static PyObject *get_gpi_stats(PyObject *self, PyObject *args)
+{
+    gpi_call_stats_t stats;
+
+    PyObject *list = PyList_New(0);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; gpi_get_call_stats(i, &stats); i++) {
+        PyObject *hist = PyTuple_New(GPI_STATS_BUCKETS);
+        if (hist == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        for (int b = 0; b < GPI_STATS_BUCKETS; b++) {
+            PyTuple_SET_ITEM(hist, b, PyLong_FromUnsignedLongLong(stats.hist[b]));
+        }
+
+        PyObject *item = Py_BuildValue("(ssKKKN)",
+                                       stats.impl,
+                                       stats.call,
+                                       (unsigned long long)stats.calls,
+                                       (unsigned long long)stats.total_ns,
+                                       (unsigned long long)stats.max_ns,
+                                       hist);
+        if (item == NULL || PyList_Append(list, item)) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    return list;
+}
+
+// Time spent per kind of callback as a list of
+// (kind, calls, ns in Python, ns in the simulator before the callback)
+static PyObject *get_callback_times(PyObject *self, PyObject *args)
+{
+    PyObject *list = PyList_New(0);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < CB_KIND_MAX; i++) {
+        PyObject *item = Py_BuildValue("(sKKK)",
+                                       cb_kind_names[i],
+                                       (unsigned long long)cb_times[i].calls,
+                                       (unsigned long long)cb_times[i].python_ns,
+                                       (unsigned long long)cb_times[i].sim_ns);
+        if (item == NULL || PyList_Append(list, item)) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    return list;
+}
+
+// Simulator callback registrations as (registered, removed, rearmed)
+static PyObject *get_cb_counters(PyObject *self, PyObject *args)
+{
+    gpi_cb_counters_t counters;
+
+    gpi_get_cb_counters(&counters);
+
+    return Py_BuildValue("(KKK)",
+                         (unsigned long long)counters.registered,
+                         (unsigned long long)counters.removed,
+                         (unsigned long long)counters.rearmed);
+}
+
+// Usage of the callback handle slabs as a list of
+// (object size, chunks, allocs, reused, in use, peak, overflow)
+static PyObject *get_cb_pool_stats(PyObject *self, PyObject *args)
+{
+    gpi_cb_pool_stats_t stats[64];
+    int num = gpi_get_cb_pool_stats(stats, 64);
+
+    if (num > 64)
+        num = 64;
+
+    PyObject *list = PyList_New(0);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < num; i++) {
+        PyObject *item = Py_BuildValue("(IIKKKKK)",
+                                       stats[i].size,
+                                       stats[i].chunks,
+                                       (unsigned long long)stats[i].allocs,
+                                       (unsigned long long)stats[i].reused,
+                                       (unsigned long long)stats[i].in_use,
+                                       (unsigned long long)stats[i].peak,
+                                       (unsigned long long)stats[i].overflow);
+        if (item == NULL || PyList_Append(list, item)) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    return list;
+}
+
+static PyObject *startup_begin(PyObject *self, PyObject *args)
+{
+    const char *phase;
+
+    if (!PyArg_ParseTuple(args, "s", &phase)) {
+        return NULL;
+    }
+
+    gpi_startup_begin(phase);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *startup_end(PyObject *self, PyObject *args)
+{
+    gpi_startup_end();
+
+    Py_RETURN_NONE;
+}
+
+// Start-up timeline as a list of
+// (phase, depth, start ns, end ns, still running)
+static PyObject *get_startup_profile(PyObject *self, PyObject *args)
+{
+    gpi_startup_phase_t phase;
+
+    PyObject *list = PyList_New(0);
+    if (list == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; gpi_get_startup_phase(i, &phase); i++) {
+        PyObject *item = Py_BuildValue("(siKKO)",
+                                       phase.name,
+                                       phase.depth,
+                                       (unsigned long long)phase.start_ns,
+                                       (unsigned long long)phase.end_ns,
+                                       phase.open ? Py_True : Py_False);
+        if (item == NULL || PyList_Append(list, item)) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    return list;
 }
 
 static PyObject *log_level(PyObject *self, PyObject *args)
@@ -925,6 +2016,356 @@ static PyObject *log_level(PyObject *self, PyObject *args)
     return value;
 }
 
+static PyObject *hold_gil(PyObject *self, PyObject *args)
+{
+    PyObject *hold;
+
+    if (!PyArg_ParseTuple(args, "O", &hold)) {
+        return NULL;
+    }
+
+    gil_hold = PyObject_IsTrue(hold);
+    if (gil_hold < 0) {
+        gil_hold = 0;
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * @name    GPI handle type
+ * @brief   Python object wrapping a gpi_sim_hdl
+ *
+ * The name, path, type, constness, length and range of an object can not
+ * change after elaboration so each is read from the GPI the first time it
+ * is asked for and kept on the handle. Creating a handle costs no GPI
+ * calls, which matters for the many that are only looked up to be passed
+ * on. Values are read, written and waited on through the methods without
+ * going back through the handle converter.
+ */
+static PyObject *sim_hdl_new(gpi_sim_hdl hdl)
+{
+    sim_hdl_object *obj;
+
+    if (hdl == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    obj = PyObject_New(sim_hdl_object, &sim_hdl_type);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    obj->hdl = hdl;
+    obj->name = NULL;
+    obj->fullname = NULL;
+    obj->type_string = NULL;
+    obj->definition_name = NULL;
+    obj->definition_file = NULL;
+    obj->range = NULL;
+    obj->have = 0;
+    obj->elems = NULL;
+    obj->num_array_elems = 0;
+
+    return (PyObject *)obj;
+}
+
+static void sim_hdl_dealloc(sim_hdl_object *self)
+{
+    Py_XDECREF(self->name);
+    Py_XDECREF(self->fullname);
+    Py_XDECREF(self->type_string);
+    Py_XDECREF(self->definition_name);
+    Py_XDECREF(self->definition_file);
+    Py_XDECREF(self->range);
+    free(self->elems);
+    PyObject_Del(self);
+}
+
+static PyObject *sim_hdl_repr(sim_hdl_object *self)
+{
+    return PyString_FromFormat("<gpi_sim_hdl %s at %p>",
+                               gpi_get_signal_fullname_str(self->hdl), self->hdl);
+}
+
+// Handles compare and hash by the GPI object they refer to
+static Py_hash_t sim_hdl_hash(sim_hdl_object *self)
+{
+    Py_hash_t hash = (Py_hash_t)((uintptr_t)self->hdl >> 4);
+    return hash == -1 ? -2 : hash;
+}
+
+static PyObject *sim_hdl_richcompare(PyObject *a, PyObject *b, int op)
+{
+    if (Py_TYPE(a) != &sim_hdl_type || Py_TYPE(b) != &sim_hdl_type ||
+        (op != Py_EQ && op != Py_NE)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+
+    int equal = ((sim_hdl_object *)a)->hdl == ((sim_hdl_object *)b)->hdl;
+    if (equal == (op == Py_EQ)) {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+static int sim_hdl_object_type(sim_hdl_object *self)
+{
+    if (!(self->have & SIM_HDL_HAVE_TYPE)) {
+        self->type = gpi_get_object_type(self->hdl);
+        self->have |= SIM_HDL_HAVE_TYPE;
+    }
+    return self->type;
+}
+
+// Read the value in the representation matching the object type
+static PyObject *sim_hdl_get_value(sim_hdl_object *self, PyObject *args)
+{
+    switch (sim_hdl_object_type(self)) {
+        case GPI_INTEGER:
+        case GPI_ENUM:
+            return PyLong_FromLong(gpi_get_signal_value_long(self->hdl));
+        case GPI_REAL:
+            return PyFloat_FromDouble(gpi_get_signal_value_real(self->hdl));
+        case GPI_STRING:
+            return Py_BuildValue("s", gpi_get_signal_value_str(self->hdl));
+        default:
+            return Py_BuildValue("s", gpi_get_signal_value_binstr(self->hdl));
+    }
+}
+
+// Write an int, float or (binary) string value. Ints that do not fit the
+// 32 bits written by gpi_set_signal_value_long go through the same path as
+// set_signal_val_int on vectors and raise OverflowError on anything else.
+static PyObject *sim_hdl_set_value(sim_hdl_object *self, PyObject *value)
+{
+    if (PyFloat_Check(value)) {
+        gpi_set_signal_value_real(self->hdl, PyFloat_AS_DOUBLE(value));
+    } else if (PyLong_Check(value) || PyInt_Check(value)) {
+        int overflow;
+        long lval = PyLong_AsLongAndOverflow(value, &overflow);
+        if (lval == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+        if (!overflow && lval >= INT_MIN && lval <= INT_MAX) {
+            gpi_set_signal_value_long(self->hdl, lval);
+        } else {
+            switch (sim_hdl_object_type(self)) {
+                case GPI_INTEGER:
+                case GPI_ENUM:
+                case GPI_REAL:
+                case GPI_STRING:
+                    PyErr_Format(PyExc_OverflowError, "int too big to write to %s",
+                                 gpi_get_signal_fullname_str(self->hdl));
+                    return NULL;
+                default:
+                    return set_hdl_val_int(self->hdl, value);
+            }
+        }
+    } else {
+        const char *str;
+        if (!PyArg_Parse(value, "s", &str)) {
+            return NULL;
+        }
+        gpi_set_signal_value_str(self->hdl, str);
+    }
+
+    Py_RETURN_NONE;
+}
+
+// Same as register_value_change_callback without the handle argument
+static PyObject *sim_hdl_register_edge(PyObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    if (!check_nargs("register_edge", nargs, 2, -1)) {
+        return NULL;
+    }
+
+    return value_change_callback(((sim_hdl_object *)self)->hdl, args, nargs);
+}
+
+static PyMethodDef sim_hdl_methods[] = {
+    {"get_value", (PyCFunction)sim_hdl_get_value, METH_NOARGS, "Get the value of a signal, as a binary string unless an integer, real or string object"},
+    {"set_value", (PyCFunction)sim_hdl_set_value, METH_O, "Set the value of a signal from an int, float or string"},
+    {"register_edge", FASTCALL_ENTRY(sim_hdl_register_edge), "Register a signal change callback"},
+    {NULL, NULL, 0, NULL}        /* Sentinel */
+};
+
+// Keep a property string on the handle the first time it is read
+static PyObject *sim_hdl_cached_str(PyObject **slot, gpi_sim_hdl hdl,
+                                    const char *(*get)(gpi_sim_hdl))
+{
+    if (*slot == NULL) {
+        *slot = Py_BuildValue("s", get(hdl));
+        if (*slot == NULL) {
+            return NULL;
+        }
+    }
+
+    Py_INCREF(*slot);
+    return *slot;
+}
+
+static PyObject *sim_hdl_get_name(sim_hdl_object *self, void *closure)
+{
+    return sim_hdl_cached_str(&self->name, self->hdl, gpi_get_signal_name_str);
+}
+
+static PyObject *sim_hdl_get_fullname(sim_hdl_object *self, void *closure)
+{
+    return sim_hdl_cached_str(&self->fullname, self->hdl, gpi_get_signal_fullname_str);
+}
+
+static PyObject *sim_hdl_get_type_string(sim_hdl_object *self, void *closure)
+{
+    return sim_hdl_cached_str(&self->type_string, self->hdl, gpi_get_signal_type_str);
+}
+
+static PyObject *sim_hdl_get_definition_name(sim_hdl_object *self, void *closure)
+{
+    return sim_hdl_cached_str(&self->definition_name, self->hdl, gpi_get_definition_name);
+}
+
+static PyObject *sim_hdl_get_definition_file(sim_hdl_object *self, void *closure)
+{
+    return sim_hdl_cached_str(&self->definition_file, self->hdl, gpi_get_definition_file);
+}
+
+static PyObject *sim_hdl_get_range(sim_hdl_object *self, void *closure)
+{
+    if (self->range == NULL) {
+        if (gpi_is_indexable(self->hdl))
+            self->range = Py_BuildValue("(i,i)", gpi_get_range_left(self->hdl),
+                                        gpi_get_range_right(self->hdl));
+        else
+            self->range = Py_BuildValue("");
+        if (self->range == NULL) {
+            return NULL;
+        }
+    }
+
+    Py_INCREF(self->range);
+    return self->range;
+}
+
+static PyObject *sim_hdl_get_type(sim_hdl_object *self, void *closure)
+{
+    return PyLong_FromLong(sim_hdl_object_type(self));
+}
+
+static PyObject *sim_hdl_get_const(sim_hdl_object *self, void *closure)
+{
+    if (!(self->have & SIM_HDL_HAVE_CONST)) {
+        self->is_const = gpi_is_constant(self->hdl);
+        self->have |= SIM_HDL_HAVE_CONST;
+    }
+    return PyLong_FromLong(self->is_const);
+}
+
+static PyObject *sim_hdl_get_num_elems(sim_hdl_object *self, void *closure)
+{
+    if (!(self->have & SIM_HDL_HAVE_NUM_ELEMS)) {
+        self->num_elems = gpi_get_num_elems(self->hdl);
+        self->have |= SIM_HDL_HAVE_NUM_ELEMS;
+    }
+    return PyLong_FromLong(self->num_elems);
+}
+
+static PyGetSetDef sim_hdl_getset[] = {
+    {"name", (getter)sim_hdl_get_name, NULL, "Name of the object", NULL},
+    {"fullname", (getter)sim_hdl_get_fullname, NULL, "Full hierarchical name of the object", NULL},
+    {"type_string", (getter)sim_hdl_get_type_string, NULL, "Type of the object as a string", NULL},
+    {"definition_name", (getter)sim_hdl_get_definition_name, NULL, "Name of the object's definition", NULL},
+    {"definition_file", (getter)sim_hdl_get_definition_file, NULL, "File that sources the object's definition", NULL},
+    {"range", (getter)sim_hdl_get_range, NULL, "Range of elements as a tuple, None if not indexable", NULL},
+    {"type", (getter)sim_hdl_get_type, NULL, "Type of the object, mapped to a GPI enumeration", NULL},
+    {"const", (getter)sim_hdl_get_const, NULL, "Whether the object is a constant", NULL},
+    {"num_elems", (getter)sim_hdl_get_num_elems, NULL, "Number of elements contained in the object", NULL},
+    {NULL, NULL, NULL, NULL, NULL}  /* Sentinel */
+};
+
+static PyTypeObject sim_hdl_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    MODULE_NAME ".gpi_sim_hdl",                 /* tp_name */
+    sizeof(sim_hdl_object),                     /* tp_basicsize */
+    0,                                          /* tp_itemsize */
+    (destructor)sim_hdl_dealloc,                /* tp_dealloc */
+    0,                                          /* tp_print */
+    0,                                          /* tp_getattr */
+    0,                                          /* tp_setattr */
+    0,                                          /* tp_compare */
+    (reprfunc)sim_hdl_repr,                     /* tp_repr */
+    0,                                          /* tp_as_number */
+    0,                                          /* tp_as_sequence */
+    0,                                          /* tp_as_mapping */
+    (hashfunc)sim_hdl_hash,                     /* tp_hash */
+    0,                                          /* tp_call */
+    0,                                          /* tp_str */
+    0,                                          /* tp_getattro */
+    0,                                          /* tp_setattro */
+    0,                                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                         /* tp_flags */
+    "Handle to a GPI object",                   /* tp_doc */
+    0,                                          /* tp_traverse */
+    0,                                          /* tp_clear */
+    sim_hdl_richcompare,                        /* tp_richcompare */
+    0,                                          /* tp_weaklistoffset */
+    0,                                          /* tp_iter */
+    0,                                          /* tp_iternext */
+    sim_hdl_methods,                            /* tp_methods */
+    0,                                          /* tp_members */
+    sim_hdl_getset,                             /* tp_getset */
+};
+
+// With COCOTB_SIM_VARARGS set the fast entry points are registered through
+// their METH_VARARGS wrappers, as on Pythons before 3.7, so that the cost of
+// building and unpacking an argument tuple per call can be compared in-tree
+static void select_call_convention(void)
+{
+#if PY_VERSION_HEX >= 0x03070000
+    static const struct {
+        PyCFunction fast;
+        PyCFunction varargs;
+    } baseline[] = {
+#define VARARGS_BASELINE(func) {(PyCFunction)(void (*)(void))func, func##_varargs},
+        FASTCALL_FUNCTIONS(VARARGS_BASELINE)
+#undef VARARGS_BASELINE
+    };
+    PyMethodDef *tables[] = {SimulatorMethods, sim_hdl_methods};
+    size_t t, i;
+
+    if (!getenv("COCOTB_SIM_VARARGS")) {
+        return;
+    }
+
+    for (t = 0; t < sizeof(tables) / sizeof(tables[0]); t++) {
+        PyMethodDef *def;
+        for (def = tables[t]; def->ml_name; def++) {
+            for (i = 0; i < sizeof(baseline) / sizeof(baseline[0]); i++) {
+                if (def->ml_meth == baseline[i].fast) {
+                    def->ml_meth = baseline[i].varargs;
+                    def->ml_flags = METH_VARARGS;
+                }
+            }
+        }
+    }
+#endif
+}
+
+static void add_module_types(PyObject *simulator)
+{
+    if (PyType_Ready(&sim_hdl_type) < 0 || PyType_Ready(&scheduler_core_type) < 0) {
+        fprintf(stderr, "Failed to add module types!\n");
+        return;
+    }
+
+    Py_INCREF(&sim_hdl_type);
+    PyModule_AddObject(simulator, "gpi_sim_hdl", (PyObject *)&sim_hdl_type);
+    Py_INCREF(&scheduler_core_type);
+    PyModule_AddObject(simulator, "SchedulerCore", (PyObject *)&scheduler_core_type);
+}
+
 static void add_module_constants(PyObject* simulator)
 {
     // Make the GPI constants accessible from the C world
@@ -946,6 +2387,13 @@ static void add_module_constants(PyObject* simulator)
     rc |= PyModule_AddIntConstant(simulator, "DRIVERS",       GPI_DRIVERS);
     rc |= PyModule_AddIntConstant(simulator, "LOADS",         GPI_LOADS);
 
+    // Kinds of callback for register_callbacks
+    rc |= PyModule_AddIntConstant(simulator, "CB_TIMER",        CB_KIND_TIMER);
+    rc |= PyModule_AddIntConstant(simulator, "CB_VALUE_CHANGE", CB_KIND_VALUE_CHANGE);
+    rc |= PyModule_AddIntConstant(simulator, "CB_READWRITE",    CB_KIND_READWRITE);
+    rc |= PyModule_AddIntConstant(simulator, "CB_READONLY",     CB_KIND_READONLY);
+    rc |= PyModule_AddIntConstant(simulator, "CB_NEXTTIME",     CB_KIND_NEXTTIME);
+
     if (rc != 0)
         fprintf(stderr, "Failed to add module constants!\n");
 }
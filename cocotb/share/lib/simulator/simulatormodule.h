@@ -50,20 +50,88 @@ typedef struct t_callback_data {
     PyObject *args;                     // The arguments to call the function with
     PyObject *kwargs;                   // Keyword arguments to call the function with
     gpi_sim_hdl cb_hdl;
+    int kind;                           // CB_KIND_* the callback was registered as
 } s_callback_data, *p_callback_data;
 
+// Kinds of callback that the time spent in Python and the simulator is split by
+enum {
+    CB_KIND_TIMER,
+    CB_KIND_VALUE_CHANGE,
+    CB_KIND_READWRITE,
+    CB_KIND_READONLY,
+    CB_KIND_NEXTTIME,
+    CB_KIND_MAX
+};
+
+// An element of an array handle used for bulk reads and writes
+typedef struct t_sim_hdl_elem {
+    gpi_sim_hdl hdl;
+    int type;
+    int width;
+} sim_hdl_elem;
+
+// A GPI object handle as seen from Python. The properties that are fixed
+// once the design is elaborated are read on first access and kept, NULL or
+// their SIM_HDL_HAVE_* bit clear until then.
+enum sim_hdl_have {
+    SIM_HDL_HAVE_TYPE      = 1 << 0,
+    SIM_HDL_HAVE_CONST     = 1 << 1,
+    SIM_HDL_HAVE_NUM_ELEMS = 1 << 2,
+};
+
+typedef struct t_sim_hdl_object {
+    PyObject_HEAD
+    gpi_sim_hdl hdl;
+    PyObject *name;
+    PyObject *fullname;
+    PyObject *type_string;
+    PyObject *definition_name;
+    PyObject *definition_file;
+    PyObject *range;                    // (left, right) or None if not indexable
+    unsigned int have;                  // Which of the ints below have been read
+    int type;                           // gpi_objtype_t
+    int is_const;
+    int num_elems;
+    sim_hdl_elem *elems;                // Array elements from left to right, found on first bulk access
+    int num_array_elems;
+} sim_hdl_object;
+
+static PyTypeObject sim_hdl_type;
+static PyObject *sim_hdl_new(gpi_sim_hdl hdl);
+static void add_module_types(PyObject *simulator);
+static void select_call_convention(void);
+
 static PyObject *error_out(PyObject *m);
+
+// The hot entry points take their arguments as an array, using
+// METH_FASTCALL where available so that no tuple is built per call.
+// Older Pythons reach them through a METH_VARARGS wrapper, which newer ones
+// use too when COCOTB_SIM_VARARGS is set, to measure what FASTCALL saves.
+#if PY_VERSION_HEX >= 0x03070000
+#define FASTCALL_ENTRY(func) (PyCFunction)(void (*)(void))func, METH_FASTCALL
+#else
+#define FASTCALL_ENTRY(func) func##_varargs, METH_VARARGS
+#endif
+#define FASTCALL_WRAPPER(func) \
+    static PyObject *func##_varargs(PyObject *self, PyObject *args) \
+    { \
+        return func(self, &PyTuple_GET_ITEM(args, 0), PyTuple_GET_SIZE(args)); \
+    }
 static PyObject *log_msg(PyObject *self, PyObject *args);
 
 // Raise an exception on failure
 // Return None if for example get bin_string on enum?
-static PyObject *get_signal_val_long(PyObject *self, PyObject *args);
-static PyObject *get_signal_val_real(PyObject *self, PyObject *args);
-static PyObject *get_signal_val_str(PyObject *self, PyObject *args);
-static PyObject *get_signal_val_binstr(PyObject *self, PyObject *args);
-static PyObject *set_signal_val_long(PyObject *self, PyObject *args);
-static PyObject *set_signal_val_real(PyObject *self, PyObject *args);
-static PyObject *set_signal_val_str(PyObject *self, PyObject *args);
+static PyObject *get_signal_val_long(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *get_signal_val_real(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *get_signal_val_str(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *get_signal_val_binstr(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *set_signal_val_long(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *set_signal_val_real(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *set_signal_val_str(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *get_signal_val_int(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *set_signal_val_int(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *get_array_val(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *set_array_val(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 static PyObject *get_definition_name(PyObject *self, PyObject *args);
 static PyObject *get_definition_file(PyObject *self, PyObject *args);
 static PyObject *get_handle_by_name(PyObject *self, PyObject *args);
@@ -75,31 +143,82 @@ static PyObject *get_const(PyObject *self, PyObject *args);
 static PyObject *get_type_string(PyObject *self, PyObject *args);
 static PyObject *get_num_elems(PyObject *self, PyObject *args);
 static PyObject *get_range(PyObject *self, PyObject *args);
-static PyObject *register_timed_callback(PyObject *self, PyObject *args);
-static PyObject *register_value_change_callback(PyObject *self, PyObject *args);
-static PyObject *register_readonly_callback(PyObject *self, PyObject *args);
-static PyObject *register_nextstep_callback(PyObject *self, PyObject *args);
-static PyObject *register_rwsynch_callback(PyObject *self, PyObject *args);
+static PyObject *register_timed_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *register_value_change_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *register_readonly_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *register_nextstep_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *register_rwsynch_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *register_callbacks(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 static PyObject *stop_simulator(PyObject *self, PyObject *args);
 
 static PyObject *iterate(PyObject *self, PyObject *args);
-static PyObject *next(PyObject *self, PyObject *args);
+static PyObject *next(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 
 static PyObject *get_sim_time(PyObject *self, PyObject *args);
 static PyObject *get_precision(PyObject *self, PyObject *args);
-static PyObject *deregister_callback(PyObject *self, PyObject *args);
+static PyObject *deregister_callback(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+static PyObject *deregister_callbacks(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
 
 static PyObject *log_level(PyObject *self, PyObject *args);
+static PyObject *hold_gil(PyObject *self, PyObject *args);
+
+static PyObject *stream_open(PyObject *self, PyObject *args);
+static PyObject *register_stream_callback(PyObject *self, PyObject *args);
+static PyObject *deregister_stream_callback(PyObject *self, PyObject *args);
+static PyObject *stream_status(PyObject *self, PyObject *args);
+static PyObject *stream_mismatches(PyObject *self, PyObject *args);
+static PyObject *stream_close(PyObject *self, PyObject *args);
+static PyObject *start_recording(PyObject *self, PyObject *args);
+static PyObject *stop_recording(PyObject *self, PyObject *args);
+static PyObject *get_alloc_count(PyObject *self, PyObject *args);
+static PyObject *get_cb_pool_stats(PyObject *self, PyObject *args);
+static PyObject *get_cb_counters(PyObject *self, PyObject *args);
+static PyObject *get_gpi_stats(PyObject *self, PyObject *args);
+static PyObject *get_callback_times(PyObject *self, PyObject *args);
+static PyObject *startup_begin(PyObject *self, PyObject *args);
+static PyObject *startup_end(PyObject *self, PyObject *args);
+static PyObject *get_startup_profile(PyObject *self, PyObject *args);
+
+static PyObject *sim_hdl_register_edge(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+
+#define FASTCALL_FUNCTIONS(X) \
+    X(get_signal_val_long) \
+    X(get_signal_val_real) \
+    X(get_signal_val_str) \
+    X(get_signal_val_binstr) \
+    X(set_signal_val_long) \
+    X(set_signal_val_real) \
+    X(set_signal_val_str) \
+    X(get_signal_val_int) \
+    X(set_signal_val_int) \
+    X(get_array_val) \
+    X(set_array_val) \
+    X(register_timed_callback) \
+    X(register_value_change_callback) \
+    X(register_readonly_callback) \
+    X(register_nextstep_callback) \
+    X(register_rwsynch_callback) \
+    X(register_callbacks) \
+    X(next) \
+    X(deregister_callback) \
+    X(deregister_callbacks) \
+    X(sim_hdl_register_edge)
+
+FASTCALL_FUNCTIONS(FASTCALL_WRAPPER)
 
 static PyMethodDef SimulatorMethods[] = {
     {"log_msg",         log_msg, METH_VARARGS, "Log a message"},
-    {"get_signal_val_long", get_signal_val_long, METH_VARARGS, "Get the value of a signal as a long"},
-    {"get_signal_val_str", get_signal_val_str, METH_VARARGS, "Get the value of a signal as an ascii string"},
-    {"get_signal_val_binstr", get_signal_val_binstr, METH_VARARGS, "Get the value of a signal as a binary string"},
-    {"get_signal_val_real", get_signal_val_real, METH_VARARGS, "Get the value of a signal as a double precision float"},
-    {"set_signal_val_long", set_signal_val_long, METH_VARARGS, "Set the value of a signal using a long"},
-    {"set_signal_val_str", set_signal_val_str, METH_VARARGS, "Set the value of a signal using a binary string"},
-    {"set_signal_val_real", set_signal_val_real, METH_VARARGS, "Set the value of a signal using a double precision float"},
+    {"get_signal_val_long", FASTCALL_ENTRY(get_signal_val_long), "Get the value of a signal as a long"},
+    {"get_signal_val_str", FASTCALL_ENTRY(get_signal_val_str), "Get the value of a signal as an ascii string"},
+    {"get_signal_val_binstr", FASTCALL_ENTRY(get_signal_val_binstr), "Get the value of a signal as a binary string"},
+    {"get_signal_val_real", FASTCALL_ENTRY(get_signal_val_real), "Get the value of a signal as a double precision float"},
+    {"set_signal_val_long", FASTCALL_ENTRY(set_signal_val_long), "Set the value of a signal using a long"},
+    {"set_signal_val_str", FASTCALL_ENTRY(set_signal_val_str), "Set the value of a signal using a binary string"},
+    {"set_signal_val_real", FASTCALL_ENTRY(set_signal_val_real), "Set the value of a signal using a double precision float"},
+    {"get_signal_val_int", FASTCALL_ENTRY(get_signal_val_int), "Get the value of a signal as an int, resolving X and Z following COCOTB_RESOLVE_X, None if it is a real or string"},
+    {"set_signal_val_int", FASTCALL_ENTRY(set_signal_val_int), "Set the value of a signal using a non-negative int of any width"},
+    {"get_array_val", FASTCALL_ENTRY(get_array_val), "Read every element of an array into a writable buffer of integers"},
+    {"set_array_val", FASTCALL_ENTRY(set_array_val), "Write every element of an array from a buffer of integers"},
     {"get_definition_name", get_definition_name, METH_VARARGS, "Get the name of a GPI object's definition"},
     {"get_definition_file", get_definition_file, METH_VARARGS, "Get the file that sources the object's definition"},
     {"get_handle_by_name", get_handle_by_name, METH_VARARGS, "Get handle of a named object"},
@@ -111,20 +230,39 @@ static PyMethodDef SimulatorMethods[] = {
     {"get_const", get_const, METH_VARARGS, "Get a flag indicating whether the object is a constant"},
     {"get_num_elems", get_num_elems, METH_VARARGS, "Get the number of elements contained in the handle"},
     {"get_range", get_range, METH_VARARGS, "Get the range of elements (tuple) contained in the handle, Returns None if not indexable"},
-    {"register_timed_callback", register_timed_callback, METH_VARARGS, "Register a timed callback"},
-    {"register_value_change_callback", register_value_change_callback, METH_VARARGS, "Register a signal change callback"},
-    {"register_readonly_callback", register_readonly_callback, METH_VARARGS, "Register a callback for readonly section"},
-    {"register_nextstep_callback", register_nextstep_callback, METH_VARARGS, "Register a cllback for the nextsimtime callback"},
-    {"register_rwsynch_callback", register_rwsynch_callback, METH_VARARGS, "Register a callback for the readwrite section"},
+    {"register_timed_callback", FASTCALL_ENTRY(register_timed_callback), "Register a timed callback"},
+    {"register_value_change_callback", FASTCALL_ENTRY(register_value_change_callback), "Register a signal change callback"},
+    {"register_readonly_callback", FASTCALL_ENTRY(register_readonly_callback), "Register a callback for readonly section"},
+    {"register_nextstep_callback", FASTCALL_ENTRY(register_nextstep_callback), "Register a cllback for the nextsimtime callback"},
+    {"register_rwsynch_callback", FASTCALL_ENTRY(register_rwsynch_callback), "Register a callback for the readwrite section"},
+    {"register_callbacks", FASTCALL_ENTRY(register_callbacks), "Register a callback calling the same function for each (kind, handle, edge or time, *args) spec in a list"},
     {"stop_simulator", stop_simulator, METH_VARARGS, "Instruct the attached simulator to stop"},
     {"iterate", iterate, METH_VARARGS, "Get an iterator handle to loop over all members in an object"},
-    {"next", next, METH_VARARGS, "Get the next object from the iterator"},
+    {"next", FASTCALL_ENTRY(next), "Get the next object from the iterator"},
     {"log_level", log_level, METH_VARARGS, "Set the log level for GPI"},
+    {"hold_gil", hold_gil, METH_VARARGS, "Keep the GIL held by the simulator thread between callbacks"},
 
     // FIXME METH_NOARGS => initialization from incompatible pointer type
     {"get_sim_time", get_sim_time, METH_VARARGS, "Get the current simulation time as an int tuple"},
     {"get_precision", get_precision, METH_VARARGS, "Get the precision of the simualator"},
-    {"deregister_callback", deregister_callback, METH_VARARGS, "Deregister a callback"},
+    {"deregister_callback", FASTCALL_ENTRY(deregister_callback), "Deregister a callback"},
+    {"deregister_callbacks", FASTCALL_ENTRY(deregister_callbacks), "Deregister a list of callbacks"},
+    {"stream_open", stream_open, METH_VARARGS, "Start streaming a stimulus file onto signals on each clock edge"},
+    {"register_stream_callback", register_stream_callback, METH_VARARGS, "Register a callback for a batch of stream mismatches or the end of a stream"},
+    {"deregister_stream_callback", deregister_stream_callback, METH_VARARGS, "Deregister a stream callback"},
+    {"stream_status", stream_status, METH_VARARGS, "Get the progress of a stream as a tuple"},
+    {"stream_mismatches", stream_mismatches, METH_VARARGS, "Get and clear the pending mismatches of a stream"},
+    {"stream_close", stream_close, METH_VARARGS, "Stop a stream and release its files"},
+    {"start_recording", start_recording, METH_VARARGS, "Record all changes of a list of signals to a binary trace file"},
+    {"stop_recording", stop_recording, METH_VARARGS, "Stop a recording and complete its trace file"},
+    {"get_alloc_count", get_alloc_count, METH_VARARGS, "Get the number of C++ heap allocations, -1 unless built with COCOTB_ALLOC_COUNT=1"},
+    {"get_cb_pool_stats", get_cb_pool_stats, METH_VARARGS, "Get the usage of the callback handle slabs"},
+    {"get_cb_counters", get_cb_counters, METH_VARARGS, "Get the number of callbacks registered with and removed from the simulator"},
+    {"get_gpi_stats", get_gpi_stats, METH_VARARGS, "Get call counts and latencies of the GPI entry points, empty unless COCOTB_GPI_STATS is set"},
+    {"get_callback_times", get_callback_times, METH_VARARGS, "Get the time spent in Python callbacks and in the simulator before them, by kind of callback"},
+    {"startup_begin", startup_begin, METH_VARARGS, "Begin a phase of the start-up timeline, nested in any phase still running"},
+    {"startup_end", startup_end, METH_VARARGS, "End the start-up phase begun most recently"},
+    {"get_startup_profile", get_startup_profile, METH_VARARGS, "Get the start-up timeline, empty unless COCOTB_STARTUP_PROFILE is set"},
     
     {"error_out", (PyCFunction)error_out, METH_NOARGS, NULL},
     
@@ -15,6 +15,7 @@ MODULE_ENTRY_POINT(void)
 {
     PyObject* simulator;
 
+    select_call_convention();
     simulator = Py_InitModule(MODULE_NAME, SimulatorMethods);
 
     if (simulator == NULL) INITERROR;
@@ -27,4 +28,5 @@ MODULE_ENTRY_POINT(void)
     }
 
     add_module_constants(simulator);
+    add_module_types(simulator);
 }
@@ -34,6 +34,7 @@ MODULE_ENTRY_POINT(void)
 {
     PyObject* simulator;
 
+    select_call_convention();
     simulator = PyModule_Create(&moduledef);
 
     if (simulator == NULL) INITERROR;
@@ -46,6 +47,7 @@ MODULE_ENTRY_POINT(void)
     }
 
     add_module_constants(simulator);
+    add_module_types(simulator);
     return simulator;
 }
 
@@ -395,6 +395,7 @@ int VhpiCbHdl::arm_callback(void)
                 goto error;
             }
         }
+        GpiCbHdl::counters.rearmed++;
     } else {
 
         vhpiHandleT new_hdl = vhpi_register_cb(&cb_data, vhpiReturnCb);
@@ -406,6 +407,8 @@ int VhpiCbHdl::arm_callback(void)
             goto error;
         }
 
+        GpiCbHdl::counters.registered++;
+
         cbState = (vhpiStateT)vhpi_get(vhpiStateP, new_hdl);
         if (vhpiEnable != cbState) {
             LOG_ERROR("VHPI ERROR: Registered callback isn't enabled! Got %d\n", cbState);
@@ -426,23 +429,7 @@ error:
 // Value related functions
 const vhpiEnumT VhpiSignalObjHdl::chr2vhpi(const char value)
 {
-    switch (value) {
-        case '0':
-            return vhpi0;
-        case '1':
-            return vhpi1;
-        case 'U':
-        case 'u':
-            return vhpiU;
-        case 'Z':
-        case 'z':
-            return vhpiZ;
-        case 'X':
-        case 'x':
-            return vhpiX;
-        default:
-            return vhpiDontCare;
-    }
+    return vhpi_logic_from_char(value);
 }
 
 // Value related functions
@@ -457,9 +444,12 @@ int VhpiLogicSignalObjHdl::set_signal_value(long value)
 
         case vhpiEnumVecVal:
         case vhpiLogicVecVal: {
-            int i;
-            for (i=0; i<m_num_elems; i++)
-                m_value.value.enumvs[m_num_elems-i-1] = value&(1L<<i) ? vhpi1 : vhpi0;
+            uint32_t aval[2];
+
+            aval[0] = (uint32_t)value;
+            aval[1] = (sizeof(value) > 4) ? (uint32_t)((unsigned long)value >> 16 >> 16) : 0;
+
+            vhpi_logic_from_words(m_value.value.enumvs, m_num_elems, aval, NULL, 2);
 
             m_value.numElems = m_num_elems;
             break;
@@ -498,14 +488,7 @@ int VhpiLogicSignalObjHdl::set_signal_value(std::string &value)
 
             m_value.numElems = m_num_elems;
 
-            std::string::iterator iter;
-
-            int i = 0;
-            for (iter = value.begin();
-                 (iter != value.end()) && (i < m_num_elems);
-                 iter++, i++) {
-                m_value.value.enumvs[i] = chr2vhpi(*iter);
-            }
+            vhpi_logic_from_binstr(m_value.value.enumvs, value.c_str(), m_num_elems);
 
             break;
         }
@@ -524,6 +507,78 @@ int VhpiLogicSignalObjHdl::set_signal_value(std::string &value)
     return 0;
 }
 
+const char* VhpiLogicSignalObjHdl::get_signal_value_binstr(void)
+{
+    /* Read the values themselves and format them here, rather than having
+     * the simulator build the string
+     */
+    if (vhpi_get_value(GpiObjHdl::get_handle<vhpiHandleT>(), &m_value)) {
+        check_vhpi_error();
+        return VhpiSignalObjHdl::get_signal_value_binstr();
+    }
+
+    switch (m_value.format) {
+        case vhpiLogicVal:
+            m_binvalue.value.str[0] = vhpi_logic_to_char(m_value.value.enumv);
+            m_binvalue.value.str[1] = '\0';
+            break;
+
+        case vhpiLogicVecVal:
+            vhpi_logic_to_binstr(m_binvalue.value.str, m_value.value.enumvs, m_num_elems);
+            m_binvalue.value.str[m_num_elems] = '\0';
+            break;
+
+        default:
+            return VhpiSignalObjHdl::get_signal_value_binstr();
+    }
+
+    return m_binvalue.value.str;
+}
+
+long VhpiLogicSignalObjHdl::get_signal_value_long(void)
+{
+    uint32_t aval[2];
+    uint32_t bval[2];
+
+    if (m_value.format != vhpiLogicVecVal)
+        return VhpiSignalObjHdl::get_signal_value_long();
+
+    if (vhpi_get_value(GpiObjHdl::get_handle<vhpiHandleT>(), &m_value)) {
+        check_vhpi_error();
+        LOG_ERROR("failed to get long value");
+        return 0;
+    }
+
+    /* Bits that are not 0 or 1 read as 0 */
+    vhpi_logic_to_words(aval, bval, 2, m_value.value.enumvs, m_num_elems);
+
+    unsigned long value = aval[0] & ~bval[0];
+    if (sizeof(value) > 4)
+        value |= (unsigned long)(aval[1] & ~bval[1]) << 16 << 16;
+
+    return (long)value;
+}
+
+/* Packed straight from the logic values, without the binary string */
+int VhpiLogicSignalObjHdl::get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words)
+{
+    if (m_value.format != vhpiLogicVal && m_value.format != vhpiLogicVecVal)
+        return VhpiSignalObjHdl::get_signal_value_words(aval, bval, num_words);
+
+    if (vhpi_get_value(GpiObjHdl::get_handle<vhpiHandleT>(), &m_value)) {
+        check_vhpi_error();
+        return -1;
+    }
+
+    if (m_value.format == vhpiLogicVal) {
+        vhpi_logic_to_words(aval, bval, num_words, &m_value.value.enumv, 1);
+        return num_words > 0 ? 1 : 0;
+    }
+
+    vhpi_logic_to_words(aval, bval, num_words, m_value.value.enumvs, m_num_elems);
+    return m_num_elems < num_words * 32 ? m_num_elems : num_words * 32;
+}
+
 // Value related functions
 int VhpiSignalObjHdl::set_signal_value(long value)
 {
@@ -748,6 +803,21 @@ GpiCbHdl * VhpiSignalObjHdl::value_change_cb(unsigned int edge)
     return cb;
 }
 
+GpiCbHdl * VhpiSignalObjHdl::new_value_change_cb(unsigned int edge)
+{
+    if (edge < 1 || edge > 3)
+        return NULL;
+
+    VhpiValueCbHdl *cb = new VhpiValueCbHdl(m_impl, this, edge);
+
+    if (cb->arm_callback()) {
+        delete cb;
+        return NULL;
+    }
+
+    return cb;
+}
+
 VhpiValueCbHdl::VhpiValueCbHdl(GpiImplInterface *impl,
                                VhpiSignalObjHdl *sig,
                                int edge) : GpiCbHdl(impl),
@@ -830,6 +900,7 @@ int VhpiTimedCbHdl::cleanup_callback(void)
         return 1;
 
     vhpi_remove_cb(get_handle<vhpiHandleT>());
+    GpiCbHdl::counters.removed++;
 
     m_obj_hdl = NULL;
     m_state = GPI_FREE;
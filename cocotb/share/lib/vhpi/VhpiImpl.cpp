@@ -896,6 +896,8 @@ void handle_vhpi_callback(const vhpiCbDataT *cb_data)
 
     if (!cb_hdl)
         LOG_CRITICAL("VHPI: Callback data corrupted");
+    else
+        gpi_fr_record_fired(cb_hdl, GPI_FR_TIME_UNKNOWN);
 
     gpi_cb_state_e old_state = cb_hdl->get_call_state();
 
@@ -935,9 +937,11 @@ static void register_final_callback(void)
 
 static void register_embed(void)
 {
+    gpi_startup_begin("register_embed VHPI");
     vhpi_table = new VhpiImpl("VHPI");
     gpi_register_impl(vhpi_table);
     gpi_load_extra_libs();
+    gpi_startup_end();
 }
 
 // pre-defined VHPI registration table
@@ -82,6 +82,16 @@ static inline int __check_vhpi_error(const char *file, const char *func, long li
     __check_vhpi_error(__FILE__, __func__, __LINE__); \
 } while (0)
 
+/* std_logic conversions, see VhpiLogic.cpp */
+vhpiEnumT vhpi_logic_from_char(char value);
+char vhpi_logic_to_char(vhpiEnumT value);
+void vhpi_logic_from_binstr(vhpiEnumT *dst, const char *src, int len);
+void vhpi_logic_to_binstr(char *dst, const vhpiEnumT *src, int len);
+void vhpi_logic_from_words(vhpiEnumT *dst, int len,
+                           const uint32_t *aval, const uint32_t *bval, int num_words);
+void vhpi_logic_to_words(uint32_t *aval, uint32_t *bval, int num_words,
+                         const vhpiEnumT *src, int len);
+
 class VhpiCbHdl : public virtual GpiCbHdl {
 public:
     VhpiCbHdl(GpiImplInterface *impl); 
@@ -201,6 +211,7 @@ public:
 
     /* Value change callback accessor */
     virtual GpiCbHdl *value_change_cb(unsigned int edge);
+    virtual GpiCbHdl *new_value_change_cb(unsigned int edge);
     virtual int initialise(std::string &name, std::string &fq_name);
 
 protected:
@@ -221,6 +232,10 @@ public:
 
     virtual ~VhpiLogicSignalObjHdl() { }
 
+    const char* get_signal_value_binstr(void);
+    long get_signal_value_long(void);
+    int get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words);
+
     int set_signal_value(const long value);
     int set_signal_value(std::string &value);
 
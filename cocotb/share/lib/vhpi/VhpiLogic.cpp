@@ -0,0 +1,175 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "VhpiImpl.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Conversions between the std_logic values VHPI uses for logic vectors
+ * (vhpiLogicVecVal), their characters as found in a binary string and the
+ * aval/bval bit planes used by VPI. Element 0 of a vector is the leftmost
+ * character and the most significant bit.
+ *
+ * Each direction is a lookup table, with an SSE2 path that handles runs of
+ * 16 elements at a time while they only contain '0' and '1'.
+ */
+
+static const char logic_chars[] = "UX01ZWLH-";
+
+class VhpiLogicTables {
+public:
+    VhpiLogicTables() {
+        int i;
+
+        for (i = 0; i < 256; i++)
+            from_char[i] = vhpiDontCare;
+
+        for (i = 0; i <= vhpiDontCare; i++) {
+            from_char[(unsigned char)logic_chars[i]] = i;
+            from_char[(unsigned char)(logic_chars[i] | 0x20)] = i;
+        }
+
+        /* Weak and unknown values read back as X */
+        for (i = 0; i <= vhpiDontCare; i++) {
+            aval[i] = 1;
+            bval[i] = 1;
+        }
+        aval[vhpi0] = 0; bval[vhpi0] = 0;
+        aval[vhpiL] = 0; bval[vhpiL] = 0;
+        aval[vhpi1] = 1; bval[vhpi1] = 0;
+        aval[vhpiH] = 1; bval[vhpiH] = 0;
+        aval[vhpiZ] = 0; bval[vhpiZ] = 1;
+    }
+
+    vhpiEnumT from_char[256];
+    uint32_t  aval[vhpiDontCare + 1];
+    uint32_t  bval[vhpiDontCare + 1];
+};
+
+static VhpiLogicTables tables;
+
+vhpiEnumT vhpi_logic_from_char(char value)
+{
+    return tables.from_char[(unsigned char)value];
+}
+
+char vhpi_logic_to_char(vhpiEnumT value)
+{
+    return value <= vhpiDontCare ? logic_chars[value] : 'X';
+}
+
+void vhpi_logic_from_binstr(vhpiEnumT *dst, const char *src, int len)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i low   = _mm_set1_epi8(~1);
+    const __m128i digit = _mm_set1_epi8('0');
+    const __m128i to_logic = _mm_set1_epi8('0' - vhpi0);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+        /* Only '0' and '1' map onto consecutive values */
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(chars, low), digit)) != 0xffff) {
+            for (int j = i; j < i + 16; j++)
+                dst[j] = tables.from_char[(unsigned char)src[j]];
+            continue;
+        }
+
+        __m128i values = _mm_sub_epi8(chars, to_logic);
+        __m128i lo = _mm_unpacklo_epi8(values, zero);
+        __m128i hi = _mm_unpackhi_epi8(values, zero);
+        __m128i *out = reinterpret_cast<__m128i *>(dst + i);
+
+        _mm_storeu_si128(out,     _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+    }
+#endif
+
+    for (; i < len; i++)
+        dst[i] = tables.from_char[(unsigned char)src[i]];
+}
+
+void vhpi_logic_to_binstr(char *dst, const vhpiEnumT *src, int len)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i low   = _mm_set1_epi8(~1);
+    const __m128i logic = _mm_set1_epi8(vhpi0);
+    const __m128i to_digit = _mm_set1_epi8('0' - vhpi0);
+
+    for (; i + 16 <= len; i += 16) {
+        const __m128i *in = reinterpret_cast<const __m128i *>(src + i);
+
+        /* Values out of range saturate and so fail the check below */
+        __m128i words = _mm_packs_epi32(_mm_loadu_si128(in), _mm_loadu_si128(in + 1));
+        __m128i bytes = _mm_packus_epi16(words,
+                                         _mm_packs_epi32(_mm_loadu_si128(in + 2),
+                                                         _mm_loadu_si128(in + 3)));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, low), logic)) != 0xffff) {
+            for (int j = i; j < i + 16; j++)
+                dst[j] = vhpi_logic_to_char(src[j]);
+            continue;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_add_epi8(bytes, to_digit));
+    }
+#endif
+
+    for (; i < len; i++)
+        dst[i] = vhpi_logic_to_char(src[i]);
+}
+
+void vhpi_logic_from_words(vhpiEnumT *dst, int len,
+                           const uint32_t *aval, const uint32_t *bval, int num_words)
+{
+    static const vhpiEnumT planes[4] = { vhpi0, vhpi1, vhpiZ, vhpiX };
+    int bit;
+
+    for (bit = 0; bit < len; bit++) {
+        int word = bit / 32;
+        unsigned int value = 0;
+
+        if (word < num_words) {
+            value = (aval[word] >> (bit % 32)) & 1;
+            if (bval)
+                value |= ((bval[word] >> (bit % 32)) & 1) << 1;
+        }
+
+        dst[len - bit - 1] = planes[value];
+    }
+}
+
+void vhpi_logic_to_words(uint32_t *aval, uint32_t *bval, int num_words,
+                         const vhpiEnumT *src, int len)
+{
+    int word;
+
+    for (word = 0; word < num_words; word++) {
+        uint32_t a = 0;
+        uint32_t b = 0;
+        int bit;
+
+        for (bit = 0; bit < 32 && word * 32 + bit < len; bit++) {
+            vhpiEnumT value = src[len - (word * 32 + bit) - 1];
+
+            if (value > vhpiDontCare)
+                value = vhpiX;
+
+            a |= tables.aval[value] << bit;
+            b |= tables.bval[value] << bit;
+        }
+
+        aval[word] = a;
+        bval[word] = b;
+    }
+}
@@ -29,6 +29,8 @@
 
 #include "VpiImpl.h"
 
+#define VPI_TYPE_MAX (1000)
+
 extern "C" int32_t handle_vpi_callback(p_cb_data cb_data);
 
 VpiCbHdl::VpiCbHdl(GpiImplInterface *impl) : GpiCbHdl(impl)
@@ -47,24 +49,29 @@ VpiCbHdl::VpiCbHdl(GpiImplInterface *impl) : GpiCbHdl(impl)
     cb_data.user_data = (char*)this;
 }
 
-/* If the user data already has a callback handle then deregister
- * before getting the new one
+/* Registration with the simulator only happens from GPI_FREE. A handle that
+ * is still registered is taken back as it is, and one armed again from inside
+ * its own callback is registered once that callback has returned.
  */
 int VpiCbHdl::arm_callback(void) {
 
-    if (m_state == GPI_PRIMED) {
-        fprintf(stderr,
-                "Attempt to prime an already primed trigger for %s!\n", 
-                m_impl->reason_to_string(cb_data.reason));
-    }
-
-    // Only a problem if we have not been asked to deregister and register
-    // in the same simulation callback
-    if (m_obj_hdl != NULL && m_state != GPI_DELETE) {
-        fprintf(stderr,
-                "We seem to already be registered, deregistering %s!\n",
-                m_impl->reason_to_string(cb_data.reason));
-        cleanup_callback();
+    switch (m_state) {
+    case GPI_PRIMED:
+    case GPI_REPRIME:
+        return 0;
+    case GPI_DELETE:
+        /* Removal was put off and the simulator still holds the callback */
+        if (m_obj_hdl) {
+            GpiCbHdl::counters.rearmed++;
+            m_state = GPI_PRIMED;
+            return 0;
+        }
+        break;
+    case GPI_CALL:
+        m_state = GPI_REPRIME;
+        return 0;
+    default:
+        break;
     }
 
     vpiHandle new_hdl = vpi_register_cb(&cb_data);
@@ -76,6 +83,7 @@ int VpiCbHdl::arm_callback(void) {
         return -1;
 
     } else {
+        GpiCbHdl::counters.registered++;
         m_state = GPI_PRIMED;
     }
     
@@ -84,34 +92,28 @@ int VpiCbHdl::arm_callback(void) {
     return 0;
 }
 
+/* One-time callbacks are left with the simulator when they are removed
+ * before firing, they are marked GPI_DELETE and dropped when they come
+ * back. This saves a vpi_remove_cb if they are armed again before then.
+ */
 int VpiCbHdl::cleanup_callback(void)
 {
-    if (m_state == GPI_FREE)
+    switch (m_state) {
+    case GPI_FREE:
         return 0;
+    case GPI_PRIMED:
+        m_state = GPI_DELETE;
+        return 0;
+    default:
+        break;
+    }
 
-    /* If the one-time callback has not come back then
-     * remove it, it is has then free it. The remove is done
-     * internally */
-
-    if (m_state == GPI_PRIMED) {
-        if (!m_obj_hdl) {
-            LOG_CRITICAL("VPI: passed a NULL pointer : ABORTING");
-        }
-
-        if (!(vpi_remove_cb(get_handle<vpiHandle>()))) {
-            LOG_CRITICAL("VPI: unable to remove callback : ABORTING");
-        }
-
-        check_vpi_error();
-    } else {
 #ifndef MODELSIM
-        /* This is disabled for now, causes a small leak going to put back in */
-        if (!(vpi_free_object(get_handle<vpiHandle>()))) {
-            LOG_CRITICAL("VPI: unable to free handle : ABORTING");
-        }
-#endif
+    /* This is disabled for now, causes a small leak going to put back in */
+    if (m_obj_hdl && !(vpi_free_object(get_handle<vpiHandle>()))) {
+        LOG_CRITICAL("VPI: unable to free handle : ABORTING");
     }
-
+#endif
 
     m_obj_hdl = NULL;
     m_state = GPI_FREE;
@@ -217,6 +219,88 @@ int VpiObjHdl::initialise(std::string &name, std::string &fq_name) {
     return GpiObjHdl::initialise(name, fq_name);
 }
 
+void VpiObjHdl::index_children(void)
+{
+    vpiHandle vpi_hdl = GpiObjHdl::get_handle<vpiHandle>();
+    std::vector<int32_t> *relations;
+    std::vector<int32_t>::iterator relation;
+
+    m_children_indexed = true;
+
+    if (NULL == (relations = VpiIterator::get_relations(vpi_get(vpiType, vpi_hdl)))) {
+        LOG_DEBUG("Unable to index children of %s, no known relations", m_fullname.c_str());
+        return;
+    }
+
+    m_children_complete = true;
+
+    for (relation = relations->begin(); relation != relations->end(); relation++) {
+        vpiHandle iterator = vpi_iterate(*relation, vpi_hdl);
+        vpiHandle child;
+
+        if (NULL == iterator)
+            continue;
+
+        while (NULL != (child = vpi_scan(iterator))) {
+            VpiChild entry;
+
+            entry.hdl      = child;
+            entry.relation = *relation;
+            entry.type     = vpi_get(vpiType, child);
+
+            const char *c_name = vpi_get_str(vpiName, child);
+            if (!c_name) {
+                /* Objects from another language are handed to the other
+                 * implementations when iterating, which may free them, so
+                 * iterations over this scope have to go to the simulator
+                 */
+                if (entry.type >= VPI_TYPE_MAX)
+                    m_children_complete = false;
+                vpi_free_object(child);
+                continue;
+            }
+
+            entry.name = c_name;
+            m_children.push_back(entry);
+
+            /* As in VpiIterator, a generate block "loop[0]" also makes the
+             * pseudo-region "loop" visible, which shares this scope's handle
+             */
+            if (*relation == vpiInternalScope && entry.type == vpiGenScope) {
+                std::size_t found = entry.name.rfind("[");
+
+                if (found != std::string::npos && found != 0)
+                    m_child_names.insert(std::make_pair(entry.name.substr(0, found), vpi_hdl));
+            }
+
+            /* The first relation to report a name wins, nets before ports */
+            m_child_names.insert(std::make_pair(entry.name, child));
+        }
+    }
+
+    LOG_DEBUG("Indexed %d children of %s", (int)m_children.size(), m_fullname.c_str());
+}
+
+vpiHandle VpiObjHdl::find_child(const std::string &name)
+{
+    if (!m_children_indexed)
+        index_children();
+
+    std::map<std::string, vpiHandle>::iterator it = m_child_names.find(name);
+    if (it == m_child_names.end())
+        return NULL;
+
+    return it->second;
+}
+
+const std::vector<VpiChild> *VpiObjHdl::get_children(void)
+{
+    if (!m_children_indexed)
+        index_children();
+
+    return m_children_complete ? &m_children : NULL;
+}
+
 int VpiSignalObjHdl::initialise(std::string &name, std::string &fq_name) {
     int32_t type = vpi_get(vpiType, GpiObjHdl::get_handle<vpiHandle>());
     if ((vpiIntVar == type) ||
@@ -322,6 +406,38 @@ long VpiSignalObjHdl::get_signal_value_long(void)
     return value_s.value.integer;
 }
 
+/* The simulator hands back the aval/bval words of the vector as they are */
+int VpiSignalObjHdl::get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words)
+{
+    s_vpi_value value_s = {vpiVectorVal};
+
+    vpi_get_value(GpiObjHdl::get_handle<vpiHandle>(), &value_s);
+    check_vpi_error();
+
+    if (!value_s.value.vector)
+        return GpiSignalObjHdl::get_signal_value_words(aval, bval, num_words);
+
+    int bits = m_num_elems < num_words * 32 ? m_num_elems : num_words * 32;
+    int have = (bits + 31) / 32;
+
+    for (int word = 0; word < num_words; word++) {
+        if (word < have) {
+            aval[word] = (uint32_t)value_s.value.vector[word].aval;
+            bval[word] = (uint32_t)value_s.value.vector[word].bval;
+        } else {
+            aval[word] = 0;
+            bval[word] = 0;
+        }
+    }
+
+    if (bits % 32) {
+        aval[have - 1] &= ~(~(uint32_t)0 << (bits % 32));
+        bval[have - 1] &= ~(~(uint32_t)0 << (bits % 32));
+    }
+
+    return bits;
+}
+
 // Value related functions
 int VpiSignalObjHdl::set_signal_value(long value)
 {
@@ -345,12 +461,15 @@ int VpiSignalObjHdl::set_signal_value(double value)
 
 int VpiSignalObjHdl::set_signal_value(std::string &value)
 {
-    s_vpi_value value_s;
+    return set_signal_value_str(value.c_str());
+}
 
-    std::vector<char> writable(value.begin(), value.end());
-    writable.push_back('\0');
+int VpiSignalObjHdl::set_signal_value_str(const char *value)
+{
+    s_vpi_value value_s;
 
-    value_s.value.str = &writable[0];
+    /* vpi_put_value takes a non-const string but only reads it */
+    value_s.value.str = const_cast<char *>(value);
     value_s.format = vpiBinStrVal;
 
     return set_signal_value(value_s);
@@ -399,6 +518,21 @@ GpiCbHdl * VpiSignalObjHdl::value_change_cb(unsigned int edge)
     return cb;
 }
 
+GpiCbHdl * VpiSignalObjHdl::new_value_change_cb(unsigned int edge)
+{
+    if (edge < 1 || edge > 3)
+        return NULL;
+
+    VpiValueCbHdl *cb = new VpiValueCbHdl(m_impl, this, edge);
+
+    if (cb->arm_callback()) {
+        delete cb;
+        return NULL;
+    }
+
+    return cb;
+}
+
 VpiValueCbHdl::VpiValueCbHdl(GpiImplInterface *impl,
                              VpiSignalObjHdl *sig,
                              int edge) :GpiCbHdl(impl), 
@@ -414,6 +548,20 @@ VpiValueCbHdl::VpiValueCbHdl(GpiImplInterface *impl,
     cb_data.obj = m_signal->get_handle<vpiHandle>();
 }
 
+/* Value change callbacks stay registered until removed, so arming one
+ * again from inside its callback only has to leave it primed
+ */
+int VpiValueCbHdl::arm_callback(void)
+{
+    if (m_state == GPI_CALL) {
+        GpiCbHdl::counters.rearmed++;
+        m_state = GPI_PRIMED;
+        return 0;
+    }
+
+    return VpiCbHdl::arm_callback();
+}
+
 int VpiValueCbHdl::cleanup_callback(void)
 {
     if (m_state == GPI_FREE)
@@ -424,6 +572,7 @@ int VpiValueCbHdl::cleanup_callback(void)
     if (!(vpi_remove_cb(get_handle<vpiHandle>()))) {
         LOG_CRITICAL("VPI: unbale to remove callback : ABORTING");
     }
+    GpiCbHdl::counters.removed++;
 
     m_obj_hdl = NULL;
     m_state = GPI_FREE;
@@ -504,7 +653,6 @@ VpiReadwriteCbHdl::VpiReadwriteCbHdl(GpiImplInterface *impl) : GpiCbHdl(impl),
                                                                VpiCbHdl(impl)
 {
     cb_data.reason = cbReadWriteSynch;
-    delay_kill = false;
 }
 
 VpiReadOnlyCbHdl::VpiReadOnlyCbHdl(GpiImplInterface *impl) : GpiCbHdl(impl),
@@ -631,9 +779,10 @@ void vpi_mappings(GpiIteratorMapping<int32_t, int32_t> &map)
 GpiIteratorMapping<int32_t, int32_t> VpiIterator::iterate_over(vpi_mappings);
 
 VpiIterator::VpiIterator(GpiImplInterface *impl, GpiObjHdl *hdl) : GpiIterator(impl, hdl),
-                                                                   m_iterator(NULL)
+                                                                   m_iterator(NULL),
+                                                                   m_children(NULL)
 {
-    vpiHandle iterator;
+    vpiHandle iterator = NULL;
     vpiHandle vpi_hdl = m_parent->get_handle<vpiHandle>();
 
     int type = vpi_get(vpiType, vpi_hdl);
@@ -643,6 +792,15 @@ VpiIterator::VpiIterator(GpiImplInterface *impl, GpiObjHdl *hdl) : GpiIterator(i
         return;
     }
 
+    /* Scopes keep their children after the first iteration */
+    VpiObjHdl *scope = dynamic_cast<VpiObjHdl *>(m_parent);
+    if (scope && (m_children = scope->get_children())) {
+        LOG_DEBUG("Iterating over %d cached children of %s",
+                  (int)m_children->size(),
+                  m_parent->get_fullname_str());
+        m_child = m_children->begin();
+        return;
+    }
 
     for (one2many = selected->begin();
          one2many != selected->end();
@@ -685,8 +843,6 @@ VpiIterator::~VpiIterator()
         vpi_free_object(m_iterator);
 }
 
-#define VPI_TYPE_MAX (1000)
-
 GpiIterator::Status VpiSingleIterator::next_handle(std::string &name,
                                                    GpiObjHdl **hdl,
                                                    void **raw_hdl)
@@ -729,15 +885,36 @@ GpiIterator::Status VpiSingleIterator::next_handle(std::string &name,
         return GpiIterator::NOT_NATIVE;
 }
 
-GpiIterator::Status VpiIterator::next_handle(std::string &name, GpiObjHdl **hdl, void **raw_hdl)
+vpiHandle VpiIterator::next_cached_child(int32_t &relation, int32_t &type, const char *&c_name)
+{
+    const std::string &parent_name = m_parent->get_name();
+    bool genarray = (m_parent->get_type() == GPI_GENARRAY);
+
+    /* As with the simulator's iterators, a GPI_GENARRAY only sees the
+     * generate blocks that match its name
+     */
+    while (m_child != m_children->end() &&
+           genarray && (m_child->relation != vpiInternalScope ||
+                        m_child->type != vpiGenScope ||
+                        m_child->name.compare(0, parent_name.length(), parent_name) != 0)) {
+        m_child++;
+    }
+
+    if (m_child == m_children->end())
+        return NULL;
+
+    relation = m_child->relation;
+    type     = m_child->type;
+    c_name   = m_child->name.c_str();
+
+    return (m_child++)->hdl;
+}
+
+vpiHandle VpiIterator::next_scanned_child(int32_t &relation)
 {
-    GpiObjHdl *new_obj;
     vpiHandle obj;
     vpiHandle iter_obj = m_parent->get_handle<vpiHandle>();
 
-    if (!selected)
-        return GpiIterator::END;
-
     gpi_objtype_t obj_type  = m_parent->get_type();
     std::string parent_name = m_parent->get_name();
 
@@ -790,6 +967,32 @@ GpiIterator::Status VpiIterator::next_handle(std::string &name, GpiObjHdl **hdl,
 
     } while (!obj);
 
+    if (obj)
+        relation = *one2many;
+
+    return obj;
+}
+
+GpiIterator::Status VpiIterator::next_handle(std::string &name, GpiObjHdl **hdl, void **raw_hdl)
+{
+    GpiObjHdl *new_obj;
+    vpiHandle obj;
+    int32_t relation = 0;
+    int32_t type = vpiUnknown;
+    const char *c_name = NULL;
+
+    if (!selected)
+        return GpiIterator::END;
+
+    gpi_objtype_t obj_type  = m_parent->get_type();
+
+    if (m_children) {
+        obj = next_cached_child(relation, type, c_name);
+    } else if ((obj = next_scanned_child(relation))) {
+        type   = vpi_get(vpiType, obj);
+        c_name = vpi_get_str(vpiName, obj);
+    }
+
     if (NULL == obj) {
         LOG_DEBUG("No more children, all relationships tested");
         return GpiIterator::END;
@@ -801,11 +1004,8 @@ GpiIterator::Status VpiIterator::next_handle(std::string &name, GpiObjHdl **hdl,
        we see if the object is in out type range and if not
        return the raw_hdl up */
 
-    const char *c_name = vpi_get_str(vpiName, obj);
     if (!c_name) {
         /* This may be another type */
-        int type = vpi_get(vpiType, obj);
-
         if (type >= VPI_TYPE_MAX) {
             *raw_hdl = (void*)obj;
             return GpiIterator::NOT_NATIVE_NO_NAME;
@@ -823,7 +1023,7 @@ GpiIterator::Status VpiIterator::next_handle(std::string &name, GpiObjHdl **hdl,
      * NOTE: Taking advantage of the "caching" to only create one pseudo-region object.
      *       Otherwise a list would be required and checked while iterating
      */
-    if (*one2many == vpiInternalScope && obj_type != GPI_GENARRAY && vpi_get(vpiType, obj) == vpiGenScope) {
+    if (relation == vpiInternalScope && obj_type != GPI_GENARRAY && type == vpiGenScope) {
         std::string idx_str = c_name;
         std::size_t found = idx_str.rfind("[");
 
@@ -242,14 +242,57 @@ GpiObjHdl* VpiImpl::native_check_create(void *raw_hdl, GpiObjHdl *parent)
     return new_obj;
 }
 
-GpiObjHdl* VpiImpl::native_check_create(std::string &name, GpiObjHdl *parent)
+/* Looks up name relative to the parent scope so that the simulator does not
+ * have to walk the whole hierarchical path from the root again. Once the
+ * scope has been iterated or has missed a lookup its children are served
+ * from its index instead, in which case the handle is shared and must not
+ * be freed.
+ */
+vpiHandle VpiImpl::scoped_handle_by_name(const std::string &name, GpiObjHdl *parent, bool &shared)
 {
+    VpiObjHdl *scope = dynamic_cast<VpiObjHdl *>(parent);
     vpiHandle new_hdl;
-    std::string fq_name = parent->get_fullname() + "." + name;
-    std::vector<char> writable(fq_name.begin(), fq_name.end());
-    writable.push_back('\0');
 
-    new_hdl = vpi_handle_by_name(&writable[0], NULL);
+    shared = false;
+
+    if (!scope)
+        return NULL;
+
+    if (scope->children_indexed() && (new_hdl = scope->find_child(name))) {
+        shared = true;
+        return new_hdl;
+    }
+
+    /* vpi_handle_by_name takes a non-const string but only reads it */
+    new_hdl = vpi_handle_by_name(const_cast<char *>(name.c_str()), parent->get_handle<vpiHandle>());
+    if (new_hdl)
+        return new_hdl;
+
+    /* The first miss indexes the scope, for simulators that do not support
+     * scoped names
+     */
+    if (!scope->children_indexed() && (new_hdl = scope->find_child(name)))
+        shared = true;
+
+    return new_hdl;
+}
+
+GpiObjHdl* VpiImpl::native_check_create(std::string &name, GpiObjHdl *parent)
+{
+    vpiHandle new_hdl = NULL;
+    bool shared = false;
+    std::string &fq_name = m_fq_name;
+
+    fq_name.assign(parent->get_fullname());
+    fq_name += '.';
+    fq_name += name;
+
+    if (parent->get_type() == GPI_MODULE)
+        new_hdl = scoped_handle_by_name(name, parent, shared);
+
+    /* Anything else, such as structure members, is resolved from the root */
+    if (new_hdl == NULL)
+        new_hdl = vpi_handle_by_name(const_cast<char *>(fq_name.c_str()), NULL);
 
     /* No need to iterate to look for generate loops as the tools will at least find vpiGenScopeArray */
     if (new_hdl == NULL) {
@@ -266,15 +309,18 @@ GpiObjHdl* VpiImpl::native_check_create(std::string &name, GpiObjHdl *parent)
      * being equivalent to the parent handle.
      */
     if (vpi_get(vpiType, new_hdl) == vpiGenScopeArray) {
-        vpi_free_object(new_hdl);
+        if (!shared)
+            vpi_free_object(new_hdl);
 
         new_hdl = parent->get_handle<vpiHandle>();
+        shared = true;
     }
 
 
     GpiObjHdl* new_obj = create_gpi_obj_from_handle(new_hdl, name, fq_name);
     if (new_obj == NULL) {
-        vpi_free_object(new_hdl);
+        if (!shared)
+            vpi_free_object(new_hdl);
         LOG_DEBUG("Unable to fetch object %s", fq_name.c_str());
         return NULL;
     }
@@ -285,6 +331,7 @@ GpiObjHdl* VpiImpl::native_check_create(int32_t index, GpiObjHdl *parent)
 {
     vpiHandle vpi_hdl = parent->get_handle<vpiHandle>();
     vpiHandle new_hdl = NULL;
+    bool shared = false;
 
     char buff[14]; // needs to be large enough to hold -2^31 to 2^31-1 in string form ('['+'-'10+']'+'\0')
 
@@ -297,12 +344,14 @@ GpiObjHdl* VpiImpl::native_check_create(int32_t index, GpiObjHdl *parent)
                   index,
                   parent->get_name_str());
 
-        std::string idx      = buff;
-        std::string hdl_name = parent->get_fullname() + idx;
-        std::vector<char> writable(hdl_name.begin(), hdl_name.end());
-        writable.push_back('\0');
+        /* The pseudo-region shares the handle of the scope holding the generate blocks */
+        new_hdl = scoped_handle_by_name(parent->get_name() + buff, parent, shared);
 
-        new_hdl = vpi_handle_by_name(&writable[0], NULL);
+        if (new_hdl == NULL) {
+            std::string hdl_name = parent->get_fullname() + buff;
+
+            new_hdl = vpi_handle_by_name(const_cast<char *>(hdl_name.c_str()), NULL);
+        }
     } else if (obj_type == GPI_REGISTER || obj_type == GPI_ARRAY || obj_type == GPI_STRING) {
         new_hdl = vpi_handle_by_index(vpi_hdl, index);
 
@@ -360,17 +409,14 @@ GpiObjHdl* VpiImpl::native_check_create(int32_t index, GpiObjHdl *parent)
 
             snprintf(buff, 14, "[%d]", index);
 
-            std::string idx = buff;
-            std::string hdl_name = parent->get_fullname() + idx;
-
-            std::vector<char> writable(hdl_name.begin(), hdl_name.end());
-            writable.push_back('\0');
+            std::string hdl_name = parent->get_fullname() + buff;
 
-            new_hdl = vpi_handle_by_name(&writable[0], NULL);
+            new_hdl = vpi_handle_by_name(const_cast<char *>(hdl_name.c_str()), NULL);
 
             /* Create a pseudo-handle if not the last index into a multi-dimensional array */
             if (new_hdl == NULL && constraint_cnt > 1) {
                 new_hdl = p_hdl;
+                shared  = true;
             }
         }
     } else {
@@ -391,7 +437,8 @@ GpiObjHdl* VpiImpl::native_check_create(int32_t index, GpiObjHdl *parent)
     std::string fq_name = parent->get_fullname()+idx;
     GpiObjHdl* new_obj = create_gpi_obj_from_handle(new_hdl, name, fq_name);
     if (new_obj == NULL) {
-        vpi_free_object(new_hdl);
+        if (!shared)
+            vpi_free_object(new_hdl);
         LOG_DEBUG("Unable to fetch object below entity (%s) at index (%d)",
                   parent->get_name_str(), index);
         return NULL;
@@ -432,7 +479,7 @@ GpiObjHdl *VpiImpl::get_root_handle(const char* name)
     }
 
     root_name = vpi_get_str(vpiFullName, root);
-    rv = new GpiObjHdl(this, root, to_gpi_objtype(vpi_get(vpiType, root)));
+    rv = new VpiObjHdl(this, root, to_gpi_objtype(vpi_get(vpiType, root)));
     rv->initialise(root_name, root_name);
 
     return rv;
@@ -541,6 +588,10 @@ int32_t handle_vpi_callback(p_cb_data cb_data)
 
     if (!cb_hdl) {
         LOG_CRITICAL("VPI: Callback data corrupted: ABORTING");
+    } else if (cb_data->time && cb_data->time->type == vpiSimTime) {
+        gpi_fr_record_fired(cb_hdl, ((uint64_t)cb_data->time->high << 32) | cb_data->time->low);
+    } else {
+        gpi_fr_record_fired(cb_hdl, GPI_FR_TIME_UNKNOWN);
     }
 
     gpi_cb_state_e old_state = cb_hdl->get_call_state();
@@ -552,10 +603,15 @@ int32_t handle_vpi_callback(p_cb_data cb_data)
 
         gpi_cb_state_e new_state = cb_hdl->get_call_state();
 
-        /* We have re-primed in the handler */
-        if (new_state != GPI_PRIMED)
+        /* We have re-primed in the handler, the one that fired is
+           finished with so register again for the next one */
+        if (new_state == GPI_REPRIME) {
+            cb_hdl->cleanup_callback();
+            cb_hdl->arm_callback();
+        } else if (new_state != GPI_PRIMED) {
             if (cb_hdl->cleanup_callback())
                 delete cb_hdl;
+        }
 
     } else {
         /* Issue #188: This is a work around for a modelsim */
@@ -569,9 +625,11 @@ int32_t handle_vpi_callback(p_cb_data cb_data)
 
 static void register_embed(void)
 {
+    gpi_startup_begin("register_embed VPI");
     vpi_table = new VpiImpl("VPI");
     gpi_register_impl(vpi_table);
     gpi_load_extra_libs();
+    gpi_startup_end();
 }
 
 
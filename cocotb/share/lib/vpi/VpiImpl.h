@@ -99,6 +99,7 @@ class VpiValueCbHdl : public VpiCbHdl, public GpiValueCbHdl {
 public:
     VpiValueCbHdl(GpiImplInterface *impl, VpiSignalObjHdl *sig, int edge);
     virtual ~VpiValueCbHdl() { }
+    int arm_callback(void);
     int cleanup_callback(void);
 private:
     s_vpi_value m_vpi_value;
@@ -127,28 +128,6 @@ class VpiReadwriteCbHdl : public VpiCbHdl {
 public:
     VpiReadwriteCbHdl(GpiImplInterface *impl);
     virtual ~VpiReadwriteCbHdl() { }
-    int run_callback(void) {
-        if (delay_kill) {
-            delay_kill = false;
-            return 0;
-        } else {
-            return VpiCbHdl::run_callback();
-        }
-    }
-    int cleanup_callback(void) {
-        if (m_state == GPI_PRIMED) {
-            delay_kill = true;
-            return 0;
-        } else {
-            return VpiCbHdl::cleanup_callback();
-        }
-    }
-    int arm_callback(void) {
-        delay_kill = false;
-        return VpiCbHdl::arm_callback();
-    }
-private:
-    bool delay_kill;
 };
 
 class VpiStartupCbHdl : public VpiCbHdl {
@@ -182,13 +161,41 @@ public:
     int initialise(std::string &name, std::string &fq_name);
 };
 
+/* A child of a scope, as found by iterating over one of its relations */
+struct VpiChild {
+    vpiHandle   hdl;
+    int32_t     relation;
+    int32_t     type;
+    std::string name;       /* Empty if the simulator gave no name */
+};
+
 class VpiObjHdl : public GpiObjHdl {
 public:
     VpiObjHdl(GpiImplInterface *impl, vpiHandle hdl, gpi_objtype_t objtype) :
-                                                             GpiObjHdl(impl, hdl, objtype) { }
+                                                             GpiObjHdl(impl, hdl, objtype),
+                                                             m_children_indexed(false),
+                                                             m_children_complete(false) { }
     virtual ~VpiObjHdl() { }
 
     int initialise(std::string &name, std::string &fq_name);
+
+    /* The children of this scope are found by iterating over it once, the
+     * first time either of these is called, and kept for the lifetime of
+     * the handle. The handles in the table are shared and must not be
+     * freed by callers.
+     */
+    vpiHandle find_child(const std::string &name);
+    const std::vector<VpiChild> *get_children(void);
+
+    bool children_indexed(void) { return m_children_indexed; }
+
+private:
+    void index_children(void);
+
+    bool m_children_indexed;
+    bool m_children_complete;   /* False if children had to be left out */
+    std::vector<VpiChild> m_children;
+    std::map<std::string, vpiHandle> m_child_names;
 };
 
 class VpiSignalObjHdl : public GpiSignalObjHdl {
@@ -204,13 +211,16 @@ public:
     const char* get_signal_value_str(void);
     double get_signal_value_real(void);
     long get_signal_value_long(void);
+    int get_signal_value_words(uint32_t *aval, uint32_t *bval, int num_words);
 
     int set_signal_value(const long value);
     int set_signal_value(const double value);
     int set_signal_value(std::string &value);
+    int set_signal_value_str(const char *value);
 
     /* Value change callback accessor */
     GpiCbHdl *value_change_cb(unsigned int edge);
+    GpiCbHdl *new_value_change_cb(unsigned int edge);
     int initialise(std::string &name, std::string &fq_name);
 
 private:
@@ -230,11 +240,22 @@ public:
 
     Status next_handle(std::string &name, GpiObjHdl **hdl, void **raw_hdl);
 
+    static std::vector<int32_t> *get_relations(int32_t type) {
+        return iterate_over.get_options(type);
+    }
+
 private:
     vpiHandle m_iterator;
     static GpiIteratorMapping<int32_t, int32_t> iterate_over;      /* Possible mappings */
     std::vector<int32_t> *selected; /* Mapping currently in use */
     std::vector<int32_t>::iterator one2many;
+
+    /* Children cached by the parent scope, if it has them all */
+    const std::vector<VpiChild> *m_children;
+    std::vector<VpiChild>::const_iterator m_child;
+
+    vpiHandle next_cached_child(int32_t &relation, int32_t &type, const char *&c_name);
+    vpiHandle next_scanned_child(int32_t &relation);
 };
 
 // Base class for simple iterator that only iterates over a single type
@@ -294,6 +315,13 @@ public:
                                           std::string &fq_name);
 
 private:
+    vpiHandle scoped_handle_by_name(const std::string &name, GpiObjHdl *parent, bool &shared);
+
+    /* Full names built for lookups by name, kept so that its storage is
+     * reused rather than allocated for every lookup
+     */
+    std::string m_fq_name;
+
     /* Singleton callbacks */
     VpiReadwriteCbHdl m_read_write;
     VpiNextPhaseCbHdl m_next_phase;
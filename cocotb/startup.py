@@ -0,0 +1,140 @@
+# Copyright cocotb contributors
+# Licensed under the Revised BSD License, see LICENSE for details.
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""Start-up timeline, recorded when ``COCOTB_STARTUP_PROFILE`` is set.
+
+The GPI times loading itself and any ``GPI_EXTRA`` libraries, starting
+Python and handing over to cocotb. Phases begun here go into the same
+list, so they are timed on the same clock and nest inside those. Until the
+timeline is written every module imported for the first time is a phase of
+its own.
+
+The timeline ends just before the first test starts, when it is logged and
+written as JSON to the file named by ``COCOTB_STARTUP_PROFILE``.
+"""
+
+import os
+import sys
+
+try:
+    import builtins
+except ImportError:
+    import __builtin__ as builtins
+
+if "COCOTB_SIM" in os.environ:
+    import simulator
+
+_enabled = "COCOTB_SIM" in os.environ and bool(os.getenv("COCOTB_STARTUP_PROFILE"))
+_import = None
+
+# Shorter phases are only in the JSON, not the log
+_LOG_MIN_NS = 1000000
+
+
+class _Phase(object):
+    __slots__ = ("_name",)
+
+    def __init__(self, name):
+        self._name = name
+
+    def __enter__(self):
+        simulator.startup_begin(self._name)
+
+    def __exit__(self, *exc):
+        simulator.startup_end()
+        return False
+
+
+class _NoPhase(object):
+    __slots__ = ()
+
+    def __enter__(self):
+        pass
+
+    def __exit__(self, *exc):
+        return False
+
+
+_no_phase = _NoPhase()
+
+
+def phase(name):
+    """Context manager timing its body as a phase of start-up called
+    *name*, nested in any phase still running. Does nothing unless
+    ``COCOTB_STARTUP_PROFILE`` is set."""
+    if not _enabled:
+        return _no_phase
+    return _Phase(name)
+
+
+def _timed_import(name, *args, **kwargs):
+    # Relative imports are left alone as the name they resolve to is not known here
+    level = args[3] if len(args) > 3 else kwargs.get("level", 0)
+    if level > 0 or name in sys.modules:
+        return _import(name, *args, **kwargs)
+    simulator.startup_begin("import " + name)
+    try:
+        return _import(name, *args, **kwargs)
+    finally:
+        simulator.startup_end()
+
+
+def start():
+    """Time each module imported from now on."""
+    global _import
+
+    if not _enabled or _import is not None:
+        return
+    _import = builtins.__import__
+    builtins.__import__ = _timed_import
+
+
+def finish(log, toplevel=None):
+    """End the timeline, log it and write it out as JSON."""
+    global _enabled, _import
+
+    if not _enabled:
+        return
+    if builtins.__import__ is _timed_import:
+        builtins.__import__ = _import
+    _enabled = False
+
+    import cocotb
+    import json
+
+    phases = [{"name": name,
+               "depth": depth,
+               "start_ns": start,
+               "duration_ns": end - start,
+               "running": running}
+              for name, depth, start, end, running in simulator.get_startup_profile()]
+
+    hidden = 0
+    lines = ["Start-up profile:",
+             "%10s %10s  %s" % ("Start ms", "Time ms", "Phase")]
+    for entry in phases:
+        if entry["duration_ns"] < _LOG_MIN_NS and entry["depth"]:
+            hidden += 1
+            continue
+        lines.append("%10.1f %10.1f  %s%s%s" % (entry["start_ns"] / 1e6,
+                                                entry["duration_ns"] / 1e6,
+                                                "  " * entry["depth"],
+                                                entry["name"],
+                                                " (running)" if entry["running"] else ""))
+    if hidden:
+        lines.append("%d nested phases under 1 ms are left out" % hidden)
+
+    path = os.getenv("COCOTB_STARTUP_PROFILE")
+    lines.append("Writing start-up profile to %s" % path)
+    log.info("\n".join(lines))
+
+    profile = {"simulator": getattr(cocotb, "SIM_NAME", None),
+               "simulator_version": getattr(cocotb, "SIM_VERSION", None),
+               "toplevel": toplevel,
+               "phases": phases}
+    try:
+        with open(path, "w") as f:
+            json.dump(profile, f, indent=1)
+    except (IOError, OSError) as e:
+        log.warning("Unable to write start-up profile: %s" % e)
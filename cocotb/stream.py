@@ -0,0 +1,189 @@
+# Copyright cocotb contributors
+# Licensed under the Revised BSD License, see LICENSE for details.
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""Streaming of stimulus and expected values from files, driven by the GPI.
+
+Long directed regressions spend most of their time in Python pushing one
+value per clock. A :class:`FileStream` instead hands a pre-generated file to
+the GPI, which drives one record per clock edge and checks the outputs in C,
+only calling back into Python with batches of mismatches.
+"""
+
+import os
+import struct
+from collections import namedtuple
+
+if "COCOTB_SIM" in os.environ:
+    import simulator
+else:
+    simulator = None
+
+import cocotb
+from cocotb.log import SimLog
+from cocotb.result import ReturnValue, TestError
+from cocotb.triggers import GPITrigger, Trigger
+
+
+_MAGIC = b"COCOTBSF"
+_VERSION = 1
+
+
+def write_stream_file(filename, widths, records):
+    """Write records in the format read by :class:`FileStream`.
+
+    Args:
+        filename (str): The file to write.
+        widths (list): The width in bits of each field.
+        records (iterable): Each record is a sequence of integers,
+            one for each field.
+
+    Returns:
+        The number of records written.
+    """
+    widths = list(widths)
+    nbytes = [(w + 7) // 8 for w in widths]
+    header = struct.pack("<8sIIQ", _MAGIC, _VERSION, len(widths), 0)
+    header += struct.pack("<%dI" % len(widths), *widths)
+    header += b"\0" * (-len(header) % 8)
+
+    count = 0
+    with open(filename, "wb") as f:
+        f.write(header)
+        for record in records:
+            for value, width, size in zip(record, widths, nbytes):
+                value &= (1 << width) - 1
+                f.write(bytearray((value >> (8 * i)) & 0xff for i in range(size)))
+            count += 1
+        # Now we know how many records there were
+        f.seek(16)
+        f.write(struct.pack("<Q", count))
+    return count
+
+
+StreamMismatch = namedtuple("StreamMismatch",
+                            ["record", "time", "name", "expected", "actual"])
+StreamMismatch.__doc__ = """A value that did not match the expected file.
+
+``record`` is the index in the expected file, ``time`` is in simulator steps
+and ``expected``/``actual`` are binary strings.
+"""
+
+StreamStatus = namedtuple("StreamStatus",
+                          ["driven", "total", "mismatches", "dropped", "done"])
+
+
+class StreamEvent(GPITrigger):
+    """Fires when a :class:`FileStream` has *batch* mismatches pending or
+    has finished."""
+
+    def __init__(self, stream, batch=0):
+        GPITrigger.__init__(self)
+        self.stream = stream
+        self.batch = batch
+
+    def prime(self, callback):
+        if self.cbhdl == 0:
+            simulator.register_stream_callback(self.stream._hdl, self.batch,
+                                               callback, self)
+            self.cbhdl = self.stream._hdl
+        Trigger.prime(self)
+
+    def unprime(self):
+        if self.cbhdl != 0:
+            simulator.deregister_stream_callback(self.cbhdl)
+        self.cbhdl = 0
+        Trigger.unprime(self)
+
+    def __str__(self):
+        return self.__class__.__name__ + "(%s)" % self.stream
+
+
+class FileStream(object):
+    """Drive a file of records onto signals, one record per clock edge.
+
+    The stimulus and expected files are written with :func:`write_stream_file`,
+    with one field per signal in *drive* and *check* respectively.
+    On edge ``n`` of *clock* the stream drives stimulus record ``n`` and
+    compares *check* against expected record ``n - 1``, so the expected file
+    holds the response of the design to the previous record.
+
+    Example:
+
+    .. code-block:: python
+
+        stream = FileStream(dut.clk, "stim.bin", [dut.a, dut.b],
+                            expected="golden.bin", check=[dut.q])
+        stream.start()
+        mismatches = yield stream.wait_done()
+    """
+
+    def __init__(self, clock, stimulus, drive, expected=None, check=(),
+                 rising=True):
+        self.clock = clock
+        self.stimulus = stimulus
+        self.expected = expected
+        self.drive = list(drive)
+        self.check = list(check)
+        self.rising = rising
+        self.log = SimLog("cocotb.stream.%s" % os.path.basename(stimulus))
+        self._hdl = 0
+
+    def start(self):
+        """Open the files and start driving on the next clock edge."""
+        if self._hdl:
+            raise TestError("%s has already been started" % str(self))
+        self._hdl = simulator.stream_open(
+            self.clock._handle, 1 if self.rising else 2,
+            self.stimulus, self.expected,
+            [sig._handle for sig in self.drive],
+            [sig._handle for sig in self.check])
+        if not self._hdl:
+            raise TestError("Unable to start %s, see the GPI log" % str(self))
+
+    def wait(self, batch=0):
+        """A trigger for *batch* mismatches being pending or the end of the
+        stream, whichever comes first.
+
+        The trigger never fires if the stream has already finished, so check
+        :attr:`status` before waiting.
+        """
+        return StreamEvent(self, batch)
+
+    @cocotb.coroutine
+    def wait_done(self, batch=1024):
+        """Wait for the end of the stream, collecting mismatches in batches of
+        *batch* as they are found.
+
+        Returns:
+            A list of :class:`StreamMismatch`.
+        """
+        found = []
+        while not self.status.done:
+            yield self.wait(batch)
+            found.extend(self.mismatches())
+        found.extend(self.mismatches())
+        status = self.status
+        if status.dropped:
+            self.log.warning("%d mismatches were not recorded" % status.dropped)
+        raise ReturnValue(found)
+
+    def mismatches(self):
+        """Return and clear the pending mismatches."""
+        if not self._hdl:
+            return []
+        return [StreamMismatch(*m) for m in simulator.stream_mismatches(self._hdl)]
+
+    @property
+    def status(self):
+        """A :class:`StreamStatus` of the records driven and mismatches seen."""
+        return StreamStatus(*simulator.stream_status(self._hdl))
+
+    def close(self):
+        """Stop driving and release the files."""
+        if self._hdl:
+            simulator.stream_close(self._hdl)
+            self._hdl = 0
+
+    def __str__(self):
+        return "%s(%s)" % (self.__class__.__name__, self.stimulus)
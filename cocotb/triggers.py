@@ -119,6 +119,11 @@ class GPITrigger(Trigger):
         self.cbhdl = 0
         Trigger.unprime(self)
 
+    def _callback_spec(self):
+        """The ``(kind, handle, edge or time, trigger)`` tuple registering
+        this trigger through :func:`simulator.register_callbacks`."""
+        raise NotImplementedError
+
     def __del__(self):
         """Remove knowledge of the trigger"""
         if self.cbhdl != 0:
@@ -144,6 +149,9 @@ class Timer(GPITrigger):
                 raise_error(self, "Unable set up %s Trigger" % (str(self)))
         Trigger.prime(self)
 
+    def _callback_spec(self):
+        return (simulator.CB_TIMER, None, self.sim_steps, self)
+
     def __str__(self):
         return self.__class__.__name__ + "(%1.2fps)" % get_time_from_sim_steps(self.sim_steps,units='ps')
 
@@ -168,6 +176,9 @@ class ReadOnly(with_metaclass(ParametrizedSingleton, GPITrigger)):
                 raise_error(self, "Unable set up %s Trigger" % (str(self)))
         Trigger.prime(self)
 
+    def _callback_spec(self):
+        return (simulator.CB_READONLY, None, None, self)
+
     def __str__(self):
         return self.__class__.__name__ + "(readonly)"
 
@@ -194,6 +205,9 @@ class ReadWrite(with_metaclass(ParametrizedSingleton, GPITrigger)):
                 raise_error(self, "Unable set up %s Trigger" % (str(self)))
         Trigger.prime(self)
 
+    def _callback_spec(self):
+        return (simulator.CB_READWRITE, None, None, self)
+
     def __str__(self):
         return self.__class__.__name__ + "(readwritesync)"
 
@@ -215,6 +229,9 @@ class NextTimeStep(with_metaclass(ParametrizedSingleton, GPITrigger)):
                 raise_error(self, "Unable set up %s Trigger" % (str(self)))
         Trigger.prime(self)
 
+    def _callback_spec(self):
+        return (simulator.CB_NEXTTIME, None, None, self)
+
     def __str__(self):
         return self.__class__.__name__ + "(nexttimestep)"
 
@@ -239,13 +256,17 @@ class _EdgeBase(with_metaclass(ParametrizedSingleton, GPITrigger)):
     def prime(self, callback):
         """Register notification of a value change via a callback"""
         if self.cbhdl == 0:
-            self.cbhdl = simulator.register_value_change_callback(
-                self.signal._handle, callback, type(self)._edge_type, self
+            self.cbhdl = self.signal._handle.register_edge(
+                callback, type(self)._edge_type, self
             )
             if self.cbhdl == 0:
                 raise_error(self, "Unable set up %s Trigger" % (str(self)))
         super(_EdgeBase, self).prime()
 
+    def _callback_spec(self):
+        return (simulator.CB_VALUE_CHANGE, self.signal._handle,
+                type(self)._edge_type, self)
+
     def __str__(self):
         return self.__class__.__name__ + "(%s)" % self.signal._name
 
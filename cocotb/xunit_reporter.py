@@ -109,6 +109,36 @@ class XUnitReporter(object):
         else:
             log.text = "".join(f.readlines())
 
+    def add_output(self, text, testcase=None):
+        """Attach captured output to a testcase, keeping only the first and
+        last lines of long output as :meth:`add_log` does."""
+        if testcase is None:
+            testcase = self.last_testcase
+        log = SubElement(testcase, "system-out")
+        lines = text.splitlines(True)
+        if len(lines) > (TRUNCATE_LINES * 2):
+            log.text = "".join(lines[:TRUNCATE_LINES] +
+                               ["[...truncated %d lines...]\n" % (len(lines) - (TRUNCATE_LINES*2))] +
+                               lines[-TRUNCATE_LINES:])
+        else:
+            log.text = text
+
+    def testcases_xml(self, testsuite=None):
+        """The testcases of a testsuite serialised for :meth:`add_testcase_xml`."""
+        if testsuite is None:
+            testsuite = self.last_testsuite
+        return [ET.tostring(testcase).decode("UTF-8")
+                for testcase in testsuite.iter("testcase")]
+
+    def add_testcase_xml(self, xml, testsuite=None):
+        """Add a testcase serialised by :meth:`testcases_xml`, for example by
+        another process."""
+        if testsuite is None:
+            testsuite = self.last_testsuite
+        self.last_testcase = ET.fromstring(xml)
+        testsuite.append(self.last_testcase)
+        return self.last_testcase
+
     def add_failure(self, testcase=None, **kwargs):
         if testcase is None:
             testcase = self.last_testcase
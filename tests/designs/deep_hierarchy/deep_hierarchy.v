@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2019 Potential Ventures Ltd
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Potential Ventures Ltd,
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL POTENTIAL VENTURES LTD BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//-----------------------------------------------------------------------------
+
+`timescale 1 ps / 1 ps
+
+// A chain of DEPTH nested instances, each registering its input once, used to
+// exercise lookups deep in the hierarchy.
+module deep_node #(
+    parameter DEPTH = 1
+) (
+    input                                       clk,
+    input  [7:0]                                data_in,
+    output [7:0]                                data_out
+);
+
+reg [7:0] data_reg;
+
+always @(posedge clk)
+    data_reg <= data_in;
+
+generate
+    if (DEPTH > 1) begin : g_next
+        deep_node #(.DEPTH(DEPTH-1)) node (
+            .clk(clk),
+            .data_in(data_reg),
+            .data_out(data_out)
+        );
+    end else begin : g_leaf
+        assign data_out = data_reg;
+    end
+endgenerate
+
+endmodule
+
+module deep_hierarchy #(
+    parameter DEPTH = 10
+) (
+    input                                       clk,
+    input  [7:0]                                data_in,
+    output [7:0]                                data_out
+);
+
+deep_node #(.DEPTH(DEPTH)) node (
+    .clk(clk),
+    .data_in(data_in),
+    .data_out(data_out)
+);
+
+endmodule
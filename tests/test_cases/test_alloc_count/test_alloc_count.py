@@ -0,0 +1,87 @@
+import os
+
+import cocotb
+import simulator
+from cocotb.clock import Clock
+from cocotb.result import TestFailure, TestSuccess
+from cocotb.triggers import RisingEdge, Timer
+
+
+ITERATIONS = 1000
+
+
+def _allocs(func, *args):
+    """Heap allocations made calling func ITERATIONS times"""
+    before = simulator.get_alloc_count()
+    for _ in range(ITERATIONS):
+        func(*args)
+    return simulator.get_alloc_count() - before
+
+
+@cocotb.test()
+def test_read_write_allocations(dut):
+    """Reading and writing signals does not allocate once warmed up"""
+    if simulator.get_alloc_count() < 0:
+        if os.environ.get("COCOTB_ALLOC_COUNT") == "1":
+            raise TestFailure("GPI was not built with COCOTB_ALLOC_COUNT=1")
+        raise TestSuccess("GPI not built with COCOTB_ALLOC_COUNT=1")
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield RisingEdge(dut.clk)
+
+    narrow = dut.stream_in_data._handle
+    wide = dut.stream_in_data_wide._handle
+    binstr = "01" * 32
+
+    operations = [
+        ("set_signal_val_long", simulator.set_signal_val_long, (narrow, 0x5a)),
+        ("set_signal_val_str", simulator.set_signal_val_str, (wide, binstr)),
+        ("get_signal_val_binstr narrow", simulator.get_signal_val_binstr, (narrow,)),
+        ("get_signal_val_binstr wide", simulator.get_signal_val_binstr, (wide,)),
+        ("get_signal_val_long", simulator.get_signal_val_long, (narrow,)),
+    ]
+
+    # Warm up any lazily created state
+    for _ in range(10):
+        for name, func, args in operations:
+            func(*args)
+
+    # Anything counted without calling into the GPI at all
+    baseline = _allocs(lambda *args: None, narrow)
+
+    # Only amortised growth of a buffer inside the simulator is allowed for
+    allowed = baseline + ITERATIONS // 100
+    failed = []
+    for name, func, args in operations:
+        allocs = _allocs(func, *args)
+        dut._log.info("%-30s %d allocations in %d calls (baseline %d)" %
+                      (name, allocs, ITERATIONS, baseline))
+        if allocs > allowed:
+            failed.append("%s allocated %d times" % (name, allocs))
+
+    if failed:
+        raise TestFailure("In %d calls each, with %d allocations without "
+                          "calling the GPI: %s" %
+                          (ITERATIONS, baseline, ", ".join(failed)))
+
+    yield Timer(1000)
+
+
+@cocotb.test()
+def test_callback_handles_reused(dut):
+    """Callback handles are recycled through the GPI pool"""
+    for _ in range(ITERATIONS):
+        yield Timer(10)
+
+    stats = simulator.get_cb_pool_stats()
+    for size, chunks, allocs, reused, in_use, peak, overflow in stats:
+        dut._log.info("%4d byte slab: %d chunks, %d allocs, %d reused, "
+                      "%d in use, %d peak, %d overflow" %
+                      (size, chunks, allocs, reused, in_use, peak, overflow))
+
+    allocs = sum(s[2] for s in stats)
+    reused = sum(s[3] for s in stats)
+    # FLI keeps its own cache of timers so may allocate very few handles
+    if allocs >= ITERATIONS and reused < allocs // 2:
+        raise TestFailure("Only %d of %d callback handles were reused" %
+                          (reused, allocs))
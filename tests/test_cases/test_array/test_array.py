@@ -2,6 +2,7 @@
 A set of tests that demonstrate Array structure support
 """
 
+import array
 import cocotb
 import logging
 
@@ -489,3 +490,29 @@ def test_extended_identifiers(dut):
     tlog.info("Checking extended identifiers.")
     _check_type(tlog, dut._id("\\ext_id\\", extended=False), ModifiableObject)
     _check_type(tlog, dut._id("!"), ModifiableObject)
+
+@cocotb.test()
+def test_bulk_array_access(dut):
+    """Read and write every element of an array through a buffer"""
+    tlog = logging.getLogger("cocotb.test")
+
+    values = array.array('B', [0x12, 0x9A, 0x56, 0xF8])
+    dut.sig_t2.write_from(values)
+
+    yield Timer(1000)
+
+    elements = [int(dut.sig_t2[i]) for i in range(7, 3, -1)]
+    if elements != list(values):
+        raise TestFailure("Elements are %s, expected %s" % (elements, list(values)))
+
+    readback = array.array('B', [0] * 4)
+    dut.sig_t2.read_into(readback)
+    if readback != values:
+        raise TestFailure("Read %s, expected %s" % (list(readback), list(values)))
+
+    signed = array.array('h', [0] * 4)
+    dut.sig_t2.read_into(signed)
+    if list(signed) != [0x12, 0x9A - 0x100, 0x56, 0xF8 - 0x100]:
+        raise TestFailure("Read %s as signed" % list(signed))
+
+    tlog.info("Read %s as signed" % list(signed))
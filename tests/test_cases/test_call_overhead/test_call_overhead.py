@@ -0,0 +1,77 @@
+import os
+import time
+
+import cocotb
+import simulator
+from cocotb.result import TestFailure
+from cocotb.triggers import Timer
+
+
+ITERATIONS = 100000
+
+
+def _ns_per_call(func, *args):
+    start = time.time()
+    for _ in range(ITERATIONS):
+        func(*args)
+    return (time.time() - start) * 1e9 / ITERATIONS
+
+
+@cocotb.test()
+def test_call_overhead_benchmark(dut):
+    """Time the get and set entry points of the simulator module
+
+    Run with COCOTB_SIM_VARARGS=1 to compare against passing the arguments
+    as a tuple, as Pythons without METH_FASTCALL do.
+    """
+    handle = dut.stream_in_data._handle
+
+    loop = _ns_per_call(lambda *args: None, handle)
+    results = [
+        ("get_signal_val_long", _ns_per_call(simulator.get_signal_val_long, handle)),
+        ("set_signal_val_long", _ns_per_call(simulator.set_signal_val_long, handle, 0x5a)),
+        ("handle.get_value", _ns_per_call(handle.get_value)),
+        ("handle.set_value", _ns_per_call(handle.set_value, 0x5a)),
+    ]
+
+    convention = "METH_VARARGS" if "COCOTB_SIM_VARARGS" in os.environ else "METH_FASTCALL"
+    for name, ns in results:
+        dut._log.info("%-20s %7.1f ns/call (%.1f ns loop overhead, %s)" % (name, ns, loop, convention))
+
+    yield Timer(1)
+
+
+ROUND_TRIPS = 10000
+
+
+@cocotb.test()
+def test_callback_round_trip_benchmark(dut):
+    """Time a timer callback from registering it to Python running again
+
+    Run with COCOTB_HOLD_GIL=1 to compare against keeping the GIL held by the
+    simulator thread between callbacks.
+    """
+    start = time.time()
+    for _ in range(ROUND_TRIPS):
+        yield Timer(1)
+    ns = (time.time() - start) * 1e9 / ROUND_TRIPS
+
+    dut._log.info("Timer round trip %9.1f ns (COCOTB_HOLD_GIL %s)" %
+                  (ns, "set" if "COCOTB_HOLD_GIL" in os.environ else "not set"))
+
+
+@cocotb.test()
+def test_external_thread_progress(dut):
+    """External threads still run when COCOTB_HOLD_GIL is set"""
+    @cocotb.external
+    def count_in_thread(n):
+        total = 0
+        for i in range(n):
+            total += i
+        return total
+
+    yield Timer(1)
+    total = yield count_in_thread(1000)
+    if total != sum(range(1000)):
+        raise TestFailure("External thread returned %d" % total)
+    yield Timer(1)
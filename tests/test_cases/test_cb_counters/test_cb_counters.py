@@ -0,0 +1,81 @@
+import cocotb
+import simulator
+from cocotb.clock import Clock
+from cocotb.result import TestFailure
+from cocotb.triggers import RisingEdge, ReadOnly, ReadWrite, Timer
+
+
+CYCLES = 200
+
+
+@cocotb.test()
+def test_registrations_per_cycle(dut):
+    """Each cycle registers a bounded number of simulator callbacks"""
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield RisingEdge(dut.clk)
+
+    registered, removed, rearmed = simulator.get_cb_counters()
+
+    for i in range(CYCLES):
+        yield RisingEdge(dut.clk)
+        dut.stream_in_data <= i & 0xff
+        yield ReadWrite()
+        yield ReadOnly()
+
+    after = simulator.get_cb_counters()
+    per_cycle = float(after[0] - registered) / CYCLES
+    dut._log.info("%.2f registered, %.2f removed, %.2f rearmed per cycle" %
+                  (per_cycle,
+                   float(after[1] - removed) / CYCLES,
+                   float(after[2] - rearmed) / CYCLES))
+
+    # Two clock timers, the edge and one of each phase callback
+    if per_cycle > 6:
+        raise TestFailure("%.2f callbacks registered per cycle" % per_cycle)
+
+    yield Timer(1000)
+
+
+@cocotb.test()
+def test_counted_on_every_implementation(dut):
+    """Timer and edge waits are counted whichever interface the design uses"""
+    before = simulator.get_cb_counters()
+    for _ in range(CYCLES):
+        yield Timer(10)
+    after = simulator.get_cb_counters()
+
+    # Each Timer needs a callback, either new or one the simulator still holds
+    armed = (after[0] - before[0]) + (after[2] - before[2])
+    if armed < CYCLES:
+        raise TestFailure("Only %d callbacks counted for %d timers" % (armed, CYCLES))
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    before = after
+    for _ in range(CYCLES):
+        yield RisingEdge(dut.clk)
+    after = simulator.get_cb_counters()
+
+    if after == before:
+        raise TestFailure("No callbacks counted over %d rising edges" % CYCLES)
+
+
+@cocotb.test()
+def test_callback_times(dut):
+    """Time in Python and the simulator is split by kind of callback"""
+    before = dict((t[0], t[1:]) for t in simulator.get_callback_times())
+
+    for _ in range(CYCLES):
+        yield Timer(10)
+    yield ReadOnly()
+
+    after = dict((t[0], t[1:]) for t in simulator.get_callback_times())
+    for kind in ("Timer", "ReadOnly"):
+        calls = after[kind][0] - before[kind][0]
+        dut._log.info("%s: %d calls, %d ns in Python, %d ns in the simulator" %
+                      (kind, calls, after[kind][1] - before[kind][1],
+                       after[kind][2] - before[kind][2]))
+        if not calls:
+            raise TestFailure("No %s callbacks were accounted for" % kind)
+
+    if after["Timer"][1] <= before["Timer"][1]:
+        raise TestFailure("No time was put down to Python for Timer callbacks")
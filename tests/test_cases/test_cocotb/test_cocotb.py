@@ -1030,5 +1030,40 @@ def test_nested_first(dut):
     yield fire_task.join()
 
 
+@cocotb.test()
+def test_first_of_gpi_triggers(dut):
+    """ Test that the losing GPI triggers of a First are dropped """
+    clk_gen = cocotb.fork(Clock(dut.clk, 100).start())
+
+    for i in range(20):
+        ret = yield First(RisingEdge(dut.clk), FallingEdge(dut.clk), Timer(1000))
+        if isinstance(ret, Timer):
+            raise TestFailure("Timer won a First against clock edges")
+
+    # the triggers that lost every time should not fire for a waiter that has gone
+    yield Timer(1000)
+    clk_gen.kill()
+
+
+@cocotb.test()
+def test_register_callbacks(dut):
+    """ Test arming and disarming several callbacks in one call """
+    import simulator
+
+    fired = []
+    hdls = simulator.register_callbacks(
+        [(simulator.CB_TIMER, None, 10, "timer"),
+         (simulator.CB_VALUE_CHANGE, dut.clk._handle, 1, "rising"),
+         (simulator.CB_TIMER, None, 20, "late")],
+        lambda name: fired.append(name))
+    if len(hdls) != 3 or 0 in hdls:
+        raise TestFailure("Expected three callback handles, got %s" % hdls)
+
+    simulator.deregister_callbacks(hdls[1:])
+    yield Timer(100)
+    if fired != ["timer"]:
+        raise TestFailure("Expected only the first callback to fire, got %s" % fired)
+
+
 if sys.version_info[:2] >= (3, 5):
     from test_cocotb_35 import *
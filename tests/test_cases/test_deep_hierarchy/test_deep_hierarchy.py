@@ -0,0 +1,101 @@
+import time
+
+import cocotb
+import simulator
+from cocotb.clock import Clock
+from cocotb.result import TestFailure
+from cocotb.triggers import RisingEdge, Timer
+
+
+DEPTH = 10
+LOOKUPS = 1000
+
+
+def _deepest(dut):
+    """Walk down to the innermost instance, returning it and its path"""
+    node = dut.node
+    path = [dut._name, "node"]
+    for _ in range(DEPTH - 1):
+        node = node.g_next.node
+        path += ["g_next", "node"]
+    return node, ".".join(path)
+
+
+@cocotb.test()
+def test_deep_path(dut):
+    """Handles at every level of the hierarchy resolve and drive the design"""
+    node, path = _deepest(dut)
+    if node._path != path:
+        raise TestFailure("Innermost instance is %s, expected %s" % (node._path, path))
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    dut.data_in <= 0xa5
+    for _ in range(DEPTH + 1):
+        yield RisingEdge(dut.clk)
+    yield Timer(1)
+
+    if int(node.data_reg) != 0xa5 or int(dut.data_out) != 0xa5:
+        raise TestFailure("Value did not propagate through %d levels" % DEPTH)
+
+
+def _children(handle):
+    """Names of everything the simulator reports below a handle"""
+    names = []
+    iterator = simulator.iterate(handle, simulator.OBJECTS)
+    while True:
+        try:
+            child = simulator.next(iterator)
+        except StopIteration:
+            break
+        names.append(simulator.get_name_string(child))
+    return names
+
+
+@cocotb.test()
+def test_repeat_iteration(dut):
+    """Iterating over a scope again gives the same children"""
+    node, _ = _deepest(dut)
+
+    for scope in (dut, dut.node, node):
+        start = time.time()
+        first = _children(scope._handle)
+        first_elapsed = time.time() - start
+
+        start = time.time()
+        second = _children(scope._handle)
+        second_elapsed = time.time() - start
+
+        if first != second:
+            raise TestFailure("Iterating over %s gave %s then %s" % (scope._path, first, second))
+        dut._log.info("Iterating over %d children of %s took %.1fus then %.1fus" %
+                      (len(first), scope._path, first_elapsed * 1e6, second_elapsed * 1e6))
+
+    # A name lookup after iterating is served from the scope's children
+    data_reg = simulator.get_handle_by_name(node._handle, "data_reg")
+    if not data_reg or simulator.get_name_string(data_reg) != "data_reg":
+        raise TestFailure("Lookup of data_reg after iterating over %s failed" % node._path)
+
+    yield Timer(1)
+
+
+@cocotb.test()
+def test_lookup_benchmark(dut):
+    """Time repeated lookups by name at the top and bottom of the hierarchy"""
+    node, _ = _deepest(dut)
+
+    # Go through the simulator module so that the handle caching in the
+    # Python objects does not hide the cost of the lookup itself
+    lookups = [("top", dut, "data_in"),
+               ("depth %d" % DEPTH, node, "data_reg"),
+               ("depth %d" % DEPTH, node, "g_leaf")]
+
+    for where, scope, name in lookups:
+        start = time.time()
+        for _ in range(LOOKUPS):
+            if not simulator.get_handle_by_name(scope._handle, name):
+                raise TestFailure("Lookup of %s failed in %s" % (name, scope._path))
+        elapsed = time.time() - start
+        dut._log.info("%d lookups of %s at %s took %.3fs (%.1fus each)" %
+                      (LOOKUPS, name, where, elapsed, elapsed * 1e6 / LOOKUPS))
+
+    yield Timer(1)
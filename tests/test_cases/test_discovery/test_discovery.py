@@ -443,3 +443,36 @@ def custom_type(dut):
     if expected_top != count:
         raise TestFailure("Expected %d found %d for cosLut" % (expected_top, count))
 
+
+
+@cocotb.test()
+def handle_metadata(dut):
+    """The GPI handle holds the same properties the simulator reports"""
+    import simulator
+    yield Timer(0)
+    for sig in [dut, dut.stream_in_data, dut.stream_out_ready]:
+        hdl = sig._handle
+        expected = [simulator.get_name_string(hdl),
+                    simulator.get_type_string(hdl),
+                    simulator.get_type(hdl),
+                    simulator.get_const(hdl),
+                    simulator.get_num_elems(hdl),
+                    simulator.get_range(hdl)]
+        got = [hdl.name, hdl.type_string, hdl.type, hdl.const, hdl.num_elems, hdl.range]
+        if got != expected:
+            raise TestFailure("Handle of %s holds %s, simulator reports %s" %
+                              (sig._path, got, expected))
+
+    hdl = dut.stream_in_data._handle
+    hdl.set_value(0x5a)
+    yield Timer(1)
+    if int(dut.stream_in_data) != 0x5a or hdl.get_value() != dut.stream_in_data.value.binstr:
+        raise TestFailure("Expected 0x5a, read %s" % hdl.get_value())
+
+    # Ints wider than the signal are refused rather than truncated
+    try:
+        hdl.set_value(1 << 40)
+    except OverflowError:
+        pass
+    else:
+        raise TestFailure("Writing 1 << 40 to an 8 bit signal did not raise OverflowError")
@@ -0,0 +1,51 @@
+import os
+
+import cocotb
+from cocotb.clock import Clock
+from cocotb.result import TestFailure
+from cocotb.triggers import Timer, RisingEdge
+from cocotb.utils import get_sim_time
+
+# Changed by the tests, each of which should see the value from time 0
+_state = {"touched_by": None}
+
+
+@cocotb.test()
+def test_a_leaves_state_behind(dut):
+    """Change module state and leave a clock running"""
+    if _state["touched_by"] is not None:
+        raise TestFailure("State was changed by %s" % _state["touched_by"])
+    if get_sim_time("ns") != 0:
+        raise TestFailure("Test started at %d ns" % get_sim_time("ns"))
+
+    _state["touched_by"] = "test_a_leaves_state_behind"
+    cocotb.fork(Clock(dut.clk, 10, "ns").start())
+    dut.stream_in_data <= 0x42
+    yield Timer(100, "ns")
+
+
+@cocotb.test()
+def test_b_starts_from_time_zero(dut):
+    """Check that nothing from the other test is visible"""
+    if _state["touched_by"] is not None:
+        raise TestFailure("State was changed by %s" % _state["touched_by"])
+    if get_sim_time("ns") != 0:
+        raise TestFailure("Test started at %d ns" % get_sim_time("ns"))
+
+    _state["touched_by"] = "test_b_starts_from_time_zero"
+    yield Timer(100, "ns")
+
+    # No clock was started in this process
+    edge = RisingEdge(dut.clk)
+    timeout = Timer(100, "ns")
+    ret = yield [edge, timeout]
+    if ret is edge:
+        raise TestFailure("Clock from another test is running")
+
+
+@cocotb.test(expect_fail=True)
+def test_c_fails_in_own_process(dut):
+    """A failure is reported back from the child"""
+    yield Timer(1, "ns")
+    dut._log.info("Failing in process %d" % os.getpid())
+    raise TestFailure("Expected failure")
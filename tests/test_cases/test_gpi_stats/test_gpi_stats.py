@@ -0,0 +1,42 @@
+import cocotb
+import simulator
+from cocotb.clock import Clock
+from cocotb.result import TestFailure
+from cocotb.triggers import RisingEdge, Timer
+
+
+CYCLES = 100
+
+
+def calls_to(stats, name):
+    return sum(s[2] for s in stats if s[1] == name)
+
+
+@cocotb.test()
+def test_calls_counted(dut):
+    """GPI entry points are counted per implementation"""
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield RisingEdge(dut.clk)
+
+    before = simulator.get_gpi_stats()
+    for i in range(CYCLES):
+        dut.stream_in_data <= i & 0xff
+        yield RisingEdge(dut.clk)
+        dut.stream_out_data_registered.value.integer
+    after = simulator.get_gpi_stats()
+
+    for impl, call, calls, total_ns, max_ns, hist in after:
+        dut._log.info("%-6s %-36s %8d calls %10.1f us" %
+                      (impl, call, calls, total_ns / 1000.0))
+        if sum(hist) != calls:
+            raise TestFailure("%s histogram holds %d of %d calls" %
+                              (call, sum(hist), calls))
+
+    for call in ("gpi_set_signal_value_long", "gpi_get_signal_value_binstr",
+                 "gpi_register_value_change_callback"):
+        made = calls_to(after, call) - calls_to(before, call)
+        if made < CYCLES:
+            raise TestFailure("Only %d calls to %s counted over %d cycles" %
+                              (made, call, CYCLES))
+
+    yield Timer(1000)
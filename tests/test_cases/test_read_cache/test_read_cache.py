@@ -0,0 +1,39 @@
+import cocotb
+import cocotb.handle
+from cocotb.triggers import Timer, ReadOnly
+from cocotb.result import TestFailure
+
+
+@cocotb.test()
+def test_read_cache_hits(dut):
+    """Repeated reads within a step are served from the cache"""
+    cache = cocotb.handle._read_cache
+    if cache is None:
+        raise TestFailure("COCOTB_READ_CACHE did not enable the read cache")
+
+    dut.stream_in_data <= 0x12
+    yield Timer(1)
+
+    hits = cache.hits
+    first = int(dut.stream_out_data_comb)
+    second = int(dut.stream_out_data_comb)
+    if first != 0x12 or second != 0x12:
+        raise TestFailure("Read 0x%x, 0x%x instead of 0x12" % (first, second))
+    if cache.hits != hits + 1:
+        raise TestFailure("Second read was not a cache hit")
+
+
+@cocotb.test()
+def test_read_cache_invalidation(dut):
+    """Writes and simulator steps are visible through the cache"""
+    dut.stream_in_data.setimmediatevalue(0x34)
+    if int(dut.stream_in_data) != 0x34:
+        raise TestFailure("Cached value read back after an immediate write")
+
+    dut.stream_in_data <= 0x56
+    if int(dut.stream_in_data) != 0x34:
+        raise TestFailure("Scheduled write was visible before it was applied")
+
+    yield ReadOnly()
+    if int(dut.stream_out_data_comb) != 0x56:
+        raise TestFailure("Stale value read after the simulator advanced")
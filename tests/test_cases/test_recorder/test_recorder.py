@@ -0,0 +1,75 @@
+import os
+import struct
+
+import cocotb
+import simulator
+from cocotb.clock import Clock
+from cocotb.result import TestFailure
+from cocotb.triggers import ClockCycles, RisingEdge, Timer
+
+
+def read_trace(filename):
+    """Return the signal names and the number of events for each"""
+    with open(filename, "rb") as f:
+        magic, version, num_signals, precision = struct.unpack("<8sIIi", f.read(20))
+        if magic != b"COCOTBTR":
+            raise TestFailure("Bad trace magic %r" % magic)
+        names = []
+        for _ in range(num_signals):
+            width, name_len = struct.unpack("<IH", f.read(6))
+            names.append(f.read(name_len).decode())
+        counts = [0] * num_signals
+        while True:
+            hdr = f.read(16)
+            if len(hdr) < 16:
+                break
+            payload, num_events, base_time = struct.unpack("<IIQ", hdr)
+            buf = bytearray(f.read(payload))
+            pos = 0
+            for _ in range(num_events):
+                for field in range(2):
+                    value = 0
+                    shift = 0
+                    while True:
+                        byte = buf[pos]
+                        pos += 1
+                        value |= (byte & 0x7f) << shift
+                        shift += 7
+                        if not byte & 0x80:
+                            break
+                index = value >> 1
+                counts[index] += 1
+                # The recorded widths here are 1 and 8 bits
+                pos += 1 if not value & 1 else (1 if index == 0 else 8)
+    return names, counts
+
+
+@cocotb.test()
+def test_record_signals(dut):
+    """Record a clock and a data bus and check every change was written"""
+    trace = os.path.abspath("recorder.trc")
+
+    dut.stream_in_data <= 0
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield Timer(500)
+
+    recorder = simulator.start_recording([dut.clk, dut.stream_in_data], trace)
+    if not recorder:
+        raise TestFailure("Unable to start recording")
+
+    for i in range(1, 51):
+        yield RisingEdge(dut.clk)
+        dut.stream_in_data <= i
+
+    yield ClockCycles(dut.clk, 2)
+    simulator.stop_recording(recorder)
+
+    names, counts = read_trace(trace)
+    if not names[0].endswith("clk") or not names[1].endswith("stream_in_data"):
+        raise TestFailure("Unexpected signal names %s" % names)
+
+    # Initial value plus 50 changes of the data, the clock toggles twice a cycle
+    if counts[1] != 51:
+        raise TestFailure("Expected 51 data events, got %d" % counts[1])
+    if counts[0] < 100:
+        raise TestFailure("Expected at least 100 clock events, got %d" % counts[0])
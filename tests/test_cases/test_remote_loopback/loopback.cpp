@@ -0,0 +1,345 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* Loopback simulator for the out-of-process testbench
+ *
+ * Implements just enough of the GPI for GpiRemote.cpp to serve a testbench
+ * without an HDL simulator: a top level "loopback" holding a clock with a
+ * 10 ns period, an 8 bit counter incremented on each rising edge, a 32 bit
+ * input and a copy of the input registered on each rising edge. The time
+ * precision is 1 ps and the simulation ends after LOOPBACK_END_TIME.
+ */
+
+#include <gpi.h>
+#include <gpi_logging.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+bool gpi_remote_enabled(void);
+void gpi_remote_start(void);
+void gpi_remote_sim_init(gpi_sim_info_t *info);
+void gpi_remote_sim_end(void);
+
+#define LOOPBACK_HALF_PERIOD    5000ULL
+#define LOOPBACK_END_TIME       100000000ULL
+
+struct LoopbackObj {
+    const char *name;
+    std::string fullname;
+    gpi_objtype_t type;
+    int width;
+    std::string value;
+};
+
+struct LoopbackCb {
+    int kind;
+    int (*function)(const void *);
+    void *data;
+    uint64_t time;
+    LoopbackObj *sig;
+    unsigned int edge;
+};
+
+enum { CB_TIMER, CB_VALUE_CHANGE, CB_READWRITE, CB_READONLY, CB_NEXTTIME };
+
+static LoopbackObj root = { "loopback", "loopback", GPI_MODULE, 0, "" };
+static LoopbackObj clk = { "clk", "loopback.clk", GPI_REGISTER, 1, "0" };
+static LoopbackObj count = { "count", "loopback.count", GPI_REGISTER, 8, "00000000" };
+static LoopbackObj data_in = { "data_in", "loopback.data_in", GPI_REGISTER, 32, std::string(32, '0') };
+static LoopbackObj data_q = { "data_q", "loopback.data_q", GPI_REGISTER, 32, std::string(32, '0') };
+// Too wide for its value to fit in the channel
+static LoopbackObj wide = { "wide", "loopback.wide", GPI_REGISTER, 2 << 20, std::string(2 << 20, '1') };
+static LoopbackObj *children[] = { &clk, &count, &data_in, &data_q, &wide, NULL };
+
+static std::vector<LoopbackCb *> callbacks;
+static std::vector<LoopbackObj *> changed;
+static uint64_t sim_time;
+static bool ended;
+static int log_level = GPIInfo;
+
+static void set_value(LoopbackObj *obj, const std::string &value)
+{
+    std::string v = value;
+
+    if ((int)v.size() < obj->width)
+        v.insert(0, obj->width - v.size(), '0');
+    else if ((int)v.size() > obj->width)
+        v = v.substr(v.size() - obj->width);
+
+    if (v != obj->value) {
+        obj->value = v;
+        changed.push_back(obj);
+    }
+}
+
+static std::string to_binstr(unsigned long long value, int width)
+{
+    std::string s(width, '0');
+    for (int i = 0; i < width; i++)
+        if (value & (1ULL << i))
+            s[width - 1 - i] = '1';
+    return s;
+}
+
+/* Callbacks only fire once, GpiRemote registers again when it needs to */
+static bool fire(int kind, LoopbackObj *sig)
+{
+    std::vector<LoopbackCb *> due;
+    size_t i;
+
+    for (i = 0; i < callbacks.size(); ) {
+        LoopbackCb *cb = callbacks[i];
+        bool match = cb->kind == kind;
+        if (match && kind == CB_TIMER)
+            match = cb->time <= sim_time;
+        if (match && kind == CB_VALUE_CHANGE) {
+            match = cb->sig == sig;
+            if (match && sig->width == 1 && cb->edge != 3)
+                match = (cb->edge == 1) == (sig->value == "1");
+        }
+        if (match) {
+            due.push_back(cb);
+            callbacks.erase(callbacks.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    for (i = 0; i < due.size() && !ended; i++)
+        due[i]->function(due[i]->data);
+    for (i = 0; i < due.size(); i++)
+        delete due[i];
+
+    return !due.empty();
+}
+
+static void settle(void)
+{
+    while (!changed.empty() && !ended) {
+        std::vector<LoopbackObj *> now;
+        now.swap(changed);
+        for (size_t i = 0; i < now.size(); i++)
+            fire(CB_VALUE_CHANGE, now[i]);
+    }
+}
+
+static void run(void)
+{
+    while (!ended && sim_time <= LOOPBACK_END_TIME) {
+        fire(CB_NEXTTIME, NULL);
+        fire(CB_TIMER, NULL);
+
+        if (sim_time && sim_time % LOOPBACK_HALF_PERIOD == 0) {
+            set_value(&clk, clk.value == "1" ? "0" : "1");
+            if (clk.value == "1") {
+                set_value(&count, to_binstr(strtoull(count.value.c_str(), NULL, 2) + 1, 8));
+                set_value(&data_q, data_in.value);
+            }
+        }
+        settle();
+
+        while (!ended && fire(CB_READWRITE, NULL))
+            settle();
+        fire(CB_READONLY, NULL);
+
+        // Next clock edge or timer, whichever comes first
+        uint64_t next = (sim_time / LOOPBACK_HALF_PERIOD + 1) * LOOPBACK_HALF_PERIOD;
+        for (size_t i = 0; i < callbacks.size(); i++) {
+            if (callbacks[i]->kind == CB_TIMER && callbacks[i]->time < next)
+                next = callbacks[i]->time;
+            if (callbacks[i]->kind == CB_NEXTTIME && sim_time + 1 < next)
+                next = sim_time + 1;
+        }
+        sim_time = next;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static char product[] = "loopback";
+    static char version[] = "1.0";
+    gpi_sim_info_t info;
+
+    if (!gpi_remote_enabled()) {
+        fprintf(stderr, "COCOTB_REMOTE must be set\n");
+        return 1;
+    }
+
+    memset(&info, 0, sizeof(info));
+    info.argc = argc;
+    info.argv = argv;
+    info.product = product;
+    info.version = version;
+
+    gpi_remote_start();
+    gpi_remote_sim_init(&info);
+    run();
+    gpi_remote_sim_end();
+    return 0;
+}
+
+/* The parts of the GPI used by GpiRemote.cpp */
+
+void gpi_log(const char *name, long level, const char *pathname, const char *funcname, long lineno, const char *msg, ...)
+{
+    va_list ap;
+
+    if (level < log_level)
+        return;
+
+    va_start(ap, msg);
+    printf("%-9s%-35s ", level >= GPIError ? "ERROR" : "INFO", name);
+    vprintf(msg, ap);
+    printf("\n");
+    va_end(ap);
+}
+
+void set_log_level(enum gpi_log_levels new_level)
+{
+    log_level = new_level;
+}
+
+void gpi_sim_end(void)
+{
+    ended = true;
+}
+
+void gpi_get_sim_time(uint32_t *high, uint32_t *low)
+{
+    *high = (uint32_t)(sim_time >> 32);
+    *low = (uint32_t)sim_time;
+}
+
+void gpi_get_sim_precision(int32_t *precision)
+{
+    *precision = -12;
+}
+
+gpi_sim_hdl gpi_get_root_handle(const char *name)
+{
+    if (name && strcmp(name, root.name))
+        return NULL;
+    return &root;
+}
+
+gpi_sim_hdl gpi_get_handle_by_name(gpi_sim_hdl parent, const char *name)
+{
+    if (parent != &root)
+        return NULL;
+    for (int i = 0; children[i]; i++)
+        if (!strcmp(children[i]->name, name))
+            return children[i];
+    return NULL;
+}
+
+gpi_sim_hdl gpi_get_handle_by_index(gpi_sim_hdl parent, int32_t index)
+{
+    return NULL;
+}
+
+gpi_iterator_hdl gpi_iterate(gpi_sim_hdl base, gpi_iterator_sel_t type)
+{
+    if (base != &root || type != GPI_OBJECTS)
+        return NULL;
+    return new int(0);
+}
+
+gpi_sim_hdl gpi_next(gpi_iterator_hdl iterator)
+{
+    int *pos = static_cast<int *>(iterator);
+    LoopbackObj *obj = children[(*pos)++];
+
+    if (!obj)
+        delete pos;
+    return obj;
+}
+
+static LoopbackObj *obj(gpi_sim_hdl hdl)
+{
+    return static_cast<LoopbackObj *>(hdl);
+}
+
+int gpi_get_num_elems(gpi_sim_hdl hdl) { return obj(hdl)->width; }
+int gpi_get_range_left(gpi_sim_hdl hdl) { return obj(hdl)->width - 1; }
+int gpi_get_range_right(gpi_sim_hdl hdl) { return 0; }
+const char *gpi_get_signal_value_binstr(gpi_sim_hdl hdl) { return obj(hdl)->value.c_str(); }
+const char *gpi_get_signal_value_str(gpi_sim_hdl hdl) { return obj(hdl)->value.c_str(); }
+double gpi_get_signal_value_real(gpi_sim_hdl hdl) { return 0.0; }
+long gpi_get_signal_value_long(gpi_sim_hdl hdl) { return strtol(obj(hdl)->value.c_str(), NULL, 2); }
+const char *gpi_get_signal_name_str(gpi_sim_hdl hdl) { return obj(hdl)->name; }
+const char *gpi_get_signal_fullname_str(gpi_sim_hdl hdl) { return obj(hdl)->fullname.c_str(); }
+const char *gpi_get_signal_type_str(gpi_sim_hdl hdl) { return obj(hdl)->type == GPI_MODULE ? "module" : "reg"; }
+gpi_objtype_t gpi_get_object_type(gpi_sim_hdl hdl) { return obj(hdl)->type; }
+const char *gpi_get_definition_name(gpi_sim_hdl hdl) { return obj(hdl)->type == GPI_MODULE ? "loopback" : NULL; }
+const char *gpi_get_definition_file(gpi_sim_hdl hdl) { return NULL; }
+int gpi_is_constant(gpi_sim_hdl hdl) { return 0; }
+int gpi_is_indexable(gpi_sim_hdl hdl) { return obj(hdl)->width > 1; }
+
+void gpi_set_signal_value_real(gpi_sim_hdl hdl, double value) { }
+
+void gpi_set_signal_value_long(gpi_sim_hdl hdl, long value)
+{
+    set_value(obj(hdl), to_binstr((unsigned long long)value, obj(hdl)->width));
+}
+
+void gpi_set_signal_value_str(gpi_sim_hdl hdl, const char *str)
+{
+    set_value(obj(hdl), str);
+}
+
+static gpi_sim_hdl add_callback(int kind, int (*function)(const void *), void *data,
+                                uint64_t time, LoopbackObj *sig, unsigned int edge)
+{
+    LoopbackCb *cb = new LoopbackCb();
+    cb->kind = kind;
+    cb->function = function;
+    cb->data = data;
+    cb->time = time;
+    cb->sig = sig;
+    cb->edge = edge;
+    callbacks.push_back(cb);
+    return cb;
+}
+
+gpi_sim_hdl gpi_register_timed_callback(int (*function)(const void *), void *data, uint64_t time_ps)
+{
+    return add_callback(CB_TIMER, function, data, sim_time + time_ps, NULL, 0);
+}
+
+gpi_sim_hdl gpi_register_value_change_callback(int (*function)(const void *), void *data, gpi_sim_hdl hdl, unsigned int edge)
+{
+    if (obj(hdl)->type == GPI_MODULE)
+        return NULL;
+    return add_callback(CB_VALUE_CHANGE, function, data, 0, obj(hdl), edge);
+}
+
+gpi_sim_hdl gpi_register_readonly_callback(int (*function)(const void *), void *data)
+{
+    return add_callback(CB_READONLY, function, data, 0, NULL, 0);
+}
+
+gpi_sim_hdl gpi_register_nexttime_callback(int (*function)(const void *), void *data)
+{
+    return add_callback(CB_NEXTTIME, function, data, 0, NULL, 0);
+}
+
+gpi_sim_hdl gpi_register_readwrite_callback(int (*function)(const void *), void *data)
+{
+    return add_callback(CB_READWRITE, function, data, 0, NULL, 0);
+}
+
+void gpi_deregister_callback(gpi_sim_hdl hdl)
+{
+    for (size_t i = 0; i < callbacks.size(); i++) {
+        if (callbacks[i] == hdl) {
+            delete callbacks[i];
+            callbacks.erase(callbacks.begin() + i);
+            return;
+        }
+    }
+}
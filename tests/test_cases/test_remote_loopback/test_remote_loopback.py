@@ -0,0 +1,135 @@
+import os
+import time
+
+import simulator
+import cocotb
+from cocotb.remote import Simulator, Sampler
+from cocotb.triggers import Timer, RisingEdge, FallingEdge, ReadOnly, ReadWrite, NextTimeStep
+from cocotb.result import TestFailure
+from cocotb.utils import get_sim_time
+
+
+@cocotb.test()
+def test_out_of_process(dut):
+    """The testbench runs in its own process, talking over the channel"""
+    if not isinstance(simulator, Simulator):
+        raise TestFailure("simulator is %r, not a channel" % simulator)
+    if cocotb.SIM_NAME != "loopback":
+        raise TestFailure("Running on %s" % cocotb.SIM_NAME)
+    if os.getppid() == os.getpid():
+        raise TestFailure("Not in a process of its own")
+
+    names = sorted(h._name for h in dut)
+    if names != ["clk", "count", "data_in", "data_q", "wide"]:
+        raise TestFailure("Discovered %s" % names)
+    yield Timer(1)
+
+
+@cocotb.test()
+def test_triggers(dut):
+    """Timers, edges and the read-only and read-write phases"""
+    start = get_sim_time("ps")
+    yield Timer(1000)
+    if get_sim_time("ps") != start + 1000:
+        raise TestFailure("Timer woke up at %d ps" % get_sim_time("ps"))
+
+    yield RisingEdge(dut.clk)
+    if get_sim_time("ps") % 10000 != 5000 or int(dut.clk) != 1:
+        raise TestFailure("Rising edge at %d ps" % get_sim_time("ps"))
+    count = int(dut.count)
+
+    yield FallingEdge(dut.clk)
+    if int(dut.clk) != 0:
+        raise TestFailure("Falling edge with clk at %d" % int(dut.clk))
+
+    yield RisingEdge(dut.clk)
+    if int(dut.count) != (count + 1) & 0xff:
+        raise TestFailure("Count went from %d to %d" % (count, int(dut.count)))
+
+    yield ReadWrite()
+    yield ReadOnly()
+    yield NextTimeStep()
+
+
+@cocotb.test()
+def test_write_read_back(dut):
+    """Writes are batched with the next hand over and registered on the clock"""
+    for value in [0x12345678, 0xdeadbeef, 0]:
+        yield FallingEdge(dut.clk)
+        dut.data_in <= value
+        yield RisingEdge(dut.clk)
+        yield ReadOnly()
+        if int(dut.data_q) != value:
+            raise TestFailure("Wrote 0x%x, read back 0x%x" % (value, int(dut.data_q)))
+
+    yield Timer(1)
+
+    dut.data_in.setimmediatevalue(0x55)
+    if int(dut.data_in) != 0x55:
+        raise TestFailure("Immediate write read back as 0x%x" % int(dut.data_in))
+
+
+@cocotb.test()
+def test_int_overflow(dut):
+    """Ints too wide for the signal are refused, not truncated"""
+    yield Timer(1)
+    try:
+        dut.data_in._handle.set_value(1 << 40)
+    except OverflowError:
+        pass
+    else:
+        raise TestFailure("Writing 1 << 40 to a 32 bit signal did not raise OverflowError")
+
+
+@cocotb.test()
+def test_oversize_value(dut):
+    """A value too large for the channel reads as empty and the channel
+    keeps working"""
+    yield Timer(1)
+    if simulator.get_signal_val_binstr(dut.wide._handle) != "":
+        raise TestFailure("Oversize value was not dropped")
+
+    for value in [0x0badf00d, 0x600dcafe]:
+        yield FallingEdge(dut.clk)
+        dut.data_in <= value
+        yield RisingEdge(dut.clk)
+        yield ReadOnly()
+        if int(dut.data_q) != value:
+            raise TestFailure("Wrote 0x%x, read back 0x%x" % (value, int(dut.data_q)))
+
+
+@cocotb.test()
+def test_sampler(dut):
+    """A sampler sees every rising edge without stopping the simulator"""
+    samples = []
+
+    def record(sim_time, values):
+        samples.append((sim_time, values))
+
+    sampler = Sampler(dut.clk, [dut.count, dut.data_q], record)
+    dut.data_in <= 0xa5
+    yield Timer(100000)
+    sampler.stop()
+    yield Timer(100000)
+
+    if len(samples) != 10:
+        raise TestFailure("Got %d samples in 10 clock periods" % len(samples))
+    for (t0, v0), (t1, v1) in zip(samples, samples[1:]):
+        if t1 - t0 != 10000:
+            raise TestFailure("Samples at %d and %d ps" % (t0, t1))
+        if (int(v0[0], 2) + 1) & 0xff != int(v1[0], 2):
+            raise TestFailure("Count went from %s to %s" % (v0[0], v1[0]))
+    if int(samples[-1][1][1], 2) != 0xa5:
+        raise TestFailure("Sampled data_q as %s" % samples[-1][1][1])
+
+
+@cocotb.test()
+def test_round_trip_benchmark(dut):
+    """Time taken per clock edge handed to the testbench and back"""
+    edges = 2000
+    edge = RisingEdge(dut.clk)
+    start = time.time()
+    for _ in range(edges):
+        yield edge
+    elapsed = time.time() - start
+    dut._log.info("%.1f us per edge out of process" % (elapsed / edges * 1e6))
@@ -0,0 +1,141 @@
+import time
+
+import cocotb
+from cocotb.result import ReturnValue, TestFailure
+from cocotb.triggers import Event, Lock, NullTrigger, PythonTrigger, Timer, Trigger
+
+
+class _Wakeup(PythonTrigger):
+    """Wakes every coroutine waiting on it at once, without the trigger
+    per wait of Event, so dispatch is all that is timed."""
+
+    def prime(self, callback):
+        self._callback = callback
+        Trigger.prime(self)
+
+    def fire(self):
+        self._callback(self)
+
+
+@cocotb.coroutine
+def _wait_forever(wakeup):
+    while True:
+        yield wakeup
+
+
+def _cores(core):
+    """The event loops to compare, the native one first if there is one."""
+    if core is None:
+        return [("Python", None)]
+    return [("native", core), ("Python", None)]
+
+
+@cocotb.test()
+def test_dispatch_benchmark(dut):
+    """Time waking 1, 100 and 10000 coroutines waiting on one trigger"""
+    yield Timer(1)
+    results = []
+    saved = cocotb.scheduler._core
+    try:
+        for name, core in _cores(saved):
+            cocotb.scheduler._core = core
+            for n in (1, 100, 10000):
+                wakeup = _Wakeup()
+                waiters = [cocotb.fork(_wait_forever(wakeup)) for _ in range(n)]
+                yield Timer(1)
+
+                rounds = max(10, 100000 // n)
+                start = time.time()
+                for _ in range(rounds):
+                    wakeup.fire()
+                    # Resumes once every waiter has run
+                    yield NullTrigger()
+                ns = (time.time() - start) * 1e9 / (rounds * n)
+                results.append((name, n, ns))
+
+                for waiter in waiters:
+                    waiter.kill()
+    finally:
+        cocotb.scheduler._core = saved
+
+    for name, n, ns in results:
+        dut._log.info("%-6s event loop %5d waiting %9.1f ns/wake-up" % (name, n, ns))
+
+
+@cocotb.coroutine
+def _returns(log, value):
+    yield Timer(2)
+    log.append(("returns", value))
+    raise ReturnValue(value)
+
+
+@cocotb.coroutine
+def _raises(log):
+    yield NullTrigger()
+    log.append("raises")
+    raise ValueError("expected")
+
+
+@cocotb.coroutine
+def _takes_lock(log, lock, i):
+    yield lock.acquire()
+    log.append(("lock", i))
+    yield Timer(1)
+    lock.release()
+
+
+@cocotb.coroutine
+def _waits(log, event, i):
+    for j in range(3):
+        yield event.wait()
+        log.append(("event", i, j))
+
+
+@cocotb.coroutine
+def _workload(log):
+    event = Event()
+    waiters = [cocotb.fork(_waits(log, event, i)) for i in range(4)]
+    for _ in range(3):
+        yield Timer(1)
+        event.set()
+        event.clear()
+        yield NullTrigger()
+
+    value = yield _returns(log, 1)
+    log.append(("got", value))
+    value = yield cocotb.fork(_returns(log, 2)).join()
+    log.append(("joined", value))
+
+    lock = Lock()
+    takers = [cocotb.fork(_takes_lock(log, lock, i)) for i in range(3)]
+    yield [t.join() for t in takers]
+    yield Timer(5)
+
+    try:
+        yield _raises(log)
+    except ValueError as e:
+        log.append(("caught", str(e)))
+
+    for waiter in waiters:
+        waiter.kill()
+
+
+@cocotb.test()
+def test_same_order(dut):
+    """Both event loops wake coroutines in the same order"""
+    yield Timer(1)
+    logs = []
+    saved = cocotb.scheduler._core
+    try:
+        for name, core in _cores(saved):
+            cocotb.scheduler._core = core
+            log = []
+            yield _workload(log)
+            logs.append((name, log))
+    finally:
+        cocotb.scheduler._core = saved
+
+    for name, log in logs[1:]:
+        if log != logs[0][1]:
+            raise TestFailure("%s event loop ran %s, %s event loop %s" %
+                              (name, log, logs[0][0], logs[0][1]))
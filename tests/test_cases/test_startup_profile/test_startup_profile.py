@@ -0,0 +1,37 @@
+import json
+import os
+
+import cocotb
+from cocotb.result import TestFailure
+from cocotb.triggers import Timer
+
+
+@cocotb.test()
+def test_timeline_written(dut):
+    """The start-up timeline is written before the first test runs"""
+    with open(os.environ["COCOTB_STARTUP_PROFILE"]) as f:
+        profile = json.load(f)
+
+    phases = dict((p["name"], p) for p in profile["phases"])
+    for name in ("embed_init_python", "embed_sim_init",
+                 "import cocotb.scheduler", "RegressionManager.initialise",
+                 "get_root_handle", "import test_startup_profile"):
+        if name not in phases:
+            raise TestFailure("No %s phase in %s" % (name, sorted(phases)))
+
+    # cocotb is still starting the first test when the timeline is written
+    if not phases["embed_sim_init"]["running"]:
+        raise TestFailure("embed_sim_init ended before the first test")
+
+    init = phases["RegressionManager.initialise"]
+    module = phases["import test_startup_profile"]
+    if module["depth"] <= init["depth"] or module["start_ns"] < init["start_ns"]:
+        raise TestFailure("Importing the test module is not nested in initialise")
+
+    last_start = 0
+    for p in profile["phases"]:
+        if p["start_ns"] < last_start or p["duration_ns"] < 0:
+            raise TestFailure("Phase %s out of order" % p["name"])
+        last_start = p["start_ns"]
+
+    yield Timer(1)
@@ -0,0 +1,137 @@
+import os
+
+import cocotb
+from cocotb.clock import Clock
+from cocotb.result import ReturnValue, TestFailure
+from cocotb.stream import FileStream, write_stream_file
+from cocotb.triggers import ClockCycles, RisingEdge, Timer
+
+
+NUM_RECORDS = 200
+
+
+def data(n):
+    return (n * 37 + 5) & 0xff
+
+
+def wide(n):
+    return (n * 0x0123456789abcdef + n) & 0xffffffffffffffff
+
+
+@cocotb.test()
+def test_stream_drive_and_check(dut):
+    """Stream records onto the inputs and check the combinational output"""
+    stim = os.path.abspath("stream_stim.bin")
+    gold = os.path.abspath("stream_gold.bin")
+
+    write_stream_file(stim, [8, 64], ((data(n), wide(n)) for n in range(NUM_RECORDS)))
+    write_stream_file(gold, [8], ((data(n),) for n in range(NUM_RECORDS)))
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield Timer(500)
+
+    stream = FileStream(dut.clk, stim, [dut.stream_in_data, dut.stream_in_data_wide],
+                        expected=gold, check=[dut.stream_out_data_comb])
+    stream.start()
+    mismatches = yield stream.wait_done(batch=16)
+
+    if mismatches:
+        raise TestFailure("Unexpected mismatches %s" % mismatches[:4])
+
+    status = stream.status
+    if status.driven != NUM_RECORDS or not status.done:
+        raise TestFailure("Stream stopped early: %s" % (status,))
+
+    if int(dut.stream_in_data_wide) != wide(NUM_RECORDS - 1):
+        raise TestFailure("Wide field was not driven, got %s" % dut.stream_in_data_wide.value)
+
+    stream.close()
+
+
+@cocotb.test()
+def test_stream_mismatch_batches(dut):
+    """Mismatches are reported with the record that failed"""
+    stim = os.path.abspath("stream_stim_bad.bin")
+    gold = os.path.abspath("stream_gold_bad.bin")
+    bad = set([3, 50, 51, 199])
+
+    write_stream_file(stim, [8], ((data(n),) for n in range(NUM_RECORDS)))
+    write_stream_file(gold, [8], ((data(n) ^ (0x80 if n in bad else 0),)
+                                  for n in range(NUM_RECORDS)))
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield Timer(500)
+
+    stream = FileStream(dut.clk, stim, [dut.stream_in_data],
+                        expected=gold, check=[dut.stream_out_data_comb])
+    stream.start()
+
+    # A batch of two should come back before the end of the stream
+    yield stream.wait(batch=2)
+    first = stream.mismatches()
+    if [m.record for m in first] != [3, 50]:
+        raise TestFailure("Unexpected first batch %s" % (first,))
+    if stream.status.done:
+        raise TestFailure("Stream should still be running")
+
+    rest = yield stream.wait_done()
+    if [m.record for m in rest] != [51, 199]:
+        raise TestFailure("Unexpected remaining mismatches %s" % (rest,))
+
+    if stream.status.mismatches != len(bad):
+        raise TestFailure("Mismatch count was %d" % stream.status.mismatches)
+
+    stream.close()
+
+
+@cocotb.test()
+def test_stream_python_edges(dut):
+    """A stream does not take over the edge triggers Python waits on"""
+    stim = os.path.abspath("stream_stim_edges.bin")
+    write_stream_file(stim, [8], ((data(n),) for n in range(20)))
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield Timer(500)
+
+    stream = FileStream(dut.clk, stim, [dut.stream_in_data])
+    stream.start()
+    yield ClockCycles(dut.clk, 10)
+    yield RisingEdge(dut.clk)
+
+    driven = stream.status.driven
+    if driven < 10:
+        raise TestFailure("Stream only drove %d records" % driven)
+
+    stream.close()
+
+
+@cocotb.coroutine
+def collect_after_edge(dut, stream):
+    # Resumed by the edge, so the stream trigger is primed while reacting
+    yield RisingEdge(dut.clk)
+    mismatches = yield stream.wait_done(batch=4)
+    raise ReturnValue(mismatches)
+
+
+@cocotb.test()
+def test_stream_wait_from_coroutine(dut):
+    """A coroutine resumed by a trigger can wait on a stream"""
+    stim = os.path.abspath("stream_stim_coro.bin")
+    gold = os.path.abspath("stream_gold_coro.bin")
+
+    write_stream_file(stim, [8], ((data(n),) for n in range(20)))
+    write_stream_file(gold, [8], ((data(n) ^ (0x80 if n == 7 else 0),)
+                                  for n in range(20)))
+
+    cocotb.fork(Clock(dut.clk, 1000).start())
+    yield Timer(500)
+
+    stream = FileStream(dut.clk, stim, [dut.stream_in_data],
+                        expected=gold, check=[dut.stream_out_data_comb])
+    stream.start()
+    mismatches = yield collect_after_edge(dut, stream)
+
+    if [m.record for m in mismatches] != [7]:
+        raise TestFailure("Unexpected mismatches %s" % (mismatches,))
+
+    stream.close()
@@ -0,0 +1,187 @@
+// Copyright cocotb contributors
+// Licensed under the Revised BSD License, see LICENSE for details.
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* Checks and times the std_logic conversions in VhpiLogic.cpp on their own,
+ * without a simulator or Python in the way.
+ *
+ * Every conversion is compared against a plain loop over the same values,
+ * for widths either side of the 16 element SSE2 runs and for vectors of
+ * only '0'/'1', of all logic values and of both mixed. Then the conversions
+ * are timed for vectors of 8 to 4096 bits of '0'/'1' and reported in bits
+ * converted per ns.
+ *
+ * Usage: vhpi_logic_bench [iterations]
+ */
+
+#include "VhpiImpl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+static const char chars[] = "UX01ZWLH-";
+
+static int failures;
+
+static void check(bool ok, const char *what, int width, int pattern)
+{
+    if (!ok) {
+        printf("FAIL: %s, %d bits, pattern %d\n", what, width, pattern);
+        failures++;
+    }
+}
+
+/* '0'/'1' only, every logic value, or mostly '0'/'1' with one of each
+ * other value somewhere */
+static void make_binstr(std::string &s, int width, int pattern)
+{
+    s.resize(width);
+    for (int i = 0; i < width; i++) {
+        switch (pattern) {
+            case 0:  s[i] = (char)('0' + ((i * 7 + i / 3) & 1)); break;
+            case 1:  s[i] = chars[i % 9]; break;
+            default: s[i] = (i % 37 == 5) ? chars[(i / 37) % 9] : (char)('0' + (i & 1)); break;
+        }
+    }
+}
+
+static void check_width(int width, int pattern)
+{
+    std::string binstr;
+    make_binstr(binstr, width, pattern);
+
+    std::vector<vhpiEnumT> values(width + 1, 0xdead);
+    vhpi_logic_from_binstr(&values[0], binstr.c_str(), width);
+
+    bool ok = values[width] == 0xdead;
+    for (int i = 0; i < width; i++)
+        ok = ok && values[i] == vhpi_logic_from_char(binstr[i]) &&
+             chars[values[i]] == binstr[i];
+    check(ok, "binstr to logic", width, pattern);
+
+    std::vector<char> back(width + 1, '#');
+    vhpi_logic_to_binstr(&back[0], &values[0], width);
+    check(back[width] == '#' && !memcmp(&back[0], binstr.c_str(), width),
+          "logic to binstr", width, pattern);
+
+    /* Out of range values read back as X */
+    if (width) {
+        values[width / 2] = 200;
+        vhpi_logic_to_binstr(&back[0], &values[0], width);
+        check(back[width / 2] == 'X', "out of range logic to binstr", width, pattern);
+        values[width / 2] = vhpi_logic_from_char(binstr[width / 2]);
+    }
+
+    int num_words = (width + 31) / 32;
+    std::vector<uint32_t> aval(num_words + 1, 0xdeadbeef);
+    std::vector<uint32_t> bval(num_words + 1, 0xdeadbeef);
+    vhpi_logic_to_words(&aval[0], &bval[0], num_words, &values[0], width);
+
+    ok = aval[num_words] == 0xdeadbeef && bval[num_words] == 0xdeadbeef;
+    for (int bit = 0; bit < width; bit++) {
+        char c = binstr[width - bit - 1];
+        int a = (aval[bit / 32] >> (bit % 32)) & 1;
+        int b = (bval[bit / 32] >> (bit % 32)) & 1;
+        switch (c) {
+            case '0': case 'L': ok = ok && a == 0 && b == 0; break;
+            case '1': case 'H': ok = ok && a == 1 && b == 0; break;
+            case 'Z':           ok = ok && a == 0 && b == 1; break;
+            default:            ok = ok && a == 1 && b == 1; break;
+        }
+    }
+    check(ok, "logic to words", width, pattern);
+
+    std::vector<vhpiEnumT> from_words(width + 1, 0xdead);
+    vhpi_logic_from_words(&from_words[0], width, &aval[0], &bval[0], num_words);
+    ok = from_words[width] == 0xdead;
+    for (int i = 0; i < width; i++) {
+        char c = binstr[i];
+        char expect = c == 'L' ? '0' : c == 'H' ? '1' : c == 'Z' ? 'Z' :
+                      (c == '0' || c == '1') ? c : 'X';
+        ok = ok && vhpi_logic_to_char(from_words[i]) == expect;
+    }
+    check(ok, "words to logic", width, pattern);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Keeps the compiler from dropping the conversions being timed */
+static volatile unsigned sink;
+
+static void time_width(int width, long iterations)
+{
+    std::string binstr;
+    make_binstr(binstr, width, 0);
+
+    std::vector<vhpiEnumT> values(width);
+    std::vector<char> back(width);
+    int num_words = (width + 31) / 32;
+    std::vector<uint32_t> aval(num_words), bval(num_words);
+    double start, to_logic, to_binstr, to_words;
+    long i;
+
+    start = now_ns();
+    for (i = 0; i < iterations; i++) {
+        vhpi_logic_from_binstr(&values[0], binstr.c_str(), width);
+        sink += values[i % width];
+    }
+    to_logic = now_ns() - start;
+
+    start = now_ns();
+    for (i = 0; i < iterations; i++) {
+        vhpi_logic_to_binstr(&back[0], &values[0], width);
+        sink += back[i % width];
+    }
+    to_binstr = now_ns() - start;
+
+    start = now_ns();
+    for (i = 0; i < iterations; i++) {
+        vhpi_logic_to_words(&aval[0], &bval[0], num_words, &values[0], width);
+        sink += aval[0];
+    }
+    to_words = now_ns() - start;
+
+    double bits = (double)width * iterations;
+    printf("%5d bits: binstr->logic %6.2f  logic->binstr %6.2f  logic->words %6.2f bits/ns\n",
+           width, bits / to_logic, bits / to_binstr, bits / to_words);
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? atol(argv[1]) : 2000000;
+    int width;
+
+    for (width = 0; width <= 80; width++)
+        for (int pattern = 0; pattern < 3; pattern++)
+            check_width(width, pattern);
+    for (int pattern = 0; pattern < 3; pattern++)
+        check_width(4096, pattern);
+
+    for (int i = 0; i < 9; i++)
+        check(vhpi_logic_to_char(vhpi_logic_from_char(chars[i])) == chars[i] &&
+              vhpi_logic_from_char(chars[i]) == vhpi_logic_from_char((char)(chars[i] | 0x20)),
+              "single value round trip", 1, i);
+
+    if (failures) {
+        printf("%d conversion checks failed\n", failures);
+        return 1;
+    }
+    printf("All conversion checks passed\n");
+
+#if defined(__SSE2__)
+    printf("Timing with the SSE2 path, %ld iterations\n", iterations);
+#else
+    printf("Timing without the SSE2 path, %ld iterations\n", iterations);
+#endif
+    for (width = 8; width <= 4096; width *= 2)
+        time_width(width, iterations * 8 / width + 1);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+import time
+
+import cocotb
+import simulator
+from cocotb.result import TestFailure
+from cocotb.triggers import Timer
+
+
+WIDTHS = [8, 32, 64, 256, 1024, 4096]
+ITERATIONS = 1000
+
+
+def _values():
+    """Characters every language can hold, and the extra ones VHDL adds"""
+    if cocotb.LANGUAGE in ["vhdl"]:
+        return "01XZUWLH-"
+    return "01XZ"
+
+
+@cocotb.test()
+def test_round_trip(dut):
+    """Every logic value written as a string reads back unchanged"""
+    values = _values()
+
+    for width in WIDTHS:
+        handle = getattr(dut, "vec_%d" % width)._handle
+        binstr = "".join(values[i % len(values)] for i in range(width))
+
+        simulator.set_signal_val_str(handle, binstr)
+        yield Timer(1)
+
+        got = simulator.get_signal_val_binstr(handle)
+        if got.upper() != binstr:
+            raise TestFailure("vec_%d read back %s, expected %s" % (width, got, binstr))
+
+
+@cocotb.test()
+def test_int_round_trip(dut):
+    """Integers of every width are written and read without a binary string"""
+    for width in WIDTHS:
+        sig = getattr(dut, "vec_%d" % width)
+        value = int(("10" * width)[:width], 2)
+
+        sig <= value
+        yield Timer(1)
+
+        if simulator.get_signal_val_int(sig._handle) != value or int(sig) != value:
+            raise TestFailure("vec_%d read back %d, expected %d" % (width, int(sig), value))
+        if sig.value.integer != value:
+            raise TestFailure("vec_%d value is %d, expected %d" % (width, sig.value.integer, value))
+
+    sig = dut.vec_64
+    simulator.set_signal_val_str(sig._handle, "x" * 64)
+    yield Timer(1)
+    # Resolved as BinaryValue would, an error unless COCOTB_RESOLVE_X is set
+    try:
+        value = simulator.get_signal_val_int(sig._handle)
+    except ValueError:
+        pass
+    else:
+        raise TestFailure("Unresolvable value read as %r" % value)
+
+
+@cocotb.test()
+def test_conversion_benchmark(dut):
+    """Time writing and reading vectors of increasing width as strings
+
+    This is the whole path from Python, including the simulator. The
+    conversions themselves are timed by tests/test_cases/test_vhpi_logic.
+    """
+    for width in WIDTHS:
+        handle = getattr(dut, "vec_%d" % width)._handle
+        binstr = ("01" * width)[:width]
+
+        start = time.time()
+        for _ in range(ITERATIONS):
+            simulator.set_signal_val_str(handle, binstr)
+        write = time.time() - start
+
+        start = time.time()
+        for _ in range(ITERATIONS):
+            simulator.get_signal_val_binstr(handle)
+        read = time.time() - start
+
+        bits = float(width * ITERATIONS)
+        dut._log.info("%4d bits: write %.3f bits/ns, read %.3f bits/ns" %
+                      (width, bits / (write * 1e9), bits / (read * 1e9)))
+
+    yield Timer(1)